@@ -0,0 +1,204 @@
+/*
+  ==============================================================================
+    AsyncLogger.cpp
+    Created: 18 Oct 2026 9:14:48pm
+  ==============================================================================
+*/
+
+#include "AsyncLogger.h"
+#include "ThreadPolicy.h"
+
+std::atomic<AsyncLogger*> AsyncLogger::instance{ nullptr };
+std::atomic<int> AsyncLogger::activeWriters{ 0 };
+
+// Function: allow
+// Purpose: Lets one call through per interval. Only one of several threads racing for the same
+//          interval wins.
+bool AsyncLogger::RateLimiter::allow() noexcept
+{
+    const auto now = juce::Time::getMillisecondCounter();
+    auto last = lastTime.load();
+
+    if (hasLogged.load() && now - last < interval)
+    {
+        ++suppressed;
+        return false;
+    }
+
+    if (!lastTime.compare_exchange_strong(last, now))
+    {
+        ++suppressed;
+        return false;
+    }
+
+    hasLogged = true;
+    return true;
+}
+
+//==============================================================================
+// Constructor: Prepares the ring and starts the writer
+AsyncLogger::AsyncLogger()
+    : juce::Thread("Logger"),
+      slots(new Slot[capacity])
+{
+   #if JUCE_DEBUG
+    minimumLevel = debug;
+   #else
+    minimumLevel = info;
+   #endif
+
+    for (size_t i = 0; i < capacity; ++i)
+        slots[i].sequence.store(i, std::memory_order_relaxed);
+
+    AsyncLogger* expected = nullptr;
+    const bool isOnlyLogger = instance.compare_exchange_strong(expected, this);
+    jassert(isOnlyLogger);
+    juce::ignoreUnused(isOnlyLogger);
+
+    startThread(juce::Thread::Priority::low);
+}
+
+// Destructor: Detaches from log and waits for the threads that found it before, so none of
+// them writes into the ring once it is freed; then writes out what is still queued
+AsyncLogger::~AsyncLogger()
+{
+    AsyncLogger* expected = this;
+    instance.compare_exchange_strong(expected, nullptr);
+
+    while (activeWriters.load() > 0)
+        juce::Thread::yield();
+
+    stopThread(1000);
+    drain();
+}
+
+// Function: write
+// Purpose: Fills a record on the stack and pushes it into the ring. The writer count goes up
+//          before the instance is loaded; both are sequentially consistent, so either this
+//          thread sees the destructor's nullptr or the destructor sees this thread's count.
+void AsyncLogger::write(Level level, const char* message, const double* values, int numValues, int suppressed) noexcept
+{
+    ++activeWriters;
+    auto* logger = instance.load();
+
+    if (logger != nullptr && (int) level >= logger->minimumLevel.load(std::memory_order_relaxed))
+    {
+        Record record;
+        record.time = juce::Time::getMillisecondCounterHiRes();
+        record.message = message;
+        record.numValues = numValues;
+        record.suppressed = suppressed;
+        record.level = level;
+
+        for (int i = 0; i < numValues; ++i)
+            record.values[i] = values[i];
+
+        if (!logger->push(record))
+            ++logger->droppedRecords;
+    }
+
+    --activeWriters;
+}
+
+// Function: setMinimumLevel
+// Purpose: Changes which records are kept from now on.
+void AsyncLogger::setMinimumLevel(Level level) noexcept
+{
+    ++activeWriters;
+
+    if (auto* logger = instance.load())
+        logger->minimumLevel = (int) level;
+
+    --activeWriters;
+}
+
+// Function: push
+// Purpose: Bounded multi-producer queue: a producer claims a position with a compare-and-swap
+//          and publishes the slot through its sequence number once the record is written.
+// Outputs: False if the ring is full.
+bool AsyncLogger::push(const Record& record) noexcept
+{
+    auto position = enqueuePosition.load(std::memory_order_relaxed);
+
+    for (;;)
+    {
+        auto& slot = slots[position & (capacity - 1)];
+        const auto sequence = slot.sequence.load(std::memory_order_acquire);
+        const auto difference = (std::intptr_t) sequence - (std::intptr_t) position;
+
+        if (difference == 0)
+        {
+            if (enqueuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+            {
+                slot.record = record;
+                slot.sequence.store(position + 1, std::memory_order_release);
+                return true;
+            }
+        }
+        else if (difference < 0)
+        {
+            return false;
+        }
+        else
+        {
+            position = enqueuePosition.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+// Function: pop
+// Purpose: Takes the oldest record. Only the writer thread calls this.
+// Outputs: False if nothing is ready.
+bool AsyncLogger::pop(Record& record) noexcept
+{
+    const auto position = dequeuePosition.load(std::memory_order_relaxed);
+    auto& slot = slots[position & (capacity - 1)];
+
+    if (slot.sequence.load(std::memory_order_acquire) != position + 1)
+        return false;
+
+    record = slot.record;
+    slot.sequence.store(position + capacity, std::memory_order_release);
+    dequeuePosition.store(position + 1, std::memory_order_relaxed);
+    return true;
+}
+
+// Function: run
+// Purpose: Writes the queue out a few times per second. Producers never wake this thread,
+//          because signalling it could block them.
+void AsyncLogger::run()
+{
+    ThreadPolicy::applyToCurrentThread(ThreadPolicy::backgroundRole, "Logger");
+
+    while (!threadShouldExit())
+    {
+        drain();
+        wait(50);
+    }
+}
+
+// Function: drain
+// Purpose: Formats every queued record as "[time] LEVEL message values" and writes it.
+void AsyncLogger::drain()
+{
+    static const char* const levelNames[] = { "DEBUG", "INFO", "WARNING", "ERROR" };
+
+    Record record;
+
+    while (pop(record))
+    {
+        juce::String line;
+        line << "[" << juce::String(record.time / 1000.0, 3) << "] " << levelNames[record.level] << " " << record.message;
+
+        for (int i = 0; i < record.numValues; ++i)
+            line << (i == 0 ? " " : ", ") << juce::String(record.values[i]);
+
+        if (record.suppressed > 0)
+            line << " (" << record.suppressed << " similar suppressed)";
+
+        juce::Logger::writeToLog(line);
+    }
+
+    if (const int dropped = droppedRecords.exchange(0); dropped > 0)
+        juce::Logger::writeToLog("WARNING " + juce::String(dropped) + " log records dropped, the queue was full");
+}
@@ -0,0 +1,153 @@
+/*
+  ==============================================================================
+    AsyncLogger.h
+    Created: 18 Oct 2026 9:14:48pm
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <atomic>
+#include <memory>
+
+// A logger that can be called from any thread, the audio thread included.
+//
+// A call only copies a fixed-size record (level, time, a string literal and a few numbers)
+// into a lock-free ring buffer. A background thread formats the records and writes them to
+// juce::Logger. If the ring is full the record is dropped and counted instead of waiting.
+// The message must be a string literal, or at least outlive the logger.
+//
+// One instance is owned by MainComponent; until it exists, or after it is gone, logging
+// does nothing. Use the RT_LOG and RT_LOG_RATE_LIMITED macros below.
+class AsyncLogger : private juce::Thread
+{
+public:
+    enum Level
+    {
+        debug = 0,
+        info,
+        warning,
+        error
+    };
+
+    // Limits how often one call site logs. Keep one per call site, usually through
+    // RT_LOG_RATE_LIMITED, which makes it a function-level static.
+    class RateLimiter
+    {
+    public:
+        constexpr explicit RateLimiter(juce::uint32 intervalMilliseconds) noexcept : interval(intervalMilliseconds) {}
+
+        /**Returns true if the call site may log now, and counts the call as suppressed otherwise*/
+        bool allow() noexcept;
+        /**Returns how many calls were suppressed since the last one that was allowed, and resets it*/
+        int takeSuppressedCount() noexcept { return suppressed.exchange(0); }
+
+    private:
+        const juce::uint32 interval;
+        std::atomic<juce::uint32> lastTime{ 0 };
+        std::atomic<bool> hasLogged{ false };
+        std::atomic<int> suppressed{ 0 };
+    };
+
+    // Constructor: Starts the writer thread and makes this the logger used by log
+    AsyncLogger();
+    ~AsyncLogger() override;
+
+    // Function: log
+    // Purpose: Queues a record. Lock-free and allocation-free.
+    // Inputs:
+    // - Level level: The severity; records below the minimum level are ignored.
+    // - const char* message: A string literal.
+    // - Values... values: Up to four numbers of any arithmetic type, printed after the message.
+    template <typename... Values>
+    static void log(Level level, const char* message, Values... values) noexcept
+    {
+        logSuppressed(level, 0, message, values...);
+    }
+
+    // Function: logSuppressed
+    // Purpose: Like log, for a record a rate limiter held back similar ones before.
+    // Inputs:
+    // - int suppressed: How many similar records were held back.
+    template <typename... Values>
+    static void logSuppressed(Level level, int suppressed, const char* message, Values... values) noexcept
+    {
+        static_assert(sizeof...(Values) <= maxValues, "A record holds at most four numbers");
+        const double numbers[] = { 0.0, static_cast<double>(values)... };
+        write(level, message, numbers + 1, (int) sizeof...(Values), suppressed);
+    }
+
+    /**Sets the lowest level that is logged*/
+    static void setMinimumLevel(Level level) noexcept;
+
+private:
+    static constexpr int maxValues = 4;
+    static constexpr size_t capacity = 1024; // a power of two
+
+    struct Record
+    {
+        double time;
+        const char* message;
+        double values[maxValues];
+        int numValues;
+        int suppressed;
+        Level level;
+    };
+
+    // One ring slot; sequence tells producers and the consumer whose turn the slot is
+    struct Slot
+    {
+        std::atomic<size_t> sequence;
+        Record record;
+    };
+
+    /**Fills a record and pushes it, if a logger exists and the level is logged*/
+    static void write(Level level, const char* message, const double* values, int numValues, int suppressed) noexcept;
+
+    bool push(const Record& record) noexcept;
+    bool pop(Record& record) noexcept;
+
+    void run() override;
+    // Formats and writes everything that is queued
+    void drain();
+
+    static std::atomic<AsyncLogger*> instance;
+    // Threads between loading the instance and leaving it; the destructor waits for them
+    static std::atomic<int> activeWriters;
+
+    std::unique_ptr<Slot[]> slots;
+    std::atomic<size_t> enqueuePosition{ 0 };
+    std::atomic<size_t> dequeuePosition{ 0 };
+
+    std::atomic<int> minimumLevel;
+    std::atomic<int> droppedRecords{ 0 };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(AsyncLogger)
+};
+
+// Logs a string literal and one to four numbers, e.g. RT_LOG(warning, "Gain out of range", gain).
+// C++17 doesn't allow an empty __VA_ARGS__, so a message without numbers uses RT_LOG_MESSAGE.
+#define RT_LOG(level, message, ...) \
+    AsyncLogger::log (AsyncLogger::level, message, __VA_ARGS__)
+
+// Logs a string literal alone
+#define RT_LOG_MESSAGE(level, message) \
+    AsyncLogger::log (AsyncLogger::level, message)
+
+// Like RT_LOG, but this call site logs at most once per interval and reports how many
+// calls it held back
+#define RT_LOG_RATE_LIMITED(level, intervalMilliseconds, message, ...) \
+    do { \
+        static AsyncLogger::RateLimiter rateLimiter (intervalMilliseconds); \
+        if (rateLimiter.allow()) \
+            AsyncLogger::logSuppressed (AsyncLogger::level, rateLimiter.takeSuppressedCount(), message, __VA_ARGS__); \
+    } while (false)
+
+// Like RT_LOG_MESSAGE, at most once per interval
+#define RT_LOG_MESSAGE_RATE_LIMITED(level, intervalMilliseconds, message) \
+    do { \
+        static AsyncLogger::RateLimiter rateLimiter (intervalMilliseconds); \
+        if (rateLimiter.allow()) \
+            AsyncLogger::logSuppressed (AsyncLogger::level, rateLimiter.takeSuppressedCount(), message); \
+    } while (false)
@@ -8,10 +8,11 @@
 
 #include "AudioProcessorClass.h"
 #include "JuceHeader.h"
+#include "AsyncLogger.h"
 
 // Constructor: Initializes the AudioProcessorClass with a default sample rate (Self-written)
 AudioProcessorClass::AudioProcessorClass()
-    : lastSampleRate(44100.0), currentSampleRate(44100.0)
+    : lastSampleRate(44100.0), currentSampleRate(44100.0), lastSamplesPerBlock(512)
 {
 }
 
@@ -29,17 +30,36 @@ void AudioProcessorClass::prepareToPlay(double sampleRate, int samplesPerBlock)
 {
     lastSampleRate = sampleRate;
     currentSampleRate = sampleRate;
+    lastSamplesPerBlock = samplesPerBlock;
 
-    juce::dsp::ProcessSpec spec { sampleRate, static_cast<uint32_t> (samplesPerBlock), 2 };
+    // Start every ramp at its target so that preparing never produces a sweep
+    lowPassSmoothed.reset(sampleRate, smoothingTime);
+    lowPassSmoothed.setCurrentAndTargetValue(lowPassFrequency.load());
+    bandPassSmoothed.reset(sampleRate, smoothingTime);
+    bandPassSmoothed.setCurrentAndTargetValue(bandPassFrequency.load());
+    highPassSmoothed.reset(sampleRate, smoothingTime);
+    highPassSmoothed.setCurrentAndTargetValue(highPassFrequency.load());
+    gainSmoothed.reset(sampleRate, smoothingTime);
+    gainSmoothed.setCurrentAndTargetValue(gain.load() * trim.load());
 
-    lowPassFilter.prepare(spec);
-    lowPassFilter.coefficients = juce::dsp::IIR::Coefficients<float>::makeLowPass(sampleRate, 20000.0f);
+    const auto nyquistLimit = static_cast<float> (sampleRate * 0.49);
 
-    bandPassFilter.prepare(spec);
-    bandPassFilter.coefficients = juce::dsp::IIR::Coefficients<float>::makeBandPass(sampleRate, 1000.0f, 0.7f);
+    isolator.setBandGain(IsolatorEQ::lowBand, lowBandGain.load());
+    isolator.setBandGain(IsolatorEQ::midBand, midBandGain.load());
+    isolator.setBandGain(IsolatorEQ::highBand, highBandGain.load());
+    isolator.prepare(sampleRate);
 
-    highPassFilter.prepare(spec);
-    highPassFilter.coefficients = juce::dsp::IIR::Coefficients<float>::makeHighPass(sampleRate, 20.0f);
+    filterCascade.reset();
+    filterCascade.setFadeLength(juce::roundToInt(sampleRate * 0.01));
+    filterCascade.setStageEnabled(StereoBiquadCascade::lowPassStage, lowPassEnabled.load(), false);
+    filterCascade.setStageEnabled(StereoBiquadCascade::bandPassStage, bandPassEnabled.load(), false);
+    filterCascade.setStageEnabled(StereoBiquadCascade::highPassStage, highPassEnabled.load(), false);
+    filterCascade.setCoefficients(StereoBiquadCascade::lowPassStage,
+                                  juce::dsp::IIR::ArrayCoefficients<float>::makeLowPass(sampleRate, juce::jmin(lowPassSmoothed.getCurrentValue(), nyquistLimit)));
+    filterCascade.setCoefficients(StereoBiquadCascade::bandPassStage,
+                                  juce::dsp::IIR::ArrayCoefficients<float>::makeBandPass(sampleRate, juce::jmin(bandPassSmoothed.getCurrentValue(), nyquistLimit), 0.7f));
+    filterCascade.setCoefficients(StereoBiquadCascade::highPassStage,
+                                  juce::dsp::IIR::ArrayCoefficients<float>::makeHighPass(sampleRate, juce::jmin(highPassSmoothed.getCurrentValue(), nyquistLimit)));
 }
 
 // Function: releaseResources (Self-written)
@@ -48,6 +68,14 @@ void AudioProcessorClass::releaseResources()
 {
 }
 
+// Function: reset (Self-written)
+// Purpose: Zeroes the filter and isolator states; the coefficients and ramps are kept.
+void AudioProcessorClass::reset() noexcept
+{
+    filterCascade.reset();
+    isolator.reset();
+}
+
 // Function: setLowPassFrequency (Self-written)
 // Purpose: Sets the frequency of the low pass filter, with validation and error handling.
 // Inputs:
@@ -56,13 +84,12 @@ void AudioProcessorClass::setLowPassFrequency(double frequency)
 {
     if (frequency <= 0.0 || frequency > 20000.0)
     {
-        std::cerr << "Invalid frequency value: " << frequency << ". Frequency should be in the range (0, 20000]" << std::endl;
+        RT_LOG_RATE_LIMITED(warning, 1000, "Invalid low pass frequency, should be in the range (0, 20000]:", frequency);
         frequency = 1000.0;
     }
 
-    auto coefficients = juce::dsp::IIR::Coefficients<float>::makeLowPass(currentSampleRate, frequency);
-    lowPassFilter.coefficients = coefficients;
-    DBG("LowPass Frequency changed to: " + juce::String(frequency));
+    lowPassFrequency.store(static_cast<float> (frequency));
+    RT_LOG_RATE_LIMITED(debug, 250, "LowPass Frequency changed to:", frequency);
 }
 // Function: setBandPassFrequency (Self-written)
 // Purpose: Sets the frequency of the band pass filter, with validation and error handling.
@@ -73,14 +100,13 @@ void AudioProcessorClass::setBandPassFrequency(double frequency)
     if (frequency <= 0.0 || frequency > 20000.0)
     {
         // Log the error
-        std::cerr << "Invalid frequency value: " << frequency << ". Frequency should be in the range (0, 20000]" << std::endl;
+        RT_LOG_RATE_LIMITED(warning, 1000, "Invalid band pass frequency, should be in the range (0, 20000]:", frequency);
 
         // Set a fallback value
         frequency = 1000.0;  // Using 1000 Hz as the fallback value. You can choose any other valid value.
     }
 
-    auto coefficients = juce::dsp::IIR::Coefficients<float>::makeBandPass(currentSampleRate, frequency, 0.7f);
-    bandPassFilter.coefficients = coefficients;
+    bandPassFrequency.store(static_cast<float> (frequency));
 }
 // Function: setHighPassFrequency (Self-written)
 // Purpose: Sets the frequency of the high pass filter, with validation and error handling.
@@ -91,48 +117,202 @@ void AudioProcessorClass::setHighPassFrequency(double frequency)
     if (frequency <= 0.0 || frequency > 20000.0)
     {
         // Log the error
-        std::cerr << "Invalid frequency value: " << frequency << ". Frequency should be in the range (0, 20000]" << std::endl;
+        RT_LOG_RATE_LIMITED(warning, 1000, "Invalid high pass frequency, should be in the range (0, 20000]:", frequency);
 
         // Set a fallback value
         frequency = 500.0;  // Using 500 Hz as the fallback value. You can choose any other valid value.
     }
 
-    auto coefficients = juce::dsp::IIR::Coefficients<float>::makeHighPass(currentSampleRate, frequency);
-    highPassFilter.coefficients = coefficients;
+    highPassFrequency.store(static_cast<float> (frequency));
+}
+
+// Function: setLowPassEnabled (Self-written)
+// Purpose: Requests the low pass filter to be switched on or off.
+// Inputs:
+//   enabled - Whether the low pass filter should be applied.
+void AudioProcessorClass::setLowPassEnabled(bool enabled)
+{
+    lowPassEnabled.store(enabled);
+}
+
+// Function: setBandPassEnabled (Self-written)
+// Purpose: Requests the band pass filter to be switched on or off.
+// Inputs:
+//   enabled - Whether the band pass filter should be applied.
+void AudioProcessorClass::setBandPassEnabled(bool enabled)
+{
+    bandPassEnabled.store(enabled);
+}
+
+// Function: setHighPassEnabled (Self-written)
+// Purpose: Requests the high pass filter to be switched on or off.
+// Inputs:
+//   enabled - Whether the high pass filter should be applied.
+void AudioProcessorClass::setHighPassEnabled(bool enabled)
+{
+    highPassEnabled.store(enabled);
+}
+
+// Function: setLowBandGain (Self-written)
+// Purpose: Sets the target gain of the isolator's low band.
+// Inputs:
+//   bandGain - The linear gain, 0 kills the band.
+void AudioProcessorClass::setLowBandGain(double bandGain)
+{
+    lowBandGain.store(static_cast<float> (juce::jlimit(0.0, 2.0, bandGain)));
+}
+
+// Function: setMidBandGain (Self-written)
+// Purpose: Sets the target gain of the isolator's mid band.
+// Inputs:
+//   bandGain - The linear gain, 0 kills the band.
+void AudioProcessorClass::setMidBandGain(double bandGain)
+{
+    midBandGain.store(static_cast<float> (juce::jlimit(0.0, 2.0, bandGain)));
+}
+
+// Function: setHighBandGain (Self-written)
+// Purpose: Sets the target gain of the isolator's high band.
+// Inputs:
+//   bandGain - The linear gain, 0 kills the band.
+void AudioProcessorClass::setHighBandGain(double bandGain)
+{
+    highBandGain.store(static_cast<float> (juce::jlimit(0.0, 2.0, bandGain)));
+}
+
+// Function: setGain (Self-written)
+// Purpose: Sets the target output gain. The audio thread ramps towards it.
+// Inputs:
+//   newGain - The new linear gain, between 0 and 1.
+void AudioProcessorClass::setGain(double newGain)
+{
+    gain.store(static_cast<float> (juce::jlimit(0.0, 1.0, newGain)));
+}
+
+// Function: setTrim (Self-written)
+// Purpose: Sets a gain applied on top of the output gain, ramped together with it.
+// Inputs:
+//   newTrim - The linear trim, between 1/16 and 4.
+void AudioProcessorClass::setTrim(double newTrim)
+{
+    trim.store(static_cast<float> (juce::jlimit(0.0625, 4.0, newTrim)));
+}
+
+// Function: setSmoothingBlockSize (Self-written)
+// Purpose: Sets the number of samples between two parameter updates while a ramp is running.
+// Inputs:
+//   numSamples - The sub-block size in samples.
+void AudioProcessorClass::setSmoothingBlockSize(int numSamples)
+{
+    smoothingBlockSize.store(juce::jlimit(1, 512, numSamples));
+}
+
+// Function: setSmoothingTime (Self-written)
+// Purpose: Sets the ramp length used for parameter changes, applied on the next prepareToPlay.
+// Inputs:
+//   seconds - The ramp length in seconds.
+void AudioProcessorClass::setSmoothingTime(double seconds)
+{
+    smoothingTime = juce::jmax(0.0, seconds);
+}
+
+// Function: updateFilterCoefficients (Self-written)
+// Purpose: Advances the frequency ramps and recomputes coefficients only for filters that are moving.
+// Inputs:
+//   numSamples - The number of samples to advance the ramps by.
+void AudioProcessorClass::updateFilterCoefficients(int numSamples)
+{
+    const auto nyquistLimit = static_cast<float> (currentSampleRate * 0.49);
 
+    if (lowPassSmoothed.isSmoothing())
+    {
+        auto frequency = juce::jmin(lowPassSmoothed.skip(numSamples), nyquistLimit);
+        filterCascade.setCoefficients(StereoBiquadCascade::lowPassStage,
+                                      juce::dsp::IIR::ArrayCoefficients<float>::makeLowPass(currentSampleRate, frequency));
+    }
+    if (bandPassSmoothed.isSmoothing())
+    {
+        auto frequency = juce::jmin(bandPassSmoothed.skip(numSamples), nyquistLimit);
+        filterCascade.setCoefficients(StereoBiquadCascade::bandPassStage,
+                                      juce::dsp::IIR::ArrayCoefficients<float>::makeBandPass(currentSampleRate, frequency, 0.7f));
+    }
+    if (highPassSmoothed.isSmoothing())
+    {
+        auto frequency = juce::jmin(highPassSmoothed.skip(numSamples), nyquistLimit);
+        filterCascade.setCoefficients(StereoBiquadCascade::highPassStage,
+                                      juce::dsp::IIR::ArrayCoefficients<float>::makeHighPass(currentSampleRate, frequency));
+    }
 }
 
 
-// This method processes an audio block which consists of several audio channels
-void AudioProcessorClass::processAudioBlock(juce::AudioBuffer<float>& buffer)
+// This method processes a region of an audio block which consists of several audio channels.
+// The region is cut into sub-blocks so that parameter ramps can advance between them.
+void AudioProcessorClass::processAudioBlock(juce::AudioBuffer<float>& buffer, int startSample, int numSamples)
 {
     // Check if the buffer has any channels or samples, if not log an error and return
-    if (buffer.getNumChannels() == 0 || buffer.getNumSamples() == 0)
+    if (buffer.getNumChannels() == 0 || numSamples <= 0)
     {
-        DBG("Error: Buffer has no channels or no samples");
+        RT_LOG_MESSAGE_RATE_LIMITED(error, 1000, "Buffer has no channels or no samples");
         return;
     }
 
-    // Loop over all channels in the buffer and process each one individually
-    for (int channel = 0; channel < buffer.getNumChannels(); ++channel)
+    jassert(startSample >= 0 && startSample + numSamples <= buffer.getNumSamples());
+
+    // Pick up the latest targets from the message thread once per block
+    lowPassSmoothed.setTargetValue(lowPassFrequency.load());
+    bandPassSmoothed.setTargetValue(bandPassFrequency.load());
+    highPassSmoothed.setTargetValue(highPassFrequency.load());
+    gainSmoothed.setTargetValue(gain.load() * trim.load());
+
+    // Switched stages fade in or out; the cascade picks the matching chain variant itself
+    filterCascade.setStageEnabled(StereoBiquadCascade::lowPassStage, lowPassEnabled.load());
+    filterCascade.setStageEnabled(StereoBiquadCascade::bandPassStage, bandPassEnabled.load());
+    filterCascade.setStageEnabled(StereoBiquadCascade::highPassStage, highPassEnabled.load());
+
+    // The isolator ramps its band gains per sample
+    isolator.setBandGain(IsolatorEQ::lowBand, lowBandGain.load());
+    isolator.setBandGain(IsolatorEQ::midBand, midBandGain.load());
+    isolator.setBandGain(IsolatorEQ::highBand, highBandGain.load());
+
+    const int subBlockSize = smoothingBlockSize.load();
+
+    for (int offset = 0; offset < numSamples;)
     {
-        // Calling the function to process a single channel with the write pointer to the channel data and the number of samples
-        processSingleChannel(buffer.getWritePointer(channel), buffer.getNumSamples());
+        // While nothing is moving the whole remaining region is processed in one go
+        const bool isRamping = lowPassSmoothed.isSmoothing() || bandPassSmoothed.isSmoothing()
+                            || highPassSmoothed.isSmoothing() || gainSmoothed.isSmoothing();
+        const int blockLength = isRamping ? juce::jmin(subBlockSize, numSamples - offset) : numSamples - offset;
+        const int blockStart = startSample + offset;
+
+        updateFilterCoefficients(blockLength);
+
+        // Both channels go through the filter section together, each with its own state
+        processChannels(buffer.getWritePointer(0, blockStart),
+                        buffer.getNumChannels() > 1 ? buffer.getWritePointer(1, blockStart) : nullptr,
+                        blockLength);
+
+        // Gain is ramped linearly across the sub-block rather than stepped
+        const float startGain = gainSmoothed.getCurrentValue();
+        const float endGain = gainSmoothed.skip(blockLength);
+        if (startGain != endGain)
+        {
+            buffer.applyGainRamp(blockStart, blockLength, startGain, endGain);
+        }
+        else if (endGain != 1.0f)
+        {
+            buffer.applyGain(blockStart, blockLength, endGain);
+        }
+
+        offset += blockLength;
     }
 }
 
-// This method processes a single channel of audio data
-void AudioProcessorClass::processSingleChannel(float* channelData, int numSamples)
+// This method runs the filter section and the isolator over one or two channels of audio data
+void AudioProcessorClass::processChannels(float* left, float* right, int numSamples)
 {
-    // Creating an audio block object for a single channel by passing the channel data pointer and the number of samples
-    juce::dsp::AudioBlock<float> audioBlock(&channelData, 1, numSamples);
+    // Applying the low pass, band pass and high pass filters in one interleaved pass
+    filterCascade.process(left, right, numSamples);
 
-    // Creating a processing context using the created audio block which will replace the original data with the processed data
-    juce::dsp::ProcessContextReplacing<float> context(audioBlock);
-
-    // Applying various filters sequentially to the audio data in the context
-    lowPassFilter.process(context); // Applying low pass filter
-    bandPassFilter.process(context); // Applying band pass filter
-    highPassFilter.process(context); // Applying high pass filter
+    // Splitting into three bands, applying the band gains and summing again in one pass
+    isolator.process(left, right, numSamples);
 }
-
@@ -9,6 +9,8 @@
 #pragma once
 
 #include <JuceHeader.h>
+#include "StereoBiquadCascade.h"
+#include "IsolatorEQ.h"
 
 // This class manages the audio processing in your application, including filtering operations.
 class AudioProcessorClass
@@ -49,28 +51,128 @@ public:
     // - double frequency: The new frequency value for the high pass filter.
     void setHighPassFrequency(double frequency);
 
+    // Function: setLowPassEnabled (Self-written)
+    // Purpose: Adds or removes the low pass filter from the chain. The change is faded on the audio thread.
+    // Inputs:
+    // - bool enabled: Whether the low pass filter should be applied.
+    void setLowPassEnabled(bool enabled);
+
+    // Function: setBandPassEnabled (Self-written)
+    // Purpose: Adds or removes the band pass filter from the chain. The change is faded on the audio thread.
+    // Inputs:
+    // - bool enabled: Whether the band pass filter should be applied.
+    void setBandPassEnabled(bool enabled);
+
+    // Function: setHighPassEnabled (Self-written)
+    // Purpose: Adds or removes the high pass filter from the chain. The change is faded on the audio thread.
+    // Inputs:
+    // - bool enabled: Whether the high pass filter should be applied.
+    void setHighPassEnabled(bool enabled);
+
+    // Function: setLowBandGain (Self-written)
+    // Purpose: Sets the gain of the isolator's low band.
+    // Inputs:
+    // - double bandGain: The linear gain, 0 kills the band.
+    void setLowBandGain(double bandGain);
+
+    // Function: setMidBandGain (Self-written)
+    // Purpose: Sets the gain of the isolator's mid band.
+    // Inputs:
+    // - double bandGain: The linear gain, 0 kills the band.
+    void setMidBandGain(double bandGain);
+
+    // Function: setHighBandGain (Self-written)
+    // Purpose: Sets the gain of the isolator's high band.
+    // Inputs:
+    // - double bandGain: The linear gain, 0 kills the band.
+    void setHighBandGain(double bandGain);
+
+    // Function: setGain (Self-written)
+    // Purpose: Sets the output gain of the processor. The change is ramped on the audio thread.
+    // Inputs:
+    // - double gain: The new linear gain, between 0 and 1.
+    void setGain(double gain);
+
+    // Function: setTrim (Self-written)
+    // Purpose: Sets a level correction applied with the output gain, such as a track's loudness
+    //          normalization, so the gain slider keeps its range.
+    // Inputs:
+    // - double trim: The linear trim, between 1/16 and 4.
+    void setTrim(double trim);
+
+    // Function: setSmoothingBlockSize (Self-written)
+    // Purpose: Sets how many samples are processed between two parameter updates while a
+    //          parameter is ramping. Smaller values give smoother sweeps at a higher CPU cost.
+    // Inputs:
+    // - int numSamples: The sub-block size in samples, clamped to [1, 512].
+    void setSmoothingBlockSize(int numSamples);
+
+    // Function: setSmoothingTime (Self-written)
+    // Purpose: Sets the length of the ramp applied when a parameter changes. Takes effect on the
+    //          next call to prepareToPlay.
+    // Inputs:
+    // - double seconds: The ramp length in seconds.
+    void setSmoothingTime(double seconds);
+
     // Function: processAudioBlock (Self-written)
-    // Purpose: Processes an audio buffer, applying filters to the audio data.
+    // Purpose: Processes a region of an audio buffer, applying filters and gain to the audio data.
+    //          Parameter ramps are advanced once per sub-block (see setSmoothingBlockSize).
+    //          A one-channel buffer isn't cheaper here: the filter section and the isolator
+    //          run both channels in the lanes of the same SIMD registers, the second on silence.
     // Inputs:
     // - juce::AudioBuffer<float>& buffer: A reference to the buffer containing the audio data to be processed.
-    void processAudioBlock(juce::AudioBuffer<float>& buffer);
+    // - int startSample: The first sample of the region to process.
+    // - int numSamples: The number of samples in the region to process.
+    void processAudioBlock(juce::AudioBuffer<float>& buffer, int startSample, int numSamples);
+
+    // Function: reset (Self-written)
+    // Purpose: Clears the state of every filter, for instance after it went non-finite.
+    //          Audio thread only.
+    void reset() noexcept;
 
-    // Function: processSingleChannel (Self-written)
-    // Purpose: Processes a single channel of audio data.
+    // Function: processChannels (Self-written)
+    // Purpose: Runs the filter section and then the isolator EQ over one or two channels of
+    //          audio data. Each channel keeps its own filter state.
     // Inputs:
-    // - float* channelData: A pointer to the data for the channel to be processed.
+    // - float* left: A pointer to the data for the first channel.
+    // - float* right: A pointer to the data for the second channel, or nullptr for mono.
     // - int numSamples: The number of samples in the channel data.
-    void processSingleChannel(float* channelData, int numSamples);
+    void processChannels(float* left, float* right, int numSamples);
 
 private:
+    // Function: updateFilterCoefficients (Self-written)
+    // Purpose: Advances the frequency ramps by numSamples and recomputes the coefficients of
+    //          every filter whose frequency is still moving. Runs on the audio thread and does
+    //          not allocate: the new values are written into the existing coefficient objects.
+    // Inputs:
+    // - int numSamples: The number of samples the ramps are advanced by.
+    void updateFilterCoefficients(int numSamples);
+
     // Filters and state variables for the audio processor (Self-written)
-    juce::dsp::IIR::Filter<float> lowPassFilter;
-    juce::dsp::IIR::Filter<float> bandPassFilter;
-    juce::dsp::IIR::Filter<float> highPassFilter;
+    StereoBiquadCascade filterCascade;
+    IsolatorEQ isolator;
+
+    // Target values written by the message thread and picked up by the audio thread
+    std::atomic<float> lowPassFrequency{ 20000.0f }; // Initial value for low pass filter frequency
+    std::atomic<float> bandPassFrequency{ 1000.0f }; // Initial value for band pass filter frequency
+    std::atomic<float> highPassFrequency{ 20.0f }; // Initial value for high pass filter frequency
+    std::atomic<float> gain{ 1.0f };
+    std::atomic<float> trim{ 1.0f };
+    std::atomic<float> lowBandGain{ 1.0f };
+    std::atomic<float> midBandGain{ 1.0f };
+    std::atomic<float> highBandGain{ 1.0f };
+    std::atomic<bool> lowPassEnabled{ true };
+    std::atomic<bool> bandPassEnabled{ true };
+    std::atomic<bool> highPassEnabled{ true };
+
+    // Ramps that are only touched by the audio thread
+    juce::SmoothedValue<float, juce::ValueSmoothingTypes::Multiplicative> lowPassSmoothed;
+    juce::SmoothedValue<float, juce::ValueSmoothingTypes::Multiplicative> bandPassSmoothed;
+    juce::SmoothedValue<float, juce::ValueSmoothingTypes::Multiplicative> highPassSmoothed;
+    juce::SmoothedValue<float, juce::ValueSmoothingTypes::Linear> gainSmoothed;
 
-    double lowPassFrequency = 2000.0; // Initial value for low pass filter frequency
-    double bandPassFrequency = 1000.0; // Initial value for band pass filter frequency
-    double highPassFrequency = 500.0; // Initial value for high pass filter frequency
+    std::atomic<int> smoothingBlockSize{ 32 };
+    double smoothingTime = 0.05;
 
     double currentSampleRate;
     double lastSampleRate;
@@ -0,0 +1,236 @@
+/*
+  ==============================================================================
+    AutoDJ.cpp
+    Created: 19 Oct 2026 1:27:53am
+  ==============================================================================
+*/
+
+#include "AutoDJ.h"
+#include "AsyncLogger.h"
+
+// Constructor: Works with the two decks and checks a few times per second whether the idle
+// deck needs its next track
+AutoDJ::AutoDJ(DeckGUI& deckGUI1, DeckGUI& deckGUI2, DJAudioPlayer& player1, DJAudioPlayer& player2)
+    : deckGUIs{ &deckGUI1, &deckGUI2 },
+      players{ &player1, &player2 }
+{
+    for (auto& deckHeld : held)
+        deckHeld = false;
+
+    startTimer(100);
+}
+
+AutoDJ::~AutoDJ()
+{
+    stopTimer();
+}
+
+void AutoDJ::prepare(double sampleRate)
+{
+    currentSampleRate = sampleRate;
+}
+
+void AutoDJ::addToQueue(const juce::URL& track)
+{
+    queue.push_back(track);
+
+    if (onQueueChanged)
+        onQueueChanged();
+}
+
+void AutoDJ::clearQueue()
+{
+    queue.clear();
+
+    if (onQueueChanged)
+        onQueueChanged();
+}
+
+int AutoDJ::getQueuePosition(const juce::URL& track) const
+{
+    for (size_t i = 0; i < queue.size(); ++i)
+        if (queue[i] == track)
+            return (int) i;
+
+    return -1;
+}
+
+// Function: setEnabled
+// Purpose: Starting takes the deck that is playing as the live deck. Stopping releases both
+//          decks; the audio thread drops a crossfade in progress on its next chunk.
+void AutoDJ::setEnabled(bool shouldBeEnabled)
+{
+    if (shouldBeEnabled == enabled.load())
+        return;
+
+    if (shouldBeEnabled)
+    {
+        liveDeck = (players[1]->isPlaying() && !players[0]->isPlaying()) ? 1 : 0;
+        handledTransitions = completedTransitions.load();
+        idleDeckLoaded = false;
+
+        for (auto& deckHeld : held)
+            deckHeld = false;
+
+        enabled = true;
+        timerCallback();
+    }
+    else
+    {
+        enabled = false;
+
+        // A cued deck is playing silently; it would start out of nowhere once released
+        const int cued = cuedDeck.exchange(-1);
+
+        if (cued >= 0)
+            players[cued]->stop();
+    }
+}
+
+// Function: planChunk
+// Purpose: Starts a cued crossfade once it falls into this chunk, at remaining - fade samples
+//          from the end of the live track, and turns the fade position into gain ramps. The
+//          curves are equal power; within a chunk they are ramped linearly.
+void AutoDJ::planChunk(int numSamples, DeckPlan (&plans)[numDecks]) noexcept
+{
+    for (auto& plan : plans)
+    {
+        plan = DeckPlan();
+        plan.rampEnd = numSamples;
+    }
+
+    if (!enabled.load())
+    {
+        fadingTo = -1;
+        return;
+    }
+
+    for (int deck = 0; deck < numDecks; ++deck)
+        plans[deck].render = !held[deck].load();
+
+    int to = fadingTo.load();
+    bool startsInThisChunk = false;
+
+    if (to < 0)
+    {
+        const int cued = cuedDeck.load();
+
+        if (cued < 0)
+            return;
+
+        const auto remaining = players[1 - cued]->getRemainingOutputSamples();
+        const auto fade = juce::jmin(cuedFadeSamples.load(), remaining);
+        const auto startOffset = remaining - fade;
+
+        if (startOffset >= numSamples)
+            return;
+
+        to = cued;
+        startsInThisChunk = true;
+        fadeStartOffset = (int) startOffset;
+        fadePosition = 0;
+        fadeLength = juce::jmax((juce::int64) 1, fade);
+
+        held[to] = false;
+        cuedDeck = -1;
+        fadingTo = to;
+    }
+
+    const int from = 1 - to;
+    const int begin = startsInThisChunk ? fadeStartOffset : 0;
+    const int end = (int) juce::jmin((juce::int64) numSamples, begin + fadeLength - fadePosition);
+
+    const double startProportion = (double) fadePosition / (double) fadeLength;
+    const double endProportion = (double) (fadePosition + end - begin) / (double) fadeLength;
+    const double halfPi = juce::MathConstants<double>::halfPi;
+
+    auto& fadingOut = plans[from];
+    fadingOut.render = true;
+    fadingOut.rampStart = begin;
+    fadingOut.rampEnd = end;
+    fadingOut.gainStart = (float) std::cos(startProportion * halfPi);
+    fadingOut.gainEnd = endProportion >= 1.0 ? 0.0f : (float) std::cos(endProportion * halfPi);
+
+    auto& fadingIn = plans[to];
+    fadingIn.render = true;
+    fadingIn.firstSample = begin;
+    fadingIn.rampStart = begin;
+    fadingIn.rampEnd = end;
+    fadingIn.gainStart = (float) std::sin(startProportion * halfPi);
+    fadingIn.gainEnd = endProportion >= 1.0 ? 1.0f : (float) std::sin(endProportion * halfPi);
+
+    fadePosition += end - begin;
+
+    if (fadePosition >= fadeLength)
+    {
+        // The old deck is at the end of its track; it stays silent until the timer stops it
+        held[from] = true;
+        liveDeck = to;
+        fadingTo = -1;
+        ++completedTransitions;
+        RT_LOG(info, "AutoDJ crossfade finished, now live on deck:", to + 1);
+    }
+}
+
+// Function: timerCallback
+// Purpose: The preparation side of the set: stops the deck that faded out, starts the set
+//          when nothing plays, and loads, starts and cues the next track on the idle deck
+//          as soon as the idle deck is free, which is a whole track ahead of its transition.
+void AutoDJ::timerCallback()
+{
+    if (!enabled.load())
+        return;
+
+    const int live = liveDeck.load();
+    const int idle = 1 - live;
+    const int completed = completedTransitions.load();
+
+    if (completed != handledTransitions)
+    {
+        handledTransitions = completed;
+        players[idle]->stop();
+        idleDeckLoaded = false;
+    }
+
+    if (fadingTo.load() >= 0 || cuedDeck.load() >= 0)
+        return;
+
+    if (!players[live]->isPlaying() && !idleDeckLoaded)
+    {
+        held[live] = false;
+
+        if (loadNextTrack(live))
+            players[live]->play();
+
+        return;
+    }
+
+    if (idleDeckLoaded)
+        return;
+
+    // Held first, so the audio thread never pulls the deck before its cue
+    held[idle] = true;
+
+    if (!loadNextTrack(idle))
+        return;
+
+    players[idle]->play();
+    cuedFadeSamples = (juce::int64) juce::roundToInt(crossfadeSeconds * currentSampleRate.load());
+    cuedDeck = idle;
+    idleDeckLoaded = true;
+}
+
+bool AutoDJ::loadNextTrack(int deck)
+{
+    if (queue.empty())
+        return false;
+
+    const auto track = queue.front();
+    queue.pop_front();
+    deckGUIs[deck]->loadFile(track);
+
+    if (onQueueChanged)
+        onQueueChanged();
+
+    return true;
+}
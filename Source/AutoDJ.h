@@ -0,0 +1,105 @@
+/*
+  ==============================================================================
+    AutoDJ.h
+    Created: 19 Oct 2026 1:27:53am
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <atomic>
+#include <deque>
+#include <functional>
+#include "DJAudioPlayer.h"
+#include "DeckGUI.h"
+
+// Plays a queue of tracks on the two decks with crossfades, for unattended sets.
+//
+// The message thread only prepares: well before a transition it loads the next track on the
+// idle deck, starts its transport while the deck is held silent, and cues it. Everything that
+// has to be on time happens on the audio thread: planChunk works out from the live deck's read
+// position the exact sample where the crossfade starts, so it ends on the last sample of the
+// track, and gives both decks equal-power gain ramps. The idle deck's transport has already
+// decoded its first second on the read-ahead thread, so it starts without a gap.
+class AutoDJ : private juce::Timer
+{
+public:
+    // What one deck does in a chunk. The deck renders from firstSample on; its gain is gainStart
+    // up to rampStart, ramps to gainEnd until rampEnd and stays there for the rest of the chunk.
+    struct DeckPlan
+    {
+        bool render = true;
+        int firstSample = 0;
+        int rampStart = 0;
+        int rampEnd = 0;
+        float gainStart = 1.0f;
+        float gainEnd = 1.0f;
+    };
+
+    static constexpr int numDecks = 2;
+
+    AutoDJ(DeckGUI& deckGUI1, DeckGUI& deckGUI2, DJAudioPlayer& player1, DJAudioPlayer& player2);
+    ~AutoDJ() override;
+
+    /**Sets the output sample rate the crossfade length is measured in*/
+    void prepare(double sampleRate);
+
+    /**Adds a track at the end of the queue. Message thread only*/
+    void addToQueue(const juce::URL& track);
+    /**Empties the queue; the tracks already on the decks keep playing*/
+    void clearQueue();
+    /**Returns the 0-based place of a track in the queue, or -1*/
+    int getQueuePosition(const juce::URL& track) const;
+
+    // Function: setEnabled
+    // Purpose: Starts or stops the automatic set. Stopping drops a cued track and leaves the
+    //          live deck playing. Message thread only.
+    void setEnabled(bool shouldBeEnabled);
+    /**Returns whether the automatic set is running*/
+    bool isEnabled() const noexcept { return enabled.load(); }
+
+    // Function: planChunk
+    // Purpose: Plans how both decks render the next chunk, starting and advancing a cued
+    //          crossfade. Audio thread only, lock-free.
+    // Inputs:
+    // - int numSamples: The length of the chunk.
+    // - DeckPlan (&plans)[numDecks]: Filled with the plan of each deck.
+    void planChunk(int numSamples, DeckPlan (&plans)[numDecks]) noexcept;
+
+    /**Called on the message thread when the queue changes*/
+    std::function<void()> onQueueChanged;
+
+private:
+    static constexpr double crossfadeSeconds = 8.0;
+
+    void timerCallback() override;
+    // Loads the next queued track on a deck; returns false if the queue is empty
+    bool loadNextTrack(int deck);
+
+    DeckGUI* deckGUIs[numDecks];
+    DJAudioPlayer* players[numDecks];
+
+    std::deque<juce::URL> queue;
+    std::atomic<double> currentSampleRate{ 44100.0 };
+
+    // Shared between the threads
+    std::atomic<bool> enabled{ false };
+    std::atomic<bool> held[numDecks];
+    std::atomic<int> liveDeck{ 0 };
+    std::atomic<int> cuedDeck{ -1 };
+    std::atomic<juce::int64> cuedFadeSamples{ 0 };
+    std::atomic<int> fadingTo{ -1 };
+    std::atomic<int> completedTransitions{ 0 };
+
+    // Audio thread only
+    juce::int64 fadePosition = 0;
+    juce::int64 fadeLength = 1;
+    int fadeStartOffset = 0;
+
+    // Message thread only
+    int handledTransitions = 0;
+    bool idleDeckLoaded = false;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(AutoDJ)
+};
@@ -0,0 +1,534 @@
+/*
+  ==============================================================================
+    BeatAnalyzer.cpp
+    Created: 19 Oct 2026 9:31:05am
+  ==============================================================================
+*/
+
+#include "BeatAnalyzer.h"
+#include "AsyncLogger.h"
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+    // Frames of about 23 ms overlapping by half at 44.1 and 48 kHz, as long in time above that
+    int getFFTOrder(double sampleRate) { return sampleRate > 60000.0 ? 11 : 10; }
+
+    // Magnitudes are compressed as log(1 + C |X|), so quiet onsets count as well as loud ones
+    constexpr float compression = 1000.0f;
+    // Onsets below this frequency pick the downbeat
+    constexpr double lowBandHz = 150.0;
+    // Tempos are weighted by a log-normal curve around this tempo, one octave wide, so the
+    // double or half of a track's tempo only wins when it is clearly stronger
+    constexpr double preferredBpm = 120.0;
+    constexpr double preferenceOctaves = 1.0;
+    // Autocorrelation peaks below this share of the envelope's variance are taken for noise
+    constexpr double minimumPulseStrength = 0.1;
+    // A grid is only fitted to tracks with at least this many seconds of frames
+    constexpr double minimumSeconds = 8.0;
+
+    // Keeps what rises above the envelope's mean over the surrounding frames
+    void removeLocalMean(std::vector<float>& envelope, int radius)
+    {
+        std::vector<double> sums(envelope.size() + 1, 0.0);
+
+        for (size_t i = 0; i < envelope.size(); ++i)
+            sums[i + 1] = sums[i] + envelope[i];
+
+        const int size = (int) envelope.size();
+
+        for (int i = 0; i < size; ++i)
+        {
+            const int first = juce::jmax(0, i - radius);
+            const int last = juce::jmin(size, i + radius + 1);
+            const double mean = (sums[(size_t) last] - sums[(size_t) first]) / (last - first);
+            envelope[(size_t) i] = juce::jmax(0.0f, (float) (envelope[(size_t) i] - mean));
+        }
+    }
+
+    // The envelope between frames, so beats of a fractional period land where they belong
+    float sampleAt(const std::vector<float>& envelope, double frame)
+    {
+        const int index = (int) frame;
+
+        if (index + 1 >= (int) envelope.size())
+            return index < (int) envelope.size() ? envelope[(size_t) index] : 0.0f;
+
+        const float fraction = (float) (frame - index);
+        return envelope[(size_t) index] + fraction * (envelope[(size_t) index + 1] - envelope[(size_t) index]);
+    }
+
+    // Sums the envelope on every stride-th beat of a grid from the offset
+    double sumOnGrid(const std::vector<float>& envelope, double offset, double period, int stride)
+    {
+        double sum = 0.0;
+
+        for (double frame = offset; frame < (double) envelope.size(); frame += period * stride)
+            sum += sampleAt(envelope, frame);
+
+        return sum;
+    }
+}
+
+//==============================================================================
+// Function: FileMeasurement
+// Purpose: Builds the onset envelopes frame by frame as the blocks come in and fits the grid
+//          once the file is complete. The windowing, transform and flux run on whole frames
+//          through JUCE's vectorised operations and FFT, which picks the fastest engine the
+//          platform has. Without an owner it only keeps the result, for measure.
+class BeatAnalyzer::FileMeasurement : public TrackAnalysisPool::Measurement
+{
+public:
+    FileMeasurement(BeatAnalyzer* ownerToUse, const juce::File& fileToUse, const juce::AudioFormatReader& reader)
+        : owner(ownerToUse),
+          file(fileToUse),
+          numChannels(juce::jmin((int) reader.numChannels, 8)),
+          sampleRate(reader.sampleRate),
+          fftSize(1 << getFFTOrder(sampleRate)),
+          hopSize(fftSize / 2),
+          numBins(fftSize / 2 + 1),
+          lowBins(juce::jlimit(1, numBins, juce::roundToInt(lowBandHz * fftSize / sampleRate) + 1)),
+          fft(getFFTOrder(sampleRate)),
+          window((size_t) fftSize, juce::dsp::WindowingFunction<float>::hann, false),
+          frame((size_t) fftSize * 2),
+          magnitudes((size_t) numBins, 0.0f),
+          previous((size_t) numBins, 0.0f)
+    {
+        envelope.reserve((size_t) (reader.lengthInSamples / hopSize + 1));
+        lowEnvelope.reserve(envelope.capacity());
+    }
+
+    // Mixes the block to mono after what is left of the last one and frames all it can
+    void addBlock(const juce::AudioBuffer<float>& buffer, int numSamples) override
+    {
+        const size_t oldSize = mono.size();
+        mono.resize(oldSize + (size_t) numSamples);
+        juce::FloatVectorOperations::copy(mono.data() + oldSize, buffer.getReadPointer(0), numSamples);
+
+        for (int channel = 1; channel < numChannels; ++channel)
+            juce::FloatVectorOperations::add(mono.data() + oldSize, buffer.getReadPointer(channel), numSamples);
+
+        juce::FloatVectorOperations::multiply(mono.data() + oldSize, 1.0f / (float) numChannels, numSamples);
+
+        size_t start = 0;
+
+        for (; start + (size_t) fftSize <= mono.size(); start += (size_t) hopSize)
+            addFrame(mono.data() + start);
+
+        mono.erase(mono.begin(), mono.begin() + (std::ptrdiff_t) start);
+    }
+
+    void finish(bool complete) override
+    {
+        if (complete)
+            fitGrid();
+
+        if (owner != nullptr)
+            owner->finishFile(file, complete ? &result : nullptr);
+    }
+
+    Result result;
+
+private:
+    // The rise of each bin's compressed magnitude since the previous frame, summed over all
+    // bins and over the low ones. The first frame has nothing to rise from.
+    void addFrame(const float* samples)
+    {
+        std::copy(samples, samples + fftSize, frame.begin());
+        window.multiplyWithWindowingTable(frame.data(), (size_t) fftSize);
+        fft.performFrequencyOnlyForwardTransform(frame.data(), true);
+
+        for (int bin = 0; bin < numBins; ++bin)
+            magnitudes[(size_t) bin] = std::log1p(compression * frame[(size_t) bin]);
+
+        juce::FloatVectorOperations::subtract(frame.data(), magnitudes.data(), previous.data(), numBins);
+        juce::FloatVectorOperations::max(frame.data(), frame.data(), 0.0f, numBins);
+        std::swap(previous, magnitudes);
+
+        float low = 0.0f, total = 0.0f;
+
+        for (int bin = 0; bin < numBins; ++bin)
+        {
+            total += frame[(size_t) bin];
+
+            if (bin < lowBins)
+                low += frame[(size_t) bin];
+        }
+
+        envelope.push_back(envelope.empty() ? 0.0f : total);
+        lowEnvelope.push_back(lowEnvelope.empty() ? 0.0f : low);
+    }
+
+    // Fits the grid to the envelopes; tracks without a steady pulse keep hasBeat false
+    void fitGrid()
+    {
+        const double frameRate = sampleRate / hopSize;
+        result.hasBeat = false;
+
+        if ((double) envelope.size() < minimumSeconds * frameRate)
+            return;
+
+        removeLocalMean(envelope, juce::roundToInt(frameRate * 0.25));
+        removeLocalMean(lowEnvelope, juce::roundToInt(frameRate * 0.25));
+
+        // Tempo: the autocorrelation of the envelope, with each lag also scored on its double and
+        // quadruple so that a bar-long pattern backs up its beat, weighted towards preferredBpm
+        const int minimumLag = juce::jmax(1, (int) std::floor(60.0 * frameRate / maximumBpm));
+        const int maximumLag = (int) std::ceil(60.0 * frameRate / minimumBpm);
+        const int numFrames = (int) envelope.size();
+        std::vector<double> correlation((size_t) (4 * maximumLag + 2), 0.0);
+
+        // Correlated around its mean, so a rectified envelope without a pulse correlates to nothing
+        double mean = 0.0;
+
+        for (auto value : envelope)
+            mean += value;
+
+        mean /= numFrames;
+        std::vector<float> centred(envelope.size());
+
+        for (size_t i = 0; i < envelope.size(); ++i)
+            centred[i] = (float) (envelope[i] - mean);
+
+        for (int lag = 0; lag < (int) correlation.size() && lag < numFrames; ++lag)
+        {
+            if (lag > 0 && lag < minimumLag - 1)
+                continue;
+
+            double sum = 0.0;
+
+            for (int i = 0; i + lag < numFrames; ++i)
+                sum += (double) centred[(size_t) i] * centred[(size_t) (i + lag)];
+
+            correlation[(size_t) lag] = sum / (numFrames - lag);
+        }
+
+        if (correlation[0] <= 0.0)
+            return;
+
+        int bestLag = 0;
+        double bestScore = 0.0;
+
+        for (int lag = minimumLag; lag <= maximumLag; ++lag)
+        {
+            const double bpm = 60.0 * frameRate / lag;
+            const double octaves = std::log2(bpm / preferredBpm) / preferenceOctaves;
+            const double score = (correlation[(size_t) lag] + 0.5 * correlation[(size_t) (2 * lag)] + 0.25 * correlation[(size_t) (4 * lag)])
+                                 * std::exp(-0.5 * octaves * octaves);
+
+            if (score > bestScore)
+            {
+                bestScore = score;
+                bestLag = lag;
+            }
+        }
+
+        if (bestLag == 0 || correlation[(size_t) bestLag] < minimumPulseStrength * correlation[0])
+            return;
+
+        // Beat phase: the period within a frame of the best lag, in hundredths of a frame, and the
+        // offset whose grid lands on the most onset strength over the whole track, in half frames
+        double bestPeriod = bestLag;
+        double bestOffset = 0.0;
+        double bestFit = -1.0;
+
+        for (double period = bestLag - 1.0; period <= bestLag + 1.0; period += 0.01)
+        {
+            for (double offset = 0.0; offset < period; offset += 0.5)
+            {
+                const double fit = sumOnGrid(envelope, offset, period, 1) / std::ceil((numFrames - offset) / period);
+
+                if (fit > bestFit)
+                {
+                    bestFit = fit;
+                    bestPeriod = period;
+                    bestOffset = offset;
+                }
+            }
+        }
+
+        // The offset to a hundredth of a frame as well, around the best half frame
+        const double coarseOffset = bestOffset;
+
+        for (double offset = coarseOffset - 0.5; offset <= coarseOffset + 0.5; offset += 0.01)
+        {
+            if (offset < 0.0)
+                continue;
+
+            const double fit = sumOnGrid(envelope, offset, bestPeriod, 1) / std::ceil((numFrames - offset) / bestPeriod);
+
+            if (fit > bestFit)
+            {
+                bestFit = fit;
+                bestOffset = offset;
+            }
+        }
+
+        // Downbeat: the beat of the bar with the most low-frequency onsets
+        int downbeat = 0;
+        double bestLow = -1.0;
+
+        for (int beat = 0; beat < BeatAnalyzer::beatsPerBar; ++beat)
+        {
+            const double low = sumOnGrid(lowEnvelope, bestOffset + beat * bestPeriod, bestPeriod, BeatAnalyzer::beatsPerBar);
+
+            if (low > bestLow)
+            {
+                bestLow = low;
+                downbeat = beat;
+            }
+        }
+
+        // A frame's flux is the change from the frame before it, so it sits between their centres
+        const double downbeatFrame = bestOffset + downbeat * bestPeriod;
+        result.firstDownbeat = (downbeatFrame * hopSize + (fftSize - hopSize) / 2.0) / sampleRate;
+        result.bpm = 60.0 * frameRate / bestPeriod;
+        result.hasBeat = true;
+    }
+
+    BeatAnalyzer* owner;
+    const juce::File file;
+    const int numChannels;
+    const double sampleRate;
+    const int fftSize, hopSize, numBins, lowBins;
+
+    juce::dsp::FFT fft;
+    juce::dsp::WindowingFunction<float> window;
+    std::vector<float> frame, magnitudes, previous;
+    std::vector<float> envelope, lowEnvelope;
+    // Mono samples decoded but not yet framed
+    std::vector<float> mono;
+};
+
+//==============================================================================
+BeatAnalyzer::BeatAnalyzer(TrackAnalysisPool& poolToUse)
+    : pool(poolToUse)
+{
+    loadCache();
+    pool.addAnalysis(*this);
+}
+
+BeatAnalyzer::~BeatAnalyzer()
+{
+    pool.removeAnalysis(*this);
+    cancelPendingUpdate();
+    saveCache();
+}
+
+void BeatAnalyzer::analyze(const juce::File& file, bool urgently)
+{
+    Result result;
+
+    if (getResult(file, result))
+        return;
+
+    {
+        const juce::ScopedLock scopedLock(lock);
+        const auto path = file.getFullPathName();
+
+        if (queuedPaths.contains(path))
+        {
+            // Still waiting: move it to the front. A file being analyzed is not in pending.
+            for (auto it = pending.begin(); urgently && it != pending.end(); ++it)
+            {
+                if (*it == file)
+                {
+                    if (it - pending.begin() >= numUrgent)
+                        ++numUrgent;
+
+                    pending.erase(it);
+                    pending.push_front(file);
+                    break;
+                }
+            }
+
+            return;
+        }
+
+        queuedPaths.add(path);
+
+        if (urgently)
+        {
+            pending.push_front(file);
+            ++numUrgent;
+        }
+        else
+        {
+            pending.push_back(file);
+        }
+    }
+
+    pool.fileQueued();
+}
+
+bool BeatAnalyzer::getResult(const juce::File& file, Result& result) const
+{
+    return getResult(file, file.getSize(), file.getLastModificationTime().toMilliseconds(), result);
+}
+
+bool BeatAnalyzer::getResult(const juce::File& file, juce::int64 size, juce::int64 modified, Result& result) const
+{
+    const juce::ScopedLock scopedLock(lock);
+    const auto entry = cache.find(file.getFullPathName());
+
+    if (entry == cache.end() || entry->second.size != size || entry->second.modified != modified)
+        return false;
+
+    result = entry->second.result;
+    return true;
+}
+
+// Function: measure
+// Purpose: Feeds the whole file to a measurement of its own.
+bool BeatAnalyzer::measure(juce::AudioFormatReader& reader, Result& result, const std::function<bool()>& shouldExit)
+{
+    if (reader.numChannels <= 0 || reader.sampleRate <= 0.0)
+        return false;
+
+    FileMeasurement measurement(nullptr, {}, reader);
+
+    if (!TrackAnalysisPool::decode(reader, { &measurement }, shouldExit))
+        return false;
+
+    measurement.finish(true);
+    result = measurement.result;
+    return true;
+}
+
+bool BeatAnalyzer::takeNextFile(juce::File& file, bool urgentOnly)
+{
+    const juce::ScopedLock scopedLock(lock);
+
+    if (pending.empty() || (urgentOnly && numUrgent == 0))
+        return false;
+
+    file = pending.front();
+    pending.pop_front();
+    numUrgent = juce::jmax(0, numUrgent - 1);
+    return true;
+}
+
+bool BeatAnalyzer::takeFile(const juce::File& file)
+{
+    const juce::ScopedLock scopedLock(lock);
+    const auto it = std::find(pending.begin(), pending.end(), file);
+
+    if (it == pending.end())
+        return false;
+
+    if (it - pending.begin() < numUrgent)
+        --numUrgent;
+
+    pending.erase(it);
+    return true;
+}
+
+std::unique_ptr<TrackAnalysisPool::Measurement> BeatAnalyzer::startMeasurement(const juce::File& file, const juce::AudioFormatReader& reader)
+{
+    if (reader.numChannels <= 0 || reader.sampleRate <= 0.0)
+    {
+        finishFile(file, nullptr);
+        return nullptr;
+    }
+
+    return std::make_unique<FileMeasurement>(this, file, reader);
+}
+
+void BeatAnalyzer::skipFile(const juce::File& file)
+{
+    finishFile(file, nullptr);
+}
+
+// Stores a measured result, or only forgets the file if it couldn't be read
+void BeatAnalyzer::finishFile(const juce::File& file, const Result* result)
+{
+    {
+        const juce::ScopedLock scopedLock(lock);
+        queuedPaths.removeString(file.getFullPathName());
+
+        if (result == nullptr)
+            return;
+
+        cache[file.getFullPathName()] = { file.getSize(), file.getLastModificationTime().toMilliseconds(), *result };
+        finished.add(file);
+    }
+
+    triggerAsyncUpdate();
+}
+
+// Saves the cache once per batch of finished files and tells the owner about each file
+void BeatAnalyzer::handleAsyncUpdate()
+{
+    juce::Array<juce::File> files;
+
+    {
+        const juce::ScopedLock scopedLock(lock);
+        files.swapWith(finished);
+    }
+
+    saveCache();
+    RT_LOG(debug, "BeatAnalyzer files analyzed:", files.size());
+
+    if (onAnalyzed)
+        for (auto& file : files)
+            onAnalyzed(file);
+}
+
+juce::File BeatAnalyzer::getCacheFile() const
+{
+    return juce::File::getSpecialLocation(juce::File::userApplicationDataDirectory)
+        .getChildFile("OtoDecks").getChildFile("BeatGrids.xml");
+}
+
+// Results of another analyzer version are left out, so their tracks are measured again
+void BeatAnalyzer::loadCache()
+{
+    auto xml = juce::parseXML(getCacheFile());
+
+    if (xml == nullptr)
+        return;
+
+    if (xml->getIntAttribute("version") != analyzerVersion)
+    {
+        RT_LOG(info, "BeatAnalyzer cache is from another analyzer version, ignored:", xml->getIntAttribute("version"));
+        return;
+    }
+
+    const juce::ScopedLock scopedLock(lock);
+
+    for (auto* element : xml->getChildWithTagNameIterator("TRACK"))
+    {
+        CacheEntry entry;
+        entry.size = element->getStringAttribute("size").getLargeIntValue();
+        entry.modified = element->getStringAttribute("modified").getLargeIntValue();
+        entry.result.bpm = element->getDoubleAttribute("bpm");
+        entry.result.firstDownbeat = element->getDoubleAttribute("firstDownbeat");
+        entry.result.hasBeat = element->getBoolAttribute("hasBeat");
+        cache[element->getStringAttribute("path")] = entry;
+    }
+}
+
+void BeatAnalyzer::saveCache()
+{
+    juce::XmlElement root("BEATGRIDS");
+    root.setAttribute("version", analyzerVersion);
+
+    {
+        const juce::ScopedLock scopedLock(lock);
+
+        for (auto& [path, entry] : cache)
+        {
+            auto* element = root.createNewChildElement("TRACK");
+            element->setAttribute("path", path);
+            element->setAttribute("size", juce::String(entry.size));
+            element->setAttribute("modified", juce::String(entry.modified));
+            element->setAttribute("bpm", entry.result.bpm);
+            element->setAttribute("firstDownbeat", entry.result.firstDownbeat);
+            element->setAttribute("hasBeat", entry.result.hasBeat);
+        }
+    }
+
+    getCacheFile().getParentDirectory().createDirectory();
+    root.writeTo(getCacheFile());
+}
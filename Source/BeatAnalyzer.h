@@ -0,0 +1,99 @@
+/*
+  ==============================================================================
+    BeatAnalyzer.h
+    Created: 19 Oct 2026 9:31:05am
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "TrackAnalysisPool.h"
+#include <deque>
+#include <functional>
+#include <map>
+#include <vector>
+
+// Finds the tempo and beat grid of library tracks on the shared analysis pool's threads and keeps
+// the results between sessions. A result stays valid until the file changes or analyzerVersion
+// is raised, so no track is analyzed twice by the same analyzer.
+//
+// Each file is decoded to mono and cut into overlapping frames, whose spectra give an onset
+// strength envelope: the rise of log-compressed magnitudes summed over the bins. Its
+// autocorrelation, weighted towards common dance tempos, gives the beat period; the grid
+// offset is the phase whose beats land on the most onset strength, and the downbeat is the
+// beat of the bar with the most low-frequency onsets, where the kick drum usually plays.
+// The grid has a constant tempo, which suits the material a DJ beat-matches.
+class BeatAnalyzer : private juce::AsyncUpdater,
+                     private TrackAnalysisPool::Analysis
+{
+public:
+    struct Result
+    {
+        double bpm = 0.0;
+        double firstDownbeat = 0.0;        // seconds; the grid repeats every beatsPerBar beats from here
+        bool hasBeat = false;              // false if no steady pulse was found
+    };
+
+    // Raise whenever measure changes its results; every cached result is then measured again
+    static constexpr int analyzerVersion = 2;
+    static constexpr int beatsPerBar = 4;
+    static constexpr double minimumBpm = 70.0;
+    static constexpr double maximumBpm = 180.0;
+
+    /**Analyzes files on the pool; the pool must outlive this*/
+    explicit BeatAnalyzer(TrackAnalysisPool& pool);
+    ~BeatAnalyzer() override;
+
+    // Function: analyze
+    // Purpose: Queues a file unless its result is cached or it is queued already. Message thread.
+    // Inputs:
+    // - const juce::File& file: An audio file.
+    // - bool urgently: Analyzes it before the files queued so far, for a track just loaded.
+    void analyze(const juce::File& file, bool urgently = false);
+
+    /**Gets the cached result of a file, if it was analyzed since it last changed*/
+    bool getResult(const juce::File& file, Result& result) const;
+    /**Like getResult, but checks the cached result against a size and modification time the caller already has*/
+    bool getResult(const juce::File& file, juce::int64 size, juce::int64 modified, Result& result) const;
+
+    // Function: measure
+    // Purpose: Decodes a whole file and finds its beat grid. Runs on the calling thread.
+    // Outputs: False if the file can't be read.
+    static bool measure(juce::AudioFormatReader& reader, Result& result, const std::function<bool()>& shouldExit);
+
+    /**Called on the message thread after a file was analyzed*/
+    std::function<void(const juce::File&)> onAnalyzed;
+
+private:
+    class FileMeasurement;
+
+    struct CacheEntry
+    {
+        juce::int64 size;
+        juce::int64 modified;
+        Result result;
+    };
+
+    void handleAsyncUpdate() override;
+    bool takeNextFile(juce::File& file, bool urgentOnly) override;
+    bool takeFile(const juce::File& file) override;
+    std::unique_ptr<TrackAnalysisPool::Measurement> startMeasurement(const juce::File& file, const juce::AudioFormatReader& reader) override;
+    void skipFile(const juce::File& file) override;
+    void finishFile(const juce::File& file, const Result* result);
+    juce::File getCacheFile() const;
+    void loadCache();
+    void saveCache();
+
+    TrackAnalysisPool& pool;
+
+    // Shared with the pool's threads; the first numUrgent files of pending were queued urgently
+    juce::CriticalSection lock;
+    std::map<juce::String, CacheEntry> cache;
+    std::deque<juce::File> pending;
+    int numUrgent = 0;
+    juce::StringArray queuedPaths;
+    juce::Array<juce::File> finished;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(BeatAnalyzer)
+};
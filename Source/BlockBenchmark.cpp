@@ -0,0 +1,60 @@
+/*
+  ==============================================================================
+    BlockBenchmark.cpp
+    Created: 19 Oct 2026 4:02:17pm
+  ==============================================================================
+*/
+
+#include "BlockBenchmark.h"
+#include <iostream>
+
+BlockBenchmark::BlockBenchmark(int blockSizeToUse, double sampleRateToUse)
+    : blockSize(blockSizeToUse),
+      sampleRate(sampleRateToUse),
+      numBlocks(juce::jmax(1, juce::roundToInt(sampleRateToUse * audioSeconds / blockSizeToUse))),
+      noise(2, blockSizeToUse)
+{
+    juce::Random random(1);
+
+    for (int channel = 0; channel < 2; ++channel)
+        for (int sample = 0; sample < blockSize; ++sample)
+            noise.setSample(channel, sample, random.nextFloat() * 2.0f - 1.0f);
+}
+
+int BlockBenchmark::getBlockSize(const juce::StringArray& arguments, int defaultBlockSize)
+{
+    return arguments.size() > 1 ? juce::jlimit(16, 4096, arguments[1].getIntValue()) : defaultBlockSize;
+}
+
+double BlockBenchmark::time(juce::AudioBuffer<float>& output, const std::function<void()>& processBlock) const
+{
+    const juce::ScopedNoDenormals noDenormals;
+    double fastest = 0.0;
+
+    for (int round = 0; round < numRounds; ++round)
+    {
+        const auto start = juce::Time::getHighResolutionTicks();
+
+        for (int block = 0; block < numBlocks; ++block)
+        {
+            output.makeCopyOf(noise, true);
+            processBlock();
+        }
+
+        const double seconds = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - start);
+        fastest = round == 0 ? seconds : juce::jmin(fastest, seconds);
+    }
+
+    return fastest;
+}
+
+void BlockBenchmark::printHeader() const
+{
+    std::cout << "block " << blockSize << " samples at " << sampleRate << " Hz, " << audioSeconds
+              << " s of stereo audio, fastest of " << numRounds << " rounds\n";
+}
+
+void BlockBenchmark::printResult(const char* name, double seconds) const
+{
+    std::cout << name << " " << seconds * 1000.0 << " ms, " << audioSeconds / seconds << "x real time\n";
+}
@@ -0,0 +1,55 @@
+/*
+  ==============================================================================
+    BlockBenchmark.h
+    Created: 19 Oct 2026 4:02:17pm
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <functional>
+
+// Times DSP code the way the --benchmark-* modes do: block by block over a minute of stereo
+// noise, each block a fresh copy of the same noise, with the fastest of a few rounds counting.
+// Every contender of a benchmark is timed on the same noise, so their outputs can be compared.
+class BlockBenchmark
+{
+public:
+    // Audio processed per timed round, and rounds per contender
+    static constexpr double audioSeconds = 60.0;
+    static constexpr int numRounds = 3;
+
+    // Constructor: Fills one block of stereo noise from a fixed seed
+    BlockBenchmark(int blockSize, double sampleRate);
+
+    // Function: getBlockSize
+    // Purpose: Reads the block size a benchmark mode was started with.
+    // Inputs:
+    // - const juce::StringArray& arguments: The option, then optionally the block size.
+    // - int defaultBlockSize: The block size without one.
+    // Outputs: The block size, between 16 and 4096.
+    static int getBlockSize(const juce::StringArray& arguments, int defaultBlockSize);
+
+    // Function: time
+    // Purpose: Copies the noise into the output and calls processBlock, once per block of the
+    //          audio, for every round. Denormals are off while it runs.
+    // Inputs:
+    // - juce::AudioBuffer<float>& output: A stereo buffer of the block size to process in.
+    // - const std::function<void()>& processBlock: Processes the output in place.
+    // Outputs: The fastest round in seconds.
+    double time(juce::AudioBuffer<float>& output, const std::function<void()>& processBlock) const;
+
+    /**Prints the block size, the sample rate and the rounds to the standard output*/
+    void printHeader() const;
+    /**Prints the time a contender took and how many times real time that is*/
+    void printResult(const char* name, double seconds) const;
+
+private:
+    const int blockSize;
+    const double sampleRate;
+    const int numBlocks;
+    juce::AudioBuffer<float> noise;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(BlockBenchmark)
+};
@@ -0,0 +1,658 @@
+/*
+  ==============================================================================
+    ConvolutionReverb.cpp
+    Created: 18 Oct 2026 6:27:14pm
+  ==============================================================================
+*/
+
+#include "ConvolutionReverb.h"
+#include "AsyncLogger.h"
+#include "ThreadPolicy.h"
+
+namespace
+{
+    // Returns log2 of a power of two, the order juce::dsp::FFT expects
+    int getFFTOrder(int size)
+    {
+        jassert(juce::isPowerOfTwo(size));
+
+        int order = 0;
+        while ((1 << order) < size)
+            ++order;
+
+        return order;
+    }
+
+    // Copies the first numBins complex values of an interleaved spectrum into split arrays
+    void deinterleave(const float* interleaved, float* real, float* imag, int numBins) noexcept
+    {
+        for (int k = 0; k < numBins; ++k)
+        {
+            real[k] = interleaved[2 * k];
+            imag[k] = interleaved[2 * k + 1];
+        }
+    }
+
+    // accumulator += x * h over split complex arrays, written so the compiler vectorises it
+    void multiplyAccumulate(const float* xReal, const float* xImag,
+                            const float* hReal, const float* hImag,
+                            float* accumulatorReal, float* accumulatorImag, int numBins) noexcept
+    {
+        for (int k = 0; k < numBins; ++k)
+        {
+            accumulatorReal[k] += xReal[k] * hReal[k] - xImag[k] * hImag[k];
+            accumulatorImag[k] += xReal[k] * hImag[k] + xImag[k] * hReal[k];
+        }
+    }
+}
+
+//==============================================================================
+// Function: ImpulseResponse
+// Purpose: Cuts the response into partitions, zero pads each to twice its length and stores
+//          the non-negative half of its spectrum.
+// Inputs:
+//   timeDomain - The response, one or two channels.
+//   partitionSizeToUse - The partition length in samples, a power of two.
+ImpulseResponse::ImpulseResponse(const juce::AudioBuffer<float>& timeDomain, int partitionSizeToUse)
+    : partitionSize(partitionSizeToUse),
+      numPartitions(juce::jmax(1, (timeDomain.getNumSamples() + partitionSizeToUse - 1) / partitionSizeToUse)),
+      numChannels(juce::jlimit(1, 2, timeDomain.getNumChannels())),
+      binStride((partitionSizeToUse + 1 + 3) & ~3)
+{
+    const int fftSize = 2 * partitionSize;
+    juce::dsp::FFT transform(getFFTOrder(fftSize));
+    std::vector<float> buffer((size_t) (2 * fftSize));
+
+    real.assign((size_t) (numChannels * numPartitions * binStride), 0.0f);
+    imag.assign(real.size(), 0.0f);
+
+    for (int channel = 0; channel < numChannels; ++channel)
+    {
+        const float* samples = timeDomain.getReadPointer(juce::jmin(channel, timeDomain.getNumChannels() - 1));
+
+        for (int partition = 0; partition < numPartitions; ++partition)
+        {
+            std::fill(buffer.begin(), buffer.end(), 0.0f);
+
+            const int start = partition * partitionSize;
+            const int length = juce::jmin(partitionSize, timeDomain.getNumSamples() - start);
+            std::copy(samples + start, samples + start + length, buffer.begin());
+
+            transform.performRealOnlyForwardTransform(buffer.data(), true);
+
+            const size_t offset = (size_t) ((channel * numPartitions + partition) * binStride);
+            deinterleave(buffer.data(), real.data() + offset, imag.data() + offset, getNumBins());
+        }
+    }
+}
+
+const float* ImpulseResponse::getReal(int channel, int partition) const noexcept
+{
+    return real.data() + (channel * numPartitions + partition) * binStride;
+}
+
+const float* ImpulseResponse::getImag(int channel, int partition) const noexcept
+{
+    return imag.data() + (channel * numPartitions + partition) * binStride;
+}
+
+//==============================================================================
+ImpulseResponseLibrary::ImpulseResponseLibrary()
+{
+    formatManager.registerBasicFormats();
+}
+
+// Function: load
+// Purpose: Reads, resamples and normalises a response, or returns the copy another deck loaded.
+// Inputs:
+//   file - The impulse response file.
+//   sampleRate - The rate the response is resampled to.
+//   partitionSize - The partition length the engine will use.
+// Outputs: The shared response, or nullptr if the file could not be read.
+ImpulseResponse::Ptr ImpulseResponseLibrary::load(const juce::File& file, double sampleRate, int partitionSize)
+{
+    const juce::ScopedLock scopedLock(lock);
+
+    // Forget responses that no deck uses any more
+    for (auto it = cache.begin(); it != cache.end();)
+        it = it->second->getReferenceCount() == 1 ? cache.erase(it) : std::next(it);
+
+    const auto key = file.getFullPathName() + "|" + juce::String(sampleRate) + "|" + juce::String(partitionSize);
+
+    if (auto found = cache.find(key); found != cache.end())
+        return found->second;
+
+    std::unique_ptr<juce::AudioFormatReader> reader(formatManager.createReaderFor(file));
+
+    if (reader == nullptr || reader->lengthInSamples <= 0 || reader->sampleRate <= 0.0)
+        return nullptr;
+
+    const int numChannels = juce::jlimit(1, 2, (int) reader->numChannels);
+    const int fileLength = (int) juce::jmin(reader->lengthInSamples, (juce::int64) (maxLengthSeconds * reader->sampleRate));
+
+    // A few samples of silence at the end for the interpolator to read past the last sample
+    constexpr int interpolatorPadding = 8;
+    juce::AudioBuffer<float> fileBuffer(numChannels, fileLength + interpolatorPadding);
+    fileBuffer.clear();
+    reader->read(&fileBuffer, 0, fileLength, 0, true, numChannels > 1);
+
+    const double ratio = reader->sampleRate / sampleRate;
+    const int length = juce::jmax(1, (int) std::ceil(fileLength / ratio));
+    juce::AudioBuffer<float> resampled(numChannels, length);
+
+    for (int channel = 0; channel < numChannels; ++channel)
+    {
+        if (ratio == 1.0)
+        {
+            resampled.copyFrom(channel, 0, fileBuffer, channel, 0, length);
+        }
+        else
+        {
+            juce::LagrangeInterpolator interpolator;
+            interpolator.process(ratio, fileBuffer.getReadPointer(channel), resampled.getWritePointer(channel), length);
+        }
+    }
+
+    // Normalise to unit energy so a response neither boosts nor drops the level of noise
+    double energy = 0.0;
+
+    for (int channel = 0; channel < numChannels; ++channel)
+    {
+        double channelEnergy = 0.0;
+        const float* samples = resampled.getReadPointer(channel);
+
+        for (int i = 0; i < length; ++i)
+            channelEnergy += (double) samples[i] * samples[i];
+
+        energy = juce::jmax(energy, channelEnergy);
+    }
+
+    if (energy > 0.0)
+        resampled.applyGain((float) (1.0 / std::sqrt(energy)));
+
+    ImpulseResponse::Ptr response = new ImpulseResponse(resampled, partitionSize);
+    cache[key] = response;
+    return response;
+}
+
+//==============================================================================
+// Function: ConvolutionEngine
+// Purpose: Splits the response into head and tail, allocates every buffer and starts the worker.
+// Inputs:
+//   impulseResponse - The shared, preprocessed response.
+ConvolutionEngine::ConvolutionEngine(ImpulseResponse::Ptr impulseResponse)
+    : juce::Thread("Convolution tail"),
+      response(impulseResponse),
+      partitionSize(response->getPartitionSize()),
+      fftSize(2 * partitionSize),
+      numBins(response->getNumBins()),
+      binStride(response->getBinStride()),
+      headPartitions(juce::jmin(headPartitionsMax, response->getNumPartitions())),
+      tailPartitions(response->getNumPartitions() - headPartitions),
+      fft(getFFTOrder(fftSize)),
+      spectrumFifo(headPartitions + 2),
+      tailFft(getFFTOrder(fftSize)),
+      numTailSlots(headPartitions + 2)
+{
+    const auto stride = (size_t) binStride;
+
+    fftBuffer.assign((size_t) (2 * fftSize), 0.0f);
+    inputBuffers.assign((size_t) (numChannels * fftSize), 0.0f);
+    outputBuffers.assign((size_t) (numChannels * partitionSize), 0.0f);
+    headReal.assign((size_t) (headPartitions * numChannels) * stride, 0.0f);
+    headImag.assign(headReal.size(), 0.0f);
+    accumulatorReal.assign(stride, 0.0f);
+    accumulatorImag.assign(stride, 0.0f);
+
+    if (tailPartitions > 0)
+    {
+        fifoSpectra.assign((size_t) (spectrumFifo.getTotalSize() * numChannels * 2) * stride, 0.0f);
+        fifoBlockIndices.assign((size_t) spectrumFifo.getTotalSize(), 0);
+
+        tailFftBuffer.assign((size_t) (2 * fftSize), 0.0f);
+        tailReal.assign((size_t) (tailPartitions * numChannels) * stride, 0.0f);
+        tailImag.assign(tailReal.size(), 0.0f);
+        tailAccumulatorReal.assign(stride, 0.0f);
+        tailAccumulatorImag.assign(stride, 0.0f);
+
+        tailOutput.assign((size_t) (numTailSlots * numChannels * partitionSize), 0.0f);
+        tailStamps.reset(new std::atomic<juce::int64>[(size_t) numTailSlots]);
+
+        for (int i = 0; i < numTailSlots; ++i)
+            tailStamps[(size_t) i] = -1;
+
+        // The tail has a deadline, so the worker runs above normal priority
+        startThread(juce::Thread::Priority::high);
+    }
+}
+
+ConvolutionEngine::~ConvolutionEngine()
+{
+    signalThreadShouldExit();
+    notify();
+    stopThread(2000);
+}
+
+// Function: process
+// Purpose: Feeds the input into the current partition and plays back the previous output block,
+//          convolving a new block whenever a partition is full.
+// Inputs:
+//   left, right - The channel data, processed in place. right may be nullptr.
+//   numSamples - The number of samples per channel.
+void ConvolutionEngine::process(float* left, float* right, int numSamples) noexcept
+{
+    float* channels[numChannels] = { left, right };
+    int done = 0;
+
+    while (done < numSamples)
+    {
+        const int chunk = juce::jmin(numSamples - done, partitionSize - inputFill);
+
+        for (int channel = 0; channel < numChannels; ++channel)
+        {
+            float* input = inputBuffers.data() + channel * fftSize + partitionSize + inputFill;
+            const float* output = outputBuffers.data() + channel * partitionSize + inputFill;
+            float* data = channels[channel];
+
+            if (data == nullptr)
+            {
+                std::fill(input, input + chunk, 0.0f);
+                continue;
+            }
+
+            std::copy(data + done, data + done + chunk, input);
+            std::copy(output, output + chunk, data + done);
+        }
+
+        inputFill += chunk;
+        done += chunk;
+
+        if (inputFill == partitionSize)
+        {
+            processPartition();
+            inputFill = 0;
+        }
+    }
+}
+
+// Function: processPartition
+// Purpose: Transforms the last two partitions of input, convolves the head, hands the spectrum
+//          to the worker and adds the tail block the worker prepared for this output block.
+void ConvolutionEngine::processPartition() noexcept
+{
+    const auto currentBlock = blockIndex++;
+
+    // Reserve a slot for the worker; if the queue is full the worker is far behind anyway
+    int fifoSlot = -1;
+
+    if (tailPartitions > 0)
+    {
+        int start1, size1, start2, size2;
+        spectrumFifo.prepareToWrite(1, start1, size1, start2, size2);
+
+        if (size1 > 0)
+            fifoSlot = start1;
+    }
+
+    // The newest spectrum goes in front of the previous ones
+    headPosition = (headPosition + headPartitions - 1) % headPartitions;
+
+    for (int channel = 0; channel < numChannels; ++channel)
+    {
+        float* input = inputBuffers.data() + channel * fftSize;
+
+        std::copy(input, input + fftSize, fftBuffer.begin());
+        std::fill(fftBuffer.begin() + fftSize, fftBuffer.end(), 0.0f);
+        fft.performRealOnlyForwardTransform(fftBuffer.data(), true);
+
+        float* newestReal = headReal.data() + (headPosition * numChannels + channel) * binStride;
+        float* newestImag = headImag.data() + (headPosition * numChannels + channel) * binStride;
+        deinterleave(fftBuffer.data(), newestReal, newestImag, numBins);
+
+        if (fifoSlot >= 0)
+        {
+            std::copy(newestReal, newestReal + numBins, fifoReal(fifoSlot, channel));
+            std::copy(newestImag, newestImag + numBins, fifoImag(fifoSlot, channel));
+        }
+
+        std::fill(accumulatorReal.begin(), accumulatorReal.end(), 0.0f);
+        std::fill(accumulatorImag.begin(), accumulatorImag.end(), 0.0f);
+
+        const int responseChannel = juce::jmin(channel, response->getNumChannels() - 1);
+
+        for (int partition = 0; partition < headPartitions; ++partition)
+        {
+            const int slot = (headPosition + partition) % headPartitions;
+            multiplyAccumulate(headReal.data() + (slot * numChannels + channel) * binStride,
+                               headImag.data() + (slot * numChannels + channel) * binStride,
+                               response->getReal(responseChannel, partition),
+                               response->getImag(responseChannel, partition),
+                               accumulatorReal.data(), accumulatorImag.data(), numBins);
+        }
+
+        inverseTransform(fft, fftBuffer, accumulatorReal.data(), accumulatorImag.data(), numBins);
+        std::copy(fftBuffer.begin() + partitionSize, fftBuffer.begin() + fftSize,
+                  outputBuffers.begin() + channel * partitionSize);
+
+        // The current partition becomes the previous one
+        std::copy(input + partitionSize, input + fftSize, input);
+    }
+
+    if (fifoSlot >= 0)
+    {
+        fifoBlockIndices[(size_t) fifoSlot] = currentBlock;
+        spectrumFifo.finishedWrite(1);
+        notify();
+    }
+
+    // The first blocks have no tail, their input would come from before the start
+    if (tailPartitions > 0 && currentBlock >= headPartitions)
+    {
+        const int slot = (int) (currentBlock % numTailSlots);
+
+        if (tailStamps[(size_t) slot].load(std::memory_order_acquire) == currentBlock)
+        {
+            for (int channel = 0; channel < numChannels; ++channel)
+            {
+                const float* tail = tailOutput.data() + (slot * numChannels + channel) * partitionSize;
+                juce::FloatVectorOperations::add(outputBuffers.data() + channel * partitionSize, tail, partitionSize);
+            }
+        }
+        else
+        {
+            ++missedTailBlocks;
+        }
+    }
+}
+
+// Function: inverseTransform
+// Purpose: Rebuilds the full symmetric spectrum from the non-negative bins and transforms it
+//          back. The last half of the buffer then holds the valid overlap-save output.
+// Inputs:
+//   transform - The FFT to use; each thread has its own.
+//   buffer - Scratch space of twice the FFT size.
+//   accumulatedReal, accumulatedImag - The spectrum.
+//   numBins - The number of non-negative bins.
+void ConvolutionEngine::inverseTransform(juce::dsp::FFT& transform, std::vector<float>& buffer,
+                                         const float* accumulatedReal, const float* accumulatedImag, int numBins) noexcept
+{
+    const int size = transform.getSize();
+
+    for (int k = 0; k < numBins; ++k)
+    {
+        buffer[(size_t) (2 * k)] = accumulatedReal[k];
+        buffer[(size_t) (2 * k + 1)] = accumulatedImag[k];
+    }
+
+    for (int k = numBins; k < size; ++k)
+    {
+        buffer[(size_t) (2 * k)] = buffer[(size_t) (2 * (size - k))];
+        buffer[(size_t) (2 * k + 1)] = -buffer[(size_t) (2 * (size - k) + 1)];
+    }
+
+    transform.performRealOnlyInverseTransform(buffer.data());
+}
+
+float* ConvolutionEngine::fifoReal(int slot, int channel) noexcept
+{
+    return fifoSpectra.data() + ((slot * numChannels + channel) * 2) * binStride;
+}
+
+float* ConvolutionEngine::fifoImag(int slot, int channel) noexcept
+{
+    return fifoSpectra.data() + ((slot * numChannels + channel) * 2 + 1) * binStride;
+}
+
+// Function: run
+// Purpose: Worker loop; convolves every spectrum the audio thread hands over.
+void ConvolutionEngine::run()
+{
+    ThreadPolicy::applyToCurrentThread(ThreadPolicy::renderWorkerRole, "Convolution tail");
+
+    while (!threadShouldExit())
+    {
+        int start1, size1, start2, size2;
+        spectrumFifo.prepareToRead(1, start1, size1, start2, size2);
+
+        if (size1 == 0)
+        {
+            wait(100);
+            continue;
+        }
+
+        processTailBlock(start1);
+        spectrumFifo.finishedRead(1);
+    }
+}
+
+// Function: processTailBlock
+// Purpose: Adds a spectrum to the tail history and computes the tail of the output block
+//          headPartitions blocks later, then publishes it for the audio thread.
+// Inputs:
+//   fifoSlot - The FIFO slot holding the spectrum.
+void ConvolutionEngine::processTailBlock(int fifoSlot) noexcept
+{
+    const auto targetBlock = fifoBlockIndices[(size_t) fifoSlot] + headPartitions;
+    const int outputSlot = (int) (targetBlock % numTailSlots);
+
+    tailStamps[(size_t) outputSlot].store(-1, std::memory_order_release);
+    tailPosition = (tailPosition + tailPartitions - 1) % tailPartitions;
+
+    for (int channel = 0; channel < numChannels; ++channel)
+    {
+        float* newestReal = tailReal.data() + (tailPosition * numChannels + channel) * binStride;
+        float* newestImag = tailImag.data() + (tailPosition * numChannels + channel) * binStride;
+        std::copy(fifoReal(fifoSlot, channel), fifoReal(fifoSlot, channel) + numBins, newestReal);
+        std::copy(fifoImag(fifoSlot, channel), fifoImag(fifoSlot, channel) + numBins, newestImag);
+
+        std::fill(tailAccumulatorReal.begin(), tailAccumulatorReal.end(), 0.0f);
+        std::fill(tailAccumulatorImag.begin(), tailAccumulatorImag.end(), 0.0f);
+
+        const int responseChannel = juce::jmin(channel, response->getNumChannels() - 1);
+
+        for (int partition = 0; partition < tailPartitions; ++partition)
+        {
+            const int slot = (tailPosition + partition) % tailPartitions;
+            multiplyAccumulate(tailReal.data() + (slot * numChannels + channel) * binStride,
+                               tailImag.data() + (slot * numChannels + channel) * binStride,
+                               response->getReal(responseChannel, headPartitions + partition),
+                               response->getImag(responseChannel, headPartitions + partition),
+                               tailAccumulatorReal.data(), tailAccumulatorImag.data(), numBins);
+        }
+
+        inverseTransform(tailFft, tailFftBuffer, tailAccumulatorReal.data(), tailAccumulatorImag.data(), numBins);
+        std::copy(tailFftBuffer.begin() + partitionSize, tailFftBuffer.begin() + fftSize,
+                  tailOutput.begin() + (outputSlot * numChannels + channel) * partitionSize);
+    }
+
+    tailStamps[(size_t) outputSlot].store(targetBlock, std::memory_order_release);
+}
+
+//==============================================================================
+// Constructor: Wraps an input source, optionally taking ownership of it
+ConvolutionReverbAudioSource::ConvolutionReverbAudioSource(juce::AudioSource* inputSource, bool deleteInputWhenDeleted)
+    : input(inputSource, deleteInputWhenDeleted)
+{
+    jassert(inputSource != nullptr);
+}
+
+ConvolutionReverbAudioSource::~ConvolutionReverbAudioSource()
+{
+}
+
+// Function: reserveScratch
+// Purpose: Reserves room for a stereo copy of the largest block the deck will pass in.
+// Inputs:
+//   arena - The deck's arena, not yet allocated.
+//   maximumBlockSize - The agreed maximum block size.
+void ConvolutionReverbAudioSource::reserveScratch(ScratchArena& arena, int maximumBlockSize)
+{
+    scratch = &arena;
+    dryScratch = arena.reserve(2, juce::jmax(1, maximumBlockSize));
+}
+
+// Function: prepareToPlay
+// Purpose: Picks a partition size close to the block size and rebuilds the engine for the new
+//          settings if a response is loaded.
+void ConvolutionReverbAudioSource::prepareToPlay(int samplesPerBlockExpected, double sampleRate)
+{
+    currentSampleRate = sampleRate;
+    partitionSize = juce::jlimit(128, 2048, juce::nextPowerOfTwo(samplesPerBlockExpected));
+
+    wetGain.reset(sampleRate, 0.05);
+    dryGain.reset(sampleRate, 0.05);
+    wetGain.setCurrentAndTargetValue(wetTarget.load());
+    dryGain.setCurrentAndTargetValue(dryTarget.load());
+
+    if (hasImpulseResponse())
+        rebuildEngine();
+}
+
+void ConvolutionReverbAudioSource::releaseResources()
+{
+    scratch = nullptr;
+    dryScratch = -1;
+}
+
+void ConvolutionReverbAudioSource::getNextAudioBlock(const juce::AudioSourceChannelInfo& bufferToFill)
+{
+    input->getNextAudioBlock(bufferToFill);
+    processBlock(bufferToFill);
+}
+
+// Function: processBlock
+// Purpose: Picks up a new engine if one is waiting and mixes the convolved signal with the dry one.
+void ConvolutionReverbAudioSource::processBlock(const juce::AudioSourceChannelInfo& bufferToFill)
+{
+    if (engineChangePending.load())
+    {
+        // If the message thread holds the lock the new engine is picked up next block
+        const juce::SpinLock::ScopedTryLockType lock(engineLock);
+
+        if (lock.isLocked())
+        {
+            std::swap(activeEngine, standbyEngine);
+            engineChangePending = false;
+            engineFaulted = false;
+        }
+    }
+
+    auto& buffer = *bufferToFill.buffer;
+
+    // Without its scratch space the stage can't keep the dry signal, so it stays out of the chain,
+    // as does a faulted engine until it is replaced
+    if (activeEngine == nullptr || engineFaulted.load() || scratch == nullptr || buffer.getNumChannels() == 0)
+        return;
+
+    wetGain.setTargetValue(wetTarget.load());
+    dryGain.setTargetValue(dryTarget.load());
+
+    const bool isStereo = buffer.getNumChannels() > 1;
+
+    float* dryLeft = scratch->getChannelPointer(dryScratch, 0);
+    float* dryRight = scratch->getChannelPointer(dryScratch, 1);
+
+    // Longer blocks than expected are processed in pieces that fit the dry copy
+    for (int offset = 0; offset < bufferToFill.numSamples;)
+    {
+        const int numSamples = juce::jmin(bufferToFill.numSamples - offset, scratch->getNumSamples(dryScratch));
+        float* left = buffer.getWritePointer(0, bufferToFill.startSample + offset);
+        float* right = isStereo ? buffer.getWritePointer(1, bufferToFill.startSample + offset) : nullptr;
+
+        juce::FloatVectorOperations::copy(dryLeft, left, numSamples);
+        if (isStereo)
+            juce::FloatVectorOperations::copy(dryRight, right, numSamples);
+
+        activeEngine->process(left, right, numSamples);
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            const float wet = wetGain.getNextValue();
+            const float dry = dryGain.getNextValue();
+
+            left[i] = left[i] * wet + dryLeft[i] * dry;
+            if (isStereo)
+                right[i] = right[i] * wet + dryRight[i] * dry;
+        }
+
+        offset += numSamples;
+    }
+}
+
+// Function: loadImpulseResponse
+// Purpose: Switches to a new impulse response. Keeps the previous one if the file can't be read.
+// Inputs:
+//   file - The impulse response file.
+// Outputs: Whether the response was loaded.
+bool ConvolutionReverbAudioSource::loadImpulseResponse(const juce::File& file)
+{
+    const auto previousFile = impulseResponseFile;
+    impulseResponseFile = file;
+
+    if (rebuildEngine())
+        return true;
+
+    impulseResponseFile = previousFile;
+    return false;
+}
+
+// Function: clearImpulseResponse
+// Purpose: Removes the engine so the input passes through untouched.
+void ConvolutionReverbAudioSource::clearImpulseResponse()
+{
+    impulseResponseFile = juce::File();
+    setEngine(nullptr);
+}
+
+// Function: setLevels
+// Purpose: Sets the wet and dry targets, ramped on the audio thread.
+// Inputs:
+//   wetLevel, dryLevel - The levels between 0 and 1.
+void ConvolutionReverbAudioSource::setLevels(float wetLevel, float dryLevel)
+{
+    wetTarget = wetLevel * levelScaleFactor;
+    dryTarget = dryLevel * levelScaleFactor;
+}
+
+// Function: recoverFromFault
+// Purpose: Hands a fresh engine to the audio thread once the faulted one is out of the chain,
+//          or none if the response can't be loaded any more.
+void ConvolutionReverbAudioSource::recoverFromFault()
+{
+    if (!engineFaulted.load() || engineChangePending.load())
+        return;
+
+    RT_LOG(warning, "ConvolutionReverbAudioSource rebuilds its engine after non-finite output, partition size:", partitionSize);
+
+    if (!hasImpulseResponse() || !rebuildEngine())
+        setEngine(nullptr);
+}
+
+// Function: rebuildEngine
+// Purpose: Gets the preprocessed response from the shared library and builds an engine for it.
+// Outputs: Whether the response could be loaded.
+bool ConvolutionReverbAudioSource::rebuildEngine()
+{
+    auto response = library->load(impulseResponseFile, currentSampleRate, partitionSize);
+
+    if (response == nullptr)
+        return false;
+
+    setEngine(std::make_unique<ConvolutionEngine>(response));
+    return true;
+}
+
+// Function: setEngine
+// Purpose: Hands an engine, or nullptr for none, to the audio thread. The engine this replaces
+//          earlier is destroyed here rather than on the audio thread.
+void ConvolutionReverbAudioSource::setEngine(std::unique_ptr<ConvolutionEngine> newEngine)
+{
+    std::unique_ptr<ConvolutionEngine> retiredEngine;
+
+    {
+        const juce::SpinLock::ScopedLockType lock(engineLock);
+        retiredEngine = std::move(standbyEngine);
+        standbyEngine = std::move(newEngine);
+        engineChangePending = true;
+    }
+}
@@ -0,0 +1,245 @@
+/*
+  ==============================================================================
+    ConvolutionReverb.h
+    Created: 18 Oct 2026 6:27:14pm
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "ScratchArena.h"
+#include <atomic>
+#include <map>
+#include <memory>
+#include <vector>
+
+// An impulse response cut into equal partitions and transformed to the frequency domain once.
+// The spectra are read-only after construction, so one instance can be shared by every deck.
+// Real and imaginary parts are stored in separate arrays so the multiply-accumulate loops
+// over the bins vectorise.
+class ImpulseResponse : public juce::ReferenceCountedObject
+{
+public:
+    using Ptr = juce::ReferenceCountedObjectPtr<ImpulseResponse>;
+
+    // Function: ImpulseResponse
+    // Purpose: Partitions and transforms an impulse response.
+    // Inputs:
+    // - const juce::AudioBuffer<float>& timeDomain: The response, one or two channels.
+    // - int partitionSize: The partition length in samples, a power of two.
+    ImpulseResponse(const juce::AudioBuffer<float>& timeDomain, int partitionSize);
+
+    int getPartitionSize() const noexcept { return partitionSize; }
+    int getNumPartitions() const noexcept { return numPartitions; }
+    int getNumChannels() const noexcept { return numChannels; }
+    /**Number of bins used per partition, the FFT size / 2 + 1*/
+    int getNumBins() const noexcept { return partitionSize + 1; }
+    /**Distance between two partitions in the spectrum arrays*/
+    int getBinStride() const noexcept { return binStride; }
+
+    const float* getReal(int channel, int partition) const noexcept;
+    const float* getImag(int channel, int partition) const noexcept;
+
+private:
+    int partitionSize;
+    int numPartitions;
+    int numChannels;
+    int binStride;
+
+    std::vector<float> real, imag;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ImpulseResponse)
+};
+
+//==============================================================================
+// Loads impulse responses from disk and keeps their preprocessed form, so two decks using the
+// same file at the same sample rate share one copy. Use it through juce::SharedResourcePointer.
+class ImpulseResponseLibrary
+{
+public:
+    ImpulseResponseLibrary();
+
+    // Function: load
+    // Purpose: Returns the preprocessed response for a file, reading it only if no deck has
+    //          it loaded already. Reads the file, so must not be called from the audio thread.
+    // Inputs:
+    // - const juce::File& file: An audio file readable by the basic formats.
+    // - double sampleRate: The rate the response is resampled to.
+    // - int partitionSize: The partition length the engine will use.
+    // Outputs: The response, or nullptr if the file could not be read.
+    ImpulseResponse::Ptr load(const juce::File& file, double sampleRate, int partitionSize);
+
+private:
+    // Longest response that is loaded, anything after it is cut off
+    static constexpr double maxLengthSeconds = 10.0;
+
+    juce::CriticalSection lock;
+    juce::AudioFormatManager formatManager;
+    std::map<juce::String, ImpulseResponse::Ptr> cache;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ImpulseResponseLibrary)
+};
+
+//==============================================================================
+// Uniformly partitioned overlap-save convolution of a stereo signal with an impulse response.
+//
+// The first few partitions (the head) are convolved on the audio thread, so its cost per block
+// does not depend on the length of the response. The remaining partitions (the tail) are
+// convolved on a worker thread. The tail of output block n only needs input up to block
+// n - headPartitions, so the worker has headPartitions blocks to deliver it. A tail block that
+// is not ready in time is left out and counted as missed.
+//
+// The wet output is delayed by one partition.
+class ConvolutionEngine : private juce::Thread
+{
+public:
+    // Function: ConvolutionEngine
+    // Purpose: Allocates all buffers for the response and starts the tail worker.
+    // Inputs:
+    // - ImpulseResponse::Ptr impulseResponse: The shared, preprocessed response.
+    explicit ConvolutionEngine(ImpulseResponse::Ptr impulseResponse);
+    ~ConvolutionEngine() override;
+
+    // Function: process
+    // Purpose: Replaces the signal with its convolution. Does not allocate or lock.
+    // Inputs:
+    // - float* left: The first channel, processed in place.
+    // - float* right: The second channel, or nullptr for mono material.
+    // - int numSamples: The number of samples in each channel.
+    void process(float* left, float* right, int numSamples) noexcept;
+
+    /**Returns how many tail blocks the worker delivered too late*/
+    int getNumMissedTailBlocks() const noexcept { return missedTailBlocks.load(); }
+
+private:
+    static constexpr int numChannels = 2;
+
+    // Partitions convolved on the audio thread, and so the worker's deadline in blocks
+    static constexpr int headPartitionsMax = 4;
+
+    void run() override;
+
+    // Convolves the last full input block and stores the next output block
+    void processPartition() noexcept;
+
+    // Turns the accumulated spectrum back into the last partition of the time signal
+    static void inverseTransform(juce::dsp::FFT& transform, std::vector<float>& buffer,
+                                 const float* accumulatedReal, const float* accumulatedImag, int numBins) noexcept;
+
+    // Convolves one spectrum that was handed over by the audio thread
+    void processTailBlock(int fifoSlot) noexcept;
+
+    float* fifoReal(int slot, int channel) noexcept;
+    float* fifoImag(int slot, int channel) noexcept;
+
+    ImpulseResponse::Ptr response;
+
+    const int partitionSize;
+    const int fftSize;
+    const int numBins;
+    const int binStride;
+    const int headPartitions;
+    const int tailPartitions;
+
+    // Audio thread state
+    juce::dsp::FFT fft;
+    std::vector<float> fftBuffer;
+    std::vector<float> inputBuffers;    // the last two partitions of input, per channel
+    std::vector<float> outputBuffers;   // the output block being played, per channel
+    std::vector<float> headReal, headImag;
+    std::vector<float> accumulatorReal, accumulatorImag;
+    int headPosition = 0;
+    int inputFill = 0;
+    juce::int64 blockIndex = 0;
+
+    // Input spectra on their way to the worker
+    juce::AbstractFifo spectrumFifo;
+    std::vector<float> fifoSpectra;
+    std::vector<juce::int64> fifoBlockIndices;
+
+    // Worker state
+    juce::dsp::FFT tailFft;
+    std::vector<float> tailFftBuffer;
+    std::vector<float> tailReal, tailImag;
+    std::vector<float> tailAccumulatorReal, tailAccumulatorImag;
+    int tailPosition = 0;
+
+    // Finished tail blocks; a slot is valid for the block whose index is in its stamp
+    int numTailSlots;
+    std::vector<float> tailOutput;
+    std::unique_ptr<std::atomic<juce::int64>[]> tailStamps;
+    std::atomic<int> missedTailBlocks{ 0 };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ConvolutionEngine)
+};
+
+//==============================================================================
+// Convolution reverb for a deck. Passes its input through untouched until an impulse
+// response is loaded; afterwards it mixes the convolved signal with the dry input.
+// Like the other deck stages it does not prepare its input; DJAudioPlayer prepares each stage.
+class ConvolutionReverbAudioSource : public juce::AudioSource
+{
+public:
+    // Constructor: Takes the source to read from, optionally owning it
+    ConvolutionReverbAudioSource(juce::AudioSource* inputSource, bool deleteInputWhenDeleted);
+    ~ConvolutionReverbAudioSource() override;
+
+    void prepareToPlay(int samplesPerBlockExpected, double sampleRate) override;
+    void releaseResources() override;
+    void getNextAudioBlock(const juce::AudioSourceChannelInfo& bufferToFill) override;
+
+    /**Convolves a block in place without pulling the input, so a caller can time each stage*/
+    void processBlock(const juce::AudioSourceChannelInfo& bufferToFill);
+
+    /**Reserves the copy of the dry signal in the deck's arena, before prepareToPlay*/
+    void reserveScratch(ScratchArena& arena, int maximumBlockSize);
+
+    /**Loads an impulse response file and switches to it, returns false if it can't be read*/
+    bool loadImpulseResponse(const juce::File& file);
+    /**Removes the impulse response so the source passes its input through*/
+    void clearImpulseResponse();
+    /**Returns whether an impulse response is loaded*/
+    bool hasImpulseResponse() const noexcept { return impulseResponseFile != juce::File(); }
+    /**Sets the wet and dry levels, scaled like juce::Reverb::Parameters*/
+    void setLevels(float wetLevel, float dryLevel);
+
+    /**Takes the engine out of the chain after it went non-finite, until recoverFromFault replaces it. Audio thread*/
+    void reset() noexcept { engineFaulted = true; }
+    /**Builds a fresh engine for a faulted one. Message thread*/
+    void recoverFromFault();
+
+private:
+    // Same dry scaling as juce::Reverb so switching reverbs keeps the level
+    static constexpr float levelScaleFactor = 2.0f;
+
+    // Builds an engine for the current file and settings and hands it to the audio thread
+    bool rebuildEngine();
+    void setEngine(std::unique_ptr<ConvolutionEngine> newEngine);
+
+    juce::OptionalScopedPointer<juce::AudioSource> input;
+    juce::SharedResourcePointer<ImpulseResponseLibrary> library;
+    juce::File impulseResponseFile;
+
+    // The audio thread owns activeEngine. standbyEngine holds either an engine waiting to be
+    // picked up or the one it replaced, which is then destroyed on the message thread.
+    juce::SpinLock engineLock;
+    std::unique_ptr<ConvolutionEngine> activeEngine;
+    std::unique_ptr<ConvolutionEngine> standbyEngine;
+    std::atomic<bool> engineChangePending{ false };
+    // Set when the engine's output wasn't finite, cleared when the next engine is picked up
+    std::atomic<bool> engineFaulted{ false };
+
+    // Copy of the dry signal while the engine overwrites the block
+    ScratchArena* scratch = nullptr;
+    int dryScratch = -1;
+
+    std::atomic<float> wetTarget{ 0.0f };
+    std::atomic<float> dryTarget{ 1.0f };
+    juce::SmoothedValue<float> wetGain, dryGain;
+
+    double currentSampleRate = 44100.0;
+    int partitionSize = 512;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ConvolutionReverbAudioSource)
+};
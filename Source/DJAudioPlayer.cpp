@@ -9,6 +9,8 @@
 */
 
 #include "DJAudioPlayer.h"
+#include "AsyncLogger.h"
+#include "RealtimeSafetyChecker.h"
 
 // Constructor: initializes the format manager, sets default reverb settings, and prepares the audio processor
 // Inputs: Reference to an existing AudioFormatManager instance
@@ -20,6 +22,7 @@ DJAudioPlayer::DJAudioPlayer(juce::AudioFormatManager& _formatManager) : formatM
     reverbParameters.wetLevel = 0;
     reverbParameters.dryLevel = 1.0;
     reverbSource.setParameters(reverbParameters);
+    convolutionSource.setLevels(reverbParameters.wetLevel, reverbParameters.dryLevel);
 
     // (Self-written code) Initialize the audio processor with initial sample rate and block size
     double initialSampleRate = 44100.0;
@@ -30,55 +33,489 @@ DJAudioPlayer::DJAudioPlayer(juce::AudioFormatManager& _formatManager) : formatM
 // Destructor: clean up resources when the instance is destroyed
 DJAudioPlayer::~DJAudioPlayer()
 {
+    setRenderAheadThread(nullptr);
 }
 
-// Prepares various sources for playback with given sample rate and block size
+// Prepares the deck chain. All stages agree on the device block size as the largest block
+// they are handed; longer callbacks are split. The transport reads up to maxSpeedRatio times
+// more samples of the track, times its rate correction, and sizes its input for that once
+// here, so no buffer grows while playing. Scratch buffers of the stages come from one arena per deck.
 // Inputs: Expected samples per block, Sample rate
 void DJAudioPlayer::prepareToPlay(int samplesPerBlockExpected, double sampleRate)
 {
-    transportSource.prepareToPlay(samplesPerBlockExpected, sampleRate);
-    resampleSource.prepareToPlay(samplesPerBlockExpected, sampleRate);
-    reverbSource.prepareToPlay(samplesPerBlockExpected, sampleRate);
-    audioProcessor.prepareToPlay(sampleRate, samplesPerBlockExpected);
+    // (Self-written code) The render-ahead thread may be in the chain; wait for its block
+    while (!takeBackFromWorker())
+        juce::Thread::yield();
+
+    maximumBlockSize = juce::jmax(1, samplesPerBlockExpected);
+
+    // (Self-written code) Reserve every stage's scratch space, then allocate it in one go
+    scratchArena.clear();
+    convolutionSource.reserveScratch(scratchArena, maximumBlockSize);
+    pluginChain.reserveScratch(scratchArena, maximumBlockSize);
+    scratchArena.allocate();
+
+    transportSource.prepareToPlay(maximumBlockSize, sampleRate);
+    reverbSource.prepareToPlay(maximumBlockSize, sampleRate);
+    convolutionSource.prepareToPlay(maximumBlockSize, sampleRate);
+    audioProcessor.prepareToPlay(sampleRate, maximumBlockSize);
+    pluginChain.prepareToPlay(maximumBlockSize, sampleRate);
+
+    // (Self-written code) The render-ahead buffer holds whole blocks of the device size
+    handoverBlocks = (int) std::ceil(handoverSeconds * sampleRate / maximumBlockSize);
+    const int renderAheadBlocks = juce::jmax(handoverBlocks + 1, (int) std::ceil(renderAheadSeconds * sampleRate / maximumBlockSize));
+    renderAhead.prepare(2, maximumBlockSize, renderAheadBlocks);
+    quietSamplesBeforeRenderAhead = (juce::int64) (quietSecondsBeforeRenderAhead * sampleRate);
+    quietSamples = 0;
+    crossfadeBuffer.setSize(2, maximumBlockSize);
+
+    RT_LOG(info, "DJAudioPlayer::prepareToPlay scratch memory in bytes:", getScratchMemoryBytes());
 }
 
-// Processes the next block of audio
+// Plays the next block: copied from the render-ahead buffer while the render-ahead thread has
+// the deck, rendered here otherwise. A control change takes the deck back from the worker and
+// throws away what it rendered ahead, so the change is heard from the next chunk, or from the
+// first chunk whose audio the read-ahead still holds: until then the rendered-ahead audio
+// plays on, and the live render fades in over it. A deck left alone for long enough is handed
+// to the worker again. When the worker falls behind, the rest of the block is rendered here.
 // Inputs: Information about the buffer to fill
 void DJAudioPlayer::getNextAudioBlock(const juce::AudioSourceChannelInfo& bufferToFill)
 {
-    reverbSource.getNextAudioBlock(bufferToFill);
-    audioProcessor.processAudioBlock(*bufferToFill.buffer);
+    // A deck can also be rendered outside MainComponent, so it marks the thread itself
+    const RealtimeSafetyChecker::ScopedRealtimeSection realtimeSection;
+    const juce::ScopedNoDenormals noDenormals;
+
+    const auto changes = controlChanges.load();
+
+    if (changes != seenControlChanges)
+    {
+        seenControlChanges = changes;
+        quietSamples = 0;
+        takeBackPending = renderingAhead.load();
+    }
+
+    // (Self-written code) The worker may be mid-block; the deck is then taken back one chunk later
+    if (takeBackPending && beginTakeBack())
+        takeBackPending = false;
+
+    if (fadingFromRenderAhead && canFadeToLive(bufferToFill.numSamples))
+    {
+        fadeToLive(bufferToFill);
+        return;
+    }
+
+    int played = 0;
+
+    if (renderingAhead.load())
+    {
+        played = renderAhead.read(*bufferToFill.buffer, bufferToFill.startSample, bufferToFill.numSamples);
+
+        if (played == bufferToFill.numSamples)
+            return;
+
+        ++renderAheadUnderruns;
+        RT_LOG_RATE_LIMITED(warning, 1000, "DJAudioPlayer render-ahead fell behind, samples missing:",
+                            bufferToFill.numSamples - played);
+
+        if (!takeBackFromWorker())
+        {
+            bufferToFill.buffer->clear(bufferToFill.startSample + played, bufferToFill.numSamples - played);
+            return;
+        }
+    }
+
+    const juce::AudioSourceChannelInfo rest(bufferToFill.buffer, bufferToFill.startSample + played, bufferToFill.numSamples - played);
+    render(rest, performanceMonitor != nullptr);
+    quietSamples += rest.numSamples;
+
+    if (renderAheadThread != nullptr && renderAhead.isPrepared() && seekable.load()
+        && quietSamples >= quietSamplesBeforeRenderAhead)
+        handOverToWorker();
+}
+
+// Renders through the chain in pieces no longer than the agreed maximum block size
+// Inputs: Information about the buffer to fill, and whether to time the stages
+void DJAudioPlayer::render(const juce::AudioSourceChannelInfo& bufferToFill, bool timed)
+{
+    const int blockSize = maximumBlockSize > 0 ? maximumBlockSize : bufferToFill.numSamples;
+
+    for (int offset = 0; offset < bufferToFill.numSamples; offset += blockSize)
+    {
+        const juce::AudioSourceChannelInfo piece(bufferToFill.buffer,
+                                                 bufferToFill.startSample + offset,
+                                                 juce::jmin(blockSize, bufferToFill.numSamples - offset));
+
+        processStages(piece, timed);
+    }
+}
+
+// Function: handOverToWorker
+// Purpose: Renders the first blocks here, enough to cover the worker's wake-up, then lets the
+//          worker have the chain. A seek from before the handover is already in these blocks.
+void DJAudioPlayer::handOverToWorker()
+{
+    positionMoved = false;
+    renderAhead.clear(transportSource.getNextReadPosition());
+
+    for (int block = 0; block < handoverBlocks; ++block)
+    {
+        const auto blockToFill = renderAhead.beginBlock(transportSource.getNextReadPosition());
+        render(blockToFill, false);
+        renderAhead.finishBlock(transportSource.getNextReadPosition());
+    }
+
+    renderingAhead = true;
+    chainBusy = false;
+}
+
+// Function: takeBackFromWorker
+// Purpose: Claims the chain unless the worker is rendering a block. Unless a seek or load moved
+//          the transport meanwhile, the transport goes back to the position of the sample
+//          playing next, whose audio the read-ahead kept.
+// Outputs: Whether the audio thread has the chain; true when it had it already
+bool DJAudioPlayer::takeBackFromWorker() noexcept
+{
+    if (!renderingAhead.load())
+        return true;
+
+    if (!fadingFromRenderAhead && chainBusy.exchange(true))
+        return false;
+
+    resumeLive(renderAhead.getNumReady() > 0, renderAhead.getReadPosition());
+    return true;
+}
+
+// Function: beginTakeBack
+// Purpose: Claims the chain, so the worker renders no more, and leaves the rendered-ahead
+//          audio playing until canFadeToLive.
+bool DJAudioPlayer::beginTakeBack() noexcept
+{
+    if (!renderingAhead.load() || fadingFromRenderAhead)
+        return true;
+
+    if (chainBusy.exchange(true))
+        return false;
+
+    fadingFromRenderAhead = true;
+    return true;
+}
+
+// Function: canFadeToLive
+// Purpose: A seek or load goes live at once. Otherwise the transport is put at the sample
+//          playing next while the read-ahead hasn't got it, which makes the read-ahead thread
+//          decode from there; the rendered-ahead audio plays on meanwhile, and when it runs
+//          out the deck goes live regardless.
+bool DJAudioPlayer::canFadeToLive(int numSamples) noexcept
+{
+    const auto position = renderAhead.getReadPosition();
+
+    if (positionMoved.load() || renderAhead.getNumReady() < numSamples || isReadAheadBuffered(position, numSamples))
+        return true;
+
+    transportSource.setNextReadPosition(position);
+    return false;
+}
+
+// Function: fadeToLive
+// Purpose: Renders from the position of the sample playing next and fades from the rendered-
+//          ahead audio to it over the block, so the resampler and the effect tails, which
+//          heard the discarded audio, don't click.
+void DJAudioPlayer::fadeToLive(const juce::AudioSourceChannelInfo& bufferToFill)
+{
+    const auto position = renderAhead.getReadPosition();
+    const bool rewind = renderAhead.getNumReady() > 0;
+    const int fadeLength = positionMoved.load() ? 0 : juce::jmin(bufferToFill.numSamples, crossfadeBuffer.getNumSamples());
+    const int faded = renderAhead.read(crossfadeBuffer, 0, fadeLength);
+
+    resumeLive(rewind, position);
+    render(bufferToFill, performanceMonitor != nullptr);
+    quietSamples += bufferToFill.numSamples;
+
+    if (faded == 0)
+        return;
+
+    for (int channel = 0; channel < bufferToFill.buffer->getNumChannels(); ++channel)
+    {
+        const int fadeChannel = juce::jmin(channel, crossfadeBuffer.getNumChannels() - 1);
+        bufferToFill.buffer->applyGainRamp(channel, bufferToFill.startSample, faded, 0.0f, 1.0f);
+        bufferToFill.buffer->addFromWithRamp(channel, bufferToFill.startSample,
+                                             crossfadeBuffer.getReadPointer(fadeChannel), faded, 1.0f, 0.0f);
+    }
+}
+
+// Function: resumeLive
+// Purpose: The seek also makes the transport forget its interpolation input. The effect tails
+//          keep what they heard of the discarded audio.
+void DJAudioPlayer::resumeLive(bool rewind, juce::int64 position) noexcept
+{
+    if (!positionMoved.exchange(false) && rewind)
+        transportSource.setNextReadPosition(position);
+
+    renderAhead.clear(0);
+    renderingAhead = false;
+    fadingFromRenderAhead = false;
+    quietSamples = 0;
+}
+
+// Function: isReadAheadBuffered
+// Purpose: The transport reads its ratio times the output samples of the track plus its
+//          interpolation headroom. A stream has no read-ahead; its jitter buffer is all there
+//          is, so nothing is missing.
+bool DJAudioPlayer::isReadAheadBuffered(juce::int64 position, int numSamples) const noexcept
+{
+    const int needed = (int) std::ceil(numSamples * transportSource.getResamplingRatio()) + DeckTransport::interpolationHeadroom;
+    return transportSource.isBuffered(position, needed);
+}
+
+// Function: renderAheadBlock
+// Purpose: A held deck isn't rendered ahead, so it stays where it is. The buffer can only
+//          change while the audio thread has the chain, so it is looked at after claiming it.
+int DJAudioPlayer::renderAheadBlock()
+{
+    if (chainBusy.exchange(true))
+        return renderAheadIdleMilliseconds;
+
+    if (!renderAhead.hasRoomForBlock() || held.load())
+    {
+        chainBusy = false;
+        return renderAheadIdleMilliseconds;
+    }
+
+    {
+        const RealtimeSafetyChecker::ScopedRealtimeSection realtimeSection;
+        const juce::ScopedNoDenormals noDenormals;
+
+        const auto blockToFill = renderAhead.beginBlock(transportSource.getNextReadPosition());
+        render(blockToFill, false);
+        renderAhead.finishBlock(transportSource.getNextReadPosition());
+    }
+
+    chainBusy = false;
+    return 0;
+}
+
+juce::int64 DJAudioPlayer::getPlayedPosition() const noexcept
+{
+    return renderingAhead.load() ? renderAhead.getReadPosition() : transportSource.getNextReadPosition();
+}
+
+// Function: processStages
+// Purpose: The chain is pulled stage by stage so each one can be checked, and timed when a
+//          monitor is set and the audio thread renders. A stage whose output wasn't finite has its block silenced by the
+//          guard and is reset here, before its feedback path spreads the fault to the next
+//          blocks. The plugin chain resets its own slots; the check after it only silences.
+//          A mono track is rendered into the first channel only and copied to the second right
+//          before the first stage that needs two, at the latest before the plugins.
+void DJAudioPlayer::processStages(const juce::AudioSourceChannelInfo& piece, bool timed)
+{
+    auto& buffer = *piece.buffer;
+
+    // (Self-written code) A view of the first channel, which refers to the buffer without allocating
+    const bool startsMono = sourceChannels.load() == 1 && buffer.getNumChannels() > 1;
+    juce::AudioBuffer<float> monoView(buffer.getArrayOfWritePointers(), juce::jmin(1, buffer.getNumChannels()), piece.startSample, piece.numSamples);
+    const juce::AudioSourceChannelInfo monoPiece(&monoView, 0, piece.numSamples);
+
+    // The piece the next stage works on, mono until fanOut copies the first channel over
+    const juce::AudioSourceChannelInfo* stage = startsMono ? &monoPiece : &piece;
+    const auto fanOut = [&]
+    {
+        if (stage == &monoPiece)
+            buffer.copyFrom(1, piece.startSample, buffer, 0, piece.startSample, piece.numSamples);
+
+        stage = &piece;
+    };
+
+    const auto start = timed ? juce::Time::getHighResolutionTicks() : 0;
+    transportSource.getNextAudioBlock(*stage);
+    if (signalGuard.check(guardedSource, *stage->buffer, stage->startSample, piece.numSamples))
+        transportSource.flush();
+    const auto sourceDone = timed ? juce::Time::getHighResolutionTicks() : 0;
+
+    if (reverbNeedsStereo.load())
+        fanOut();
+
+    reverbSource.processBlock(*stage);
+    if (signalGuard.check(guardedReverb, *stage->buffer, stage->startSample, piece.numSamples))
+        reverbSource.reset();
+    convolutionSource.processBlock(*stage);
+    if (signalGuard.check(guardedConvolution, *stage->buffer, stage->startSample, piece.numSamples))
+        convolutionSource.reset();
+    const auto reverbDone = timed ? juce::Time::getHighResolutionTicks() : 0;
+
+    audioProcessor.processAudioBlock(*stage->buffer, stage->startSample, piece.numSamples);
+    if (signalGuard.check(guardedFilters, *stage->buffer, stage->startSample, piece.numSamples))
+        audioProcessor.reset();
+    const auto filtersDone = timed ? juce::Time::getHighResolutionTicks() : 0;
+
+    // Plugins expect the layout they were prepared with, so the chain leaves here in stereo
+    fanOut();
+
+    pluginChain.process(buffer, piece.startSample, piece.numSamples);
+    signalGuard.check(guardedPlugins, buffer, piece.startSample, piece.numSamples);
+
+    if (!timed)
+        return;
+
+    const auto pluginsDone = juce::Time::getHighResolutionTicks();
+
+    performanceMonitor->addDeckStageTime(performanceDeckIndex, PerformanceMonitor::sourceStage, sourceDone - start);
+    performanceMonitor->addDeckStageTime(performanceDeckIndex, PerformanceMonitor::reverbStage, reverbDone - sourceDone);
+    performanceMonitor->addDeckStageTime(performanceDeckIndex, PerformanceMonitor::filterStage, filtersDone - reverbDone);
+    performanceMonitor->addDeckStageTime(performanceDeckIndex, PerformanceMonitor::pluginStage, pluginsDone - filtersDone);
 }
 
 // Releases resources allocated by various sources
 void DJAudioPlayer::releaseResources()
 {
+    while (!takeBackFromWorker())
+        juce::Thread::yield();
+
+    renderAhead.release();
     transportSource.releaseResources();
-    resampleSource.releaseResources();
     reverbSource.releaseResources();
+    convolutionSource.releaseResources();
+    pluginChain.releaseResources();
+    scratchArena.clear();
+    maximumBlockSize = 0;
 }
 
 // Loads audio from a URL into the transport source
 // Inputs: The URL of the audio to load
 void DJAudioPlayer::loadURL(juce::URL audioURL)
 {
-    DBG("DJAudioPlayer::loadURL called");
+    RT_LOG_MESSAGE(debug, "DJAudioPlayer::loadURL called");
+
+    // (Self-written code) Opening a remote URL could stall for seconds, so a stream connects on its own thread
+    if (!audioURL.isLocalFile())
+    {
+        pendingStream = std::make_unique<StreamingAudioSource>(audioURL, formatManager);
+        return;
+    }
+
+    pendingStream.reset();
     auto* reader = formatManager.createReaderFor(audioURL.createInputStream(false));
 
     // (Self-written code) Load the reader into the transport source if valid
     if (reader != nullptr)
     {
-        std::unique_ptr<juce::AudioFormatReaderSource> newSource(new juce::AudioFormatReaderSource(reader, true));
-        transportSource.setSource(newSource.get(), 0, nullptr, reader->sampleRate);
-        readerSource.reset(newSource.release());
+        // (Self-written code) The cache also keeps what was played, for taking the deck back
+        const int samplesBehind = (int) std::ceil(rewindSeconds * maxSpeedRatio * reader->sampleRate) + DeckTransport::interpolationHeadroom;
+        attachReader(new SharedAudioReader(std::unique_ptr<juce::AudioFormatReader>(reader), readAheadThread,
+                                           readAheadSamples, samplesBehind));
+
+        loadedFile = audioURL.isLocalFile() ? audioURL.getLocalFile() : juce::File();
+        updateNormalization();
     }
 }
 
+// Function: attachReader
+// Purpose: Plays a track's shared cache through a read-ahead source of this deck's own, which
+//          keeps the deck's position.
+void DJAudioPlayer::attachReader(SharedAudioReader::Ptr reader)
+{
+    const int channels = reader->getNumChannels();
+    const double rate = reader->getSampleRate();
+    std::unique_ptr<ReadAheadAudioSource> newReadAhead(new ReadAheadAudioSource(reader));
+
+    // The old read-ahead can go once the transport has let go of it
+    transportSource.setSource(newReadAhead.get(), rate, newReadAhead.get());
+    readAheadSource = std::move(newReadAhead);
+    sourceChannels = channels;
+    streamSource.reset();
+    sharedReader = reader;
+    seekable = true;
+    positionMoved = true;
+    ++controlChanges;
+}
+
+// Function: updateStream
+// Purpose: The stream has no read-ahead of the transport's; its jitter buffer is one. A stream
+//          that failed to connect is kept until the next load so the deck can show it, and the
+//          current track stays.
+const StreamingAudioSource* DJAudioPlayer::updateStream()
+{
+    if (pendingStream != nullptr)
+    {
+        if (pendingStream->isReady())
+        {
+            transportSource.setSource(pendingStream.get(), pendingStream->getSampleRate(), nullptr);
+            readAheadSource.reset();
+            sharedReader = nullptr;
+            streamSource = std::move(pendingStream);
+            sourceChannels = juce::jlimit(1, 2, streamSource->getNumChannels());
+            // A stream can't go back, so it is never rendered ahead of its jitter buffer
+            seekable = false;
+            positionMoved = true;
+            ++controlChanges;
+
+            loadedFile = juce::File();
+            updateNormalization();
+        }
+    }
+
+    return pendingStream != nullptr ? pendingStream.get() : streamSource.get();
+}
+
+// Function: cloneFrom
+// Purpose: Plays the other deck's track from its cache, without opening or decoding the file
+//          again, and takes its speed and trim. The transport is put at the other deck's
+//          position, whose blocks are cached already, and started held if the other deck plays;
+//          the audio thread then lines the two up exactly in applyPendingSync and lets go.
+// Outputs: False if the other deck has nothing loaded.
+bool DJAudioPlayer::cloneFrom(DJAudioPlayer& source)
+{
+    if (&source == this || source.sharedReader == nullptr)
+        return false;
+
+    syncPending = false;
+    transportSource.stop();
+    attachReader(source.sharedReader);
+
+    loadedFile = source.loadedFile;
+    updateNormalization();
+    setSpeed(source.getSpeed());
+
+    transportSource.setNextReadPosition(source.getPlayedPosition());
+    held = true;
+
+    if (source.isPlaying())
+        transportSource.start();
+
+    syncSource = &source;
+    syncPending.store(true, std::memory_order_release);
+    recordParameterEvent("clone", 1.0);
+    return true;
+}
+
+// Function: applyPendingSync
+// Purpose: Copies the other deck's read position and live speed, so both decks render the same
+//          samples from this chunk on. The seek is a store into this deck's own transport,
+//          which its next block picks up. The offset left is the few samples the other deck's
+//          transport holds for its interpolation.
+void DJAudioPlayer::applyPendingSync() noexcept
+{
+    if (!syncPending.load(std::memory_order_acquire))
+        return;
+
+    // The worker mustn't be in the chain while the position moves; if it is, the next chunk syncs
+    if (!takeBackFromWorker())
+        return;
+
+    syncPending = false;
+    quietSamples = 0;
+    auto& source = *syncSource;
+
+    transportSource.setNextReadPosition(source.getPlayedPosition());
+    transportSource.setSpeed(source.transportSource.getSpeed());
+    held = source.held.load();
+}
+
 // Other methods follow a similar structure: simple, self-explanatory one-liners (self-written) with some debug information and parameter validation.
+// Logging goes through RT_LOG, which never blocks, since these setters run on every slider move.
 
-void DJAudioPlayer::play() { transportSource.start(); }
-void DJAudioPlayer::stop() { transportSource.stop(); }
-void DJAudioPlayer::setPosition(double posInSecs) { transportSource.setPosition(posInSecs); }
+void DJAudioPlayer::play() { recordParameterEvent("play", 1.0); held = false; transportSource.start(); }
+void DJAudioPlayer::stop() { recordParameterEvent("play", 0.0); held = false; transportSource.stop(); }
+void DJAudioPlayer::setPosition(double posInSecs) { positionMoved = true; ++controlChanges; transportSource.setPosition(posInSecs); }
 
 // A method to set the position relative to the length of the track
 // Inputs: The relative position (between 0 and 1)
@@ -87,10 +524,11 @@ void DJAudioPlayer::setPositionRelative(double pos)
     // (Self-written code) Parameter validation and conversion to seconds
     if (pos < 0 || pos > 1.0)
     {
-        DBG("DJAudioPlayer::setPositionRelative position should be between 0 and 1");
+        RT_LOG_RATE_LIMITED(warning, 1000, "DJAudioPlayer::setPositionRelative position should be between 0 and 1:", pos);
     }
     else
     {
+        recordParameterEvent("position", pos);
         double posInSecs = transportSource.getLengthInSeconds() * pos;
         setPosition(posInSecs);
     }
@@ -102,29 +540,52 @@ void DJAudioPlayer::setGain(double gain)
 {
     if (gain < 0 || gain > 1.0)
     {
-        DBG("DJAudioPlayer::setGain gain should be between 0 and 1");
+        RT_LOG_RATE_LIMITED(warning, 1000, "DJAudioPlayer::setGain gain should be between 0 and 1:", gain);
     }
-    else { transportSource.setGain(gain); }
+    else { recordParameterEvent("gain", gain); audioProcessor.setGain(gain); }
 }
 
 void DJAudioPlayer::setSpeed(double ratio)
 {
     if (ratio < 0.25 || ratio > 4.0)
     {
-        DBG("DJAudioPlayer::setSpeed ratio should be between 0.25 and 4");
+        RT_LOG_RATE_LIMITED(warning, 1000, "DJAudioPlayer::setSpeed ratio should be between 0.25 and 4:", ratio);
+    }
+    else { recordParameterEvent("speed", ratio); speedSetting = ratio; transportSource.setSpeed(ratio); }
+}
+
+double DJAudioPlayer::getSpeed() const noexcept { return speedSetting.load(); }
+
+// Called for every chunk while a record or jog wheel moves the deck, so it isn't a flight recorder
+// event. A record turning at a steady speed only wobbles the ratio, which the blocks rendered
+// ahead pick up late but inaudibly, so the deck keeps rendering ahead; a scratch or a nudge
+// changes it by more and takes the deck back, so it is heard from the next chunk.
+void DJAudioPlayer::setPlaybackRatio(double ratio) noexcept
+{
+    ratio = juce::jlimit(0.01, maxSpeedRatio, ratio);
+
+    if (std::abs(ratio - liveRatio) > playbackRatioTolerance * liveRatio)
+    {
+        liveRatio = ratio;
+        ++controlChanges;
     }
-    else { resampleSource.setResamplingRatio(ratio); }
+
+    transportSource.setSpeed(ratio);
 }
 
+void DJAudioPlayer::setHeld(bool shouldBeHeld) noexcept { held = shouldBeHeld; }
+bool DJAudioPlayer::isHeld() const noexcept { return held.load(); }
+
 void DJAudioPlayer::setRoomSize(float size)
 {
-    DBG("DJAudioPlayer::setRoomSize called");
+    RT_LOG_RATE_LIMITED(debug, 250, "DJAudioPlayer::setRoomSize called:", size);
     if (size < 0 || size > 1.0)
     {
-        DBG("DJAudioPlayer::setRoomSize size should be between 0 and 1.0");
+        RT_LOG_RATE_LIMITED(warning, 1000, "DJAudioPlayer::setRoomSize size should be between 0 and 1.0:", size);
     }
     else
     {
+        recordParameterEvent("roomSize", size);
         reverbParameters.roomSize = size;
         reverbSource.setParameters(reverbParameters);
     }
@@ -132,13 +593,14 @@ void DJAudioPlayer::setRoomSize(float size)
 
 void DJAudioPlayer::setDamping(float dampingAmt)
 {
-    DBG("DJAudioPlayer::setDamping called");
+    RT_LOG_RATE_LIMITED(debug, 250, "DJAudioPlayer::setDamping called:", dampingAmt);
     if (dampingAmt < 0 || dampingAmt > 1.0)
     {
-        DBG("DJAudioPlayer::setDamping amount should be between 0 and 1.0");
+        RT_LOG_RATE_LIMITED(warning, 1000, "DJAudioPlayer::setDamping amount should be between 0 and 1.0:", dampingAmt);
     }
     else
     {
+        recordParameterEvent("damping", dampingAmt);
         reverbParameters.damping = dampingAmt;
         reverbSource.setParameters(reverbParameters);
     }
@@ -146,37 +608,76 @@ void DJAudioPlayer::setDamping(float dampingAmt)
 
 void DJAudioPlayer::setWetLevel(float wetLevel)
 {
-    DBG("DJAudioPlayer::setWetLevel called");
+    RT_LOG_RATE_LIMITED(debug, 250, "DJAudioPlayer::setWetLevel called:", wetLevel);
     if (wetLevel < 0 || wetLevel > 1.0)
     {
-        DBG("DJAudioPlayer::setWetLevel level should be between 0 and 1.0");
+        RT_LOG_RATE_LIMITED(warning, 1000, "DJAudioPlayer::setWetLevel level should be between 0 and 1.0:", wetLevel);
     }
     else
     {
+        recordParameterEvent("wetLevel", wetLevel);
         reverbParameters.wetLevel = wetLevel;
         reverbSource.setParameters(reverbParameters);
+        convolutionSource.setLevels(reverbParameters.wetLevel, reverbParameters.dryLevel);
+        // One of the two reverbs is always in the chain; without wet signal it passes a mono track through
+        reverbNeedsStereo = wetLevel > 0.0f;
     }
 }
 
 void DJAudioPlayer::setDryLevel(float dryLevel)
 {
-    DBG("DJAudioPlayer::setDryLevel called");
+    RT_LOG_RATE_LIMITED(debug, 250, "DJAudioPlayer::setDryLevel called:", dryLevel);
     if (dryLevel < 0 || dryLevel > 1.0)
     {
-        DBG("DJAudioPlayer::setDryLevel level should be between 0 and 1.0");
+        RT_LOG_RATE_LIMITED(warning, 1000, "DJAudioPlayer::setDryLevel level should be between 0 and 1.0:", dryLevel);
     }
     else
     {
+        recordParameterEvent("dryLevel", dryLevel);
         reverbParameters.dryLevel = dryLevel;
         reverbSource.setParameters(reverbParameters);
+        convolutionSource.setLevels(reverbParameters.wetLevel, reverbParameters.dryLevel);
+    }
+}
+
+// Replaces the algorithmic reverb with convolution by an impulse response
+// Inputs: The impulse response file
+// Outputs: Whether the file could be loaded
+bool DJAudioPlayer::loadImpulseResponse(const juce::File& file)
+{
+    if (!convolutionSource.loadImpulseResponse(file))
+    {
+        RT_LOG_MESSAGE(warning, "DJAudioPlayer::loadImpulseResponse could not read the impulse response file");
+        return false;
     }
+
+    // Only one of the two reverbs is active; the wet and dry levels are shared
+    recordParameterEvent("impulseResponse", 1.0);
+    reverbSource.setBypassed(true);
+    return true;
+}
+
+// Goes back to the algorithmic reverb
+void DJAudioPlayer::clearImpulseResponse()
+{
+    recordParameterEvent("impulseResponse", 0.0);
+    convolutionSource.clearImpulseResponse();
+    reverbSource.setBypassed(false);
+}
+
+// Outputs: Whether the convolution reverb is active
+bool DJAudioPlayer::hasImpulseResponse() const
+{
+    return convolutionSource.hasImpulseResponse();
 }
 
 // Returns the current position relative to the length of the track
 // Outputs: The relative position as a double
 double DJAudioPlayer::getPositionRelative()
 {
-    return transportSource.getCurrentPosition() / transportSource.getLengthInSeconds();
+    // (Self-written code) The sample playing now, not the transport's, which may be rendered ahead
+    const auto length = transportSource.getTotalLength();
+    return length > 0 ? (double) getPlayedPosition() / (double) length : 0.0;
 }
 
 // Returns the length of the current track in seconds
@@ -192,3 +693,120 @@ AudioProcessorClass& DJAudioPlayer::getAudioProcessor()
 {
     return audioProcessor;
 }
+
+PluginChain& DJAudioPlayer::getPluginChain()
+{
+    return pluginChain;
+}
+
+// Reports the scratch memory of the deck chain: the shared arena plus the transport's
+// interpolation input, the one stage that keeps its own
+// Outputs: The size in bytes
+size_t DJAudioPlayer::getScratchMemoryBytes() const
+{
+    return scratchArena.getSizeInBytes() + transportSource.getInputMemoryBytes();
+}
+
+// Lets a monitor time the stages of this deck; without one the chain runs untimed
+// Inputs: The monitor, or nullptr, and the index of this deck
+void DJAudioPlayer::setPerformanceMonitor(PerformanceMonitor* monitor, int deckIndex)
+{
+    performanceMonitor = monitor;
+    performanceDeckIndex = deckIndex;
+}
+
+// Passes a control change to the flight recorder if a monitor is set, and makes the audio
+// thread take the deck back from the render-ahead thread
+// Inputs: A string literal naming the control, and its new value
+void DJAudioPlayer::recordParameterEvent(const char* name, double value)
+{
+    ++controlChanges;
+
+    if (performanceMonitor != nullptr)
+        performanceMonitor->recordParameterEvent(performanceDeckIndex, name, value);
+}
+
+// Outputs: Whether the transport is playing
+bool DJAudioPlayer::isPlaying() const
+{
+    return transportSource.isPlaying();
+}
+
+// Works out the samples left from the played position and the track's length, scaled by the
+// transport's ratio, so a scheduler on the audio thread can place a transition exactly. The
+// transport answers both without a lock.
+// Outputs: The number of output samples until the end of the track, 0 at or past the end
+juce::int64 DJAudioPlayer::getRemainingOutputSamples() const noexcept
+{
+    const auto remaining = transportSource.getTotalLength() - getPlayedPosition();
+    return juce::jmax((juce::int64) 0, (juce::int64) ((double) remaining / transportSource.getResamplingRatio()));
+}
+
+// Lets the tracks loaded from now on decode ahead on a background thread, so playing never waits for the disk
+// Inputs: The thread, or nullptr to decode on the audio thread
+void DJAudioPlayer::setReadAheadThread(juce::TimeSliceThread* thread)
+{
+    readAheadThread = thread;
+}
+
+// Lets a thread render the deck ahead of the device while nobody controls it, so the device
+// callback only copies and the deck rides out scheduling jitter. Call before playback starts.
+// Inputs: The thread, or nullptr to always render on the audio thread
+void DJAudioPlayer::setRenderAheadThread(juce::TimeSliceThread* thread)
+{
+    if (renderAheadThread != nullptr)
+        renderAheadThread->removeTimeSliceClient(&renderAheadClient);
+
+    renderAheadThread = thread;
+
+    if (renderAheadThread != nullptr)
+        renderAheadThread->addTimeSliceClient(&renderAheadClient);
+}
+
+// Outputs: The analyzer the decks share, or nullptr to play tracks at their own level
+void DJAudioPlayer::setLoudnessAnalyzer(LoudnessAnalyzer* analyzer)
+{
+    loudnessAnalyzer = analyzer;
+}
+
+// A track that hasn't been analyzed plays untrimmed and goes to the front of the analyzer's
+// queue; the trim then ramps in when its result arrives
+void DJAudioPlayer::updateNormalization()
+{
+    LoudnessAnalyzer::Result result;
+
+    if (loudnessAnalyzer == nullptr || loadedFile == juce::File())
+    {
+        applyTrim(1.0);
+    }
+    else if (loudnessAnalyzer->getResult(loadedFile, result))
+    {
+        applyTrim(LoudnessAnalyzer::getNormalizationGain(result));
+    }
+    else
+    {
+        applyTrim(1.0);
+        loudnessAnalyzer->analyze(loadedFile, true);
+    }
+}
+
+// Function: applyTrim
+// Purpose: Sets the trim only when it changes, since every recorded change takes the deck
+//          back from the render-ahead thread
+void DJAudioPlayer::applyTrim(double trim)
+{
+    if (trim == normalizationTrim)
+        return;
+
+    normalizationTrim = trim;
+    audioProcessor.setTrim(trim);
+    recordParameterEvent("trim", trim);
+}
+
+// Function: recoverFromSignalFaults
+// Purpose: The convolution engine's tail is shared with its worker thread, so it is replaced
+//          with a fresh engine here instead of being cleared on the audio thread.
+void DJAudioPlayer::recoverFromSignalFaults()
+{
+    convolutionSource.recoverFromFault();
+}
@@ -11,6 +11,18 @@
 #pragma once
 #include "../JuceLibraryCode/JuceHeader.h"
 #include "AudioProcessorClass.h"
+#include "FDNReverb.h"
+#include "ConvolutionReverb.h"
+#include "ScratchArena.h"
+#include "PerformanceMonitor.h"
+#include "PluginChain.h"
+#include "LoudnessAnalyzer.h"
+#include "SignalGuard.h"
+#include "SharedAudioReader.h"
+#include "StreamingAudioSource.h"
+#include "RenderAheadBuffer.h"
+#include "ReadAheadAudioSource.h"
+#include "DeckTransport.h"
 
 
 class DJAudioPlayer : public juce::AudioSource
@@ -23,8 +35,17 @@ class DJAudioPlayer : public juce::AudioSource
         void getNextAudioBlock(const juce::AudioSourceChannelInfo& bufferToFill) override;
         void releaseResources() override;
 
-        /**Loads the audio file*/
+        /**Loads the audio file, or starts connecting to a remote URL without waiting for it*/
         void loadURL(juce::URL audioURL);
+        // Function: updateStream
+        // Purpose: Puts a stream that finished connecting behind the transport. Message thread,
+        //          called by the deck's timer.
+        // Outputs: The stream the deck plays or connects to, or nullptr for a file.
+        const StreamingAudioSource* updateStream();
+        /**Plays another deck's track in sync with it, sharing its decoder; message thread*/
+        bool cloneFrom(DJAudioPlayer& source);
+        /**Lines the deck up with the deck it was cloned from; audio thread, before either deck renders*/
+        void applyPendingSync() noexcept;
         /**Plays loaded audio file*/
         void play();
         /**Stops playing audio file*/
@@ -35,10 +56,34 @@ class DJAudioPlayer : public juce::AudioSource
         void setGain(double gain);
         /**Sets the speed*/
         void setSpeed(double ratio);
+        /**Returns the speed set with setSpeed*/
+        double getSpeed() const noexcept;
+        /**Sets the speed on the audio thread, limited to what the deck can play, without changing the speed setting*/
+        void setPlaybackRatio(double ratio) noexcept;
+        /**Keeps the deck silent where it is, without stopping its transport; from any thread*/
+        void setHeld(bool shouldBeHeld) noexcept;
+        /**Returns whether the deck is held*/
+        bool isHeld() const noexcept;
         /**Gets relative position of playhead*/
         double getPositionRelative();
         /**Gets the length of transport source in seconds*/
         double getLengthInSeconds();
+        /**Returns whether the transport is playing*/
+        bool isPlaying() const;
+        /**Returns how many output samples are left until the end of the track at the current speed. Audio thread safe*/
+        juce::int64 getRemainingOutputSamples() const noexcept;
+        /**Decodes loaded tracks ahead of playback on the given thread; call before loading*/
+        void setReadAheadThread(juce::TimeSliceThread* thread);
+        /**Renders the deck ahead of the device callback on the given thread while nobody controls it; nullptr renders live only*/
+        void setRenderAheadThread(juce::TimeSliceThread* thread);
+        /**Returns how often the render-ahead worker fell behind the device*/
+        int getRenderAheadUnderruns() const noexcept { return renderAheadUnderruns.load(); }
+        /**Trims loaded tracks to the same loudness with the analyzer's results; call before loading*/
+        void setLoudnessAnalyzer(LoudnessAnalyzer* analyzer);
+        /**Applies the loaded track's normalization trim if the analyzer knows it by now, or asks for it*/
+        void updateNormalization();
+        /**Returns the local file playing, or no file for a stream*/
+        juce::File getLoadedFile() const { return loadedFile; }
         /**Sets the amount of reverb*/
         void setRoomSize(float size);
         /**Sets the amount of reverb*/
@@ -47,16 +92,167 @@ class DJAudioPlayer : public juce::AudioSource
         void setWetLevel(float wetLevel);
         /**Sets the amount of reverb*/
         void setDryLevel(float dryLevel);
+        /**Switches the reverb to convolution with an impulse response file, returns false if it can't be read*/
+        bool loadImpulseResponse(const juce::File& file);
+        /**Switches the reverb back to the algorithmic reverb*/
+        void clearImpulseResponse();
+        /**Returns whether an impulse response is used instead of the algorithmic reverb*/
+        bool hasImpulseResponse() const;
 
         AudioProcessorClass& getAudioProcessor();
+        /**Returns the deck's plugin insert slots, processed after the filters*/
+        PluginChain& getPluginChain();
+        /**Returns the scratch memory the deck chain set aside in its last prepare, in bytes*/
+        size_t getScratchMemoryBytes() const;
+        /**Times the stages of this deck with the given monitor, as deck deckIndex. Call before playback starts*/
+        void setPerformanceMonitor(PerformanceMonitor* monitor, int deckIndex);
+        /**Adds a control change of this deck to the monitor's flight recorder; name must be a string literal*/
+        void recordParameterEvent(const char* name, double value);
+        /**Returns the counts of denormal and non-finite blocks of each stage*/
+        const SignalGuard& getSignalGuard() const noexcept { return signalGuard; }
+        /**Rebuilds stages the audio thread took out after they went non-finite; message thread*/
+        void recoverFromSignalFaults();
     private:
+        // The stages the signal guard checks, in chain order
+        enum GuardedStage
+        {
+            guardedSource = 0,
+            guardedReverb,
+            guardedConvolution,
+            guardedFilters,
+            guardedPlugins
+        };
+
+        // Function: processStages
+        // Purpose: Pulls a piece through the chain stage by stage, checking each stage's output
+        //          and resetting a stage that went non-finite.
+        void processStages(const juce::AudioSourceChannelInfo& piece, bool timed);
+        /**Renders through the chain in pieces no longer than the maximum block size*/
+        void render(const juce::AudioSourceChannelInfo& bufferToFill, bool timed);
+
+        // Function: renderAheadBlock
+        // Purpose: Renders one block into the render-ahead buffer if the deck is handed over and
+        //          there is room. Render-ahead thread.
+        // Outputs: Milliseconds until the thread should call again
+        int renderAheadBlock();
+        /**Prerenders the handover blocks and leaves the deck to the render-ahead thread; audio thread*/
+        void handOverToWorker();
+        /**Takes the deck back, discarding what was rendered ahead; false while a block is being rendered*/
+        bool takeBackFromWorker() noexcept;
+        /**Claims the chain for a control change but keeps playing what was rendered ahead; false while a block is being rendered*/
+        bool beginTakeBack() noexcept;
+        // Function: canFadeToLive
+        // Purpose: Tells whether the transport can go back to the sample playing next without
+        //          waiting for the read-ahead thread, and otherwise asks the thread for it.
+        bool canFadeToLive(int numSamples) noexcept;
+        /**Renders the block live, faded in over what was rendered ahead for it*/
+        void fadeToLive(const juce::AudioSourceChannelInfo& bufferToFill);
+        /**Ends rendering ahead, with the chain held; the transport goes back to the position unless it moved*/
+        void resumeLive(bool rewind, juce::int64 position) noexcept;
+        /**Tells whether the read-ahead holds the track samples for numSamples output samples from a transport position*/
+        bool isReadAheadBuffered(juce::int64 position, int numSamples) const noexcept;
+        /**Returns the transport position of the sample playing next, behind the transport while rendering ahead*/
+        juce::int64 getPlayedPosition() const noexcept;
+
+        // Renders blocks ahead on the thread it is given
+        class RenderAheadClient : public juce::TimeSliceClient
+        {
+        public:
+            explicit RenderAheadClient(DJAudioPlayer& ownerToUse) : owner(ownerToUse) {}
+            int useTimeSlice() override { return owner.renderAheadBlock(); }
+
+        private:
+            DJAudioPlayer& owner;
+        };
+
+        // Fastest speed setSpeed accepts; the transport's input is sized for it
+        static constexpr double maxSpeedRatio = 4.0;
+        // Highest track rate over device rate played at full speed, e.g. a 96 kHz track on a 48 kHz device
+        static constexpr double maxRateRatio = 2.0;
+        // A record turning steadily moves the speed by less than this each chunk; a smaller change
+        // is left to the rendered-ahead audio instead of taking the deck back
+        static constexpr double playbackRatioTolerance = 0.02;
+
         void setPosition(double posInSecs);
+        /**Puts a track's shared cache behind the transport through a read-ahead source of this deck's own*/
+        void attachReader(SharedAudioReader::Ptr reader);
+        /**Sets the normalization trim and records it, unless it is the trim set already*/
+        void applyTrim(double trim);
         juce::AudioFormatManager& formatManager;
-        std::unique_ptr<juce::AudioFormatReaderSource> readerSource;
-        juce::AudioTransportSource transportSource;
-        juce::ResamplingAudioSource resampleSource{ &transportSource, false, 2 };
-        juce::ReverbAudioSource reverbSource{ &resampleSource, false };
+        // Plays a loaded file from the cache of sharedReader, which other decks may play as well
+        std::unique_ptr<ReadAheadAudioSource> readAheadSource;
+        // A remote track plays from its own jitter buffer instead of a reader; the next one
+        // connects in pendingStream while the current track keeps playing
+        std::unique_ptr<StreamingAudioSource> streamSource;
+        std::unique_ptr<StreamingAudioSource> pendingStream;
+        SharedAudioReader::Ptr sharedReader;
+        DeckTransport transportSource{ maxSpeedRatio * maxRateRatio };
+        FDNReverbAudioSource reverbSource{ &transportSource, false };
+        ConvolutionReverbAudioSource convolutionSource{ &reverbSource, false };
         juce::Reverb::Parameters reverbParameters;
 
         AudioProcessorClass audioProcessor;
+        PluginChain pluginChain;
+        SignalGuard signalGuard{ "source", "reverb", "convolution", "filters", "plugins" };
+        // Channels of the loaded track, 1 or 2. A mono track goes through the chain in one
+        // channel until a stage that makes stereo out of it: either reverb with any wet level,
+        // or the plugin chain.
+        std::atomic<int> sourceChannels{ 2 };
+        std::atomic<bool> reverbNeedsStereo{ false };
+
+        ScratchArena scratchArena;
+        int maximumBlockSize = 0;
+
+        // Samples decoded ahead of the transport, on the read-ahead thread when one is set
+        static constexpr int readAheadSamples = 48000;
+        juce::TimeSliceThread* readAheadThread = nullptr;
+        std::atomic<double> speedSetting{ 1.0 };
+        std::atomic<bool> held{ false };
+
+        // Render-ahead. The chain belongs to whoever set chainBusy: the audio thread for as long
+        // as it renders live, the render-ahead thread for the block it is rendering. Every control
+        // change bumps controlChanges, which makes the audio thread take the deck back.
+        static constexpr double renderAheadSeconds = 0.2;
+        // Played audio the read-ahead keeps, so taking the deck back finds the transport's
+        // audio still decoded. Twice the rendered-ahead time covers the block the render-ahead
+        // buffer rounds up to.
+        static constexpr double rewindSeconds = 2.0 * renderAheadSeconds;
+        // Rendered by the audio thread at the handover, so the worker has time to wake up
+        static constexpr double handoverSeconds = 0.01;
+        // A deck renders live until its controls have been left alone for this long
+        static constexpr double quietSecondsBeforeRenderAhead = 0.5;
+        static constexpr int renderAheadIdleMilliseconds = 2;
+        RenderAheadBuffer renderAhead;
+        RenderAheadClient renderAheadClient{ *this };
+        juce::TimeSliceThread* renderAheadThread = nullptr;
+        std::atomic<bool> chainBusy{ true };
+        std::atomic<bool> renderingAhead{ false };
+        std::atomic<juce::uint32> controlChanges{ 0 };
+        // Set by seeks and loads, so taking the deck back doesn't undo them
+        std::atomic<bool> positionMoved{ false };
+        std::atomic<bool> seekable{ true };
+        std::atomic<int> renderAheadUnderruns{ 0 };
+        // Audio thread only
+        juce::uint32 seenControlChanges = 0;
+        bool takeBackPending = false;
+        // Set while a control change waits for the transport's audio to be decoded again; the
+        // audio thread has the chain and plays what was rendered ahead meanwhile
+        bool fadingFromRenderAhead = false;
+        juce::AudioBuffer<float> crossfadeBuffer;
+        juce::int64 quietSamples = 0;
+        juce::int64 quietSamplesBeforeRenderAhead = 0;
+        int handoverBlocks = 1;
+        // The playback ratio the deck was last taken back for
+        double liveRatio = 1.0;
+
+        // The deck a clone lines up with at the start of the next chunk
+        DJAudioPlayer* syncSource = nullptr;
+        std::atomic<bool> syncPending{ false };
+
+        LoudnessAnalyzer* loudnessAnalyzer = nullptr;
+        juce::File loadedFile;
+        double normalizationTrim = 1.0;
+
+        PerformanceMonitor* performanceMonitor = nullptr;
+        int performanceDeckIndex = 0;
 };
\ No newline at end of file
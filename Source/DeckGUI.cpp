@@ -26,6 +26,8 @@ DeckGUI::DeckGUI(int _id,
     addAndMakeVisible(playButton);
     addAndMakeVisible(stopButton);
     addAndMakeVisible(loadButton);
+    addAndMakeVisible(impulseResponseButton);
+    addAndMakeVisible(doubleButton);
     addAndMakeVisible(volSlider);
     addAndMakeVisible(volLabel);
     addAndMakeVisible(speedSlider);
@@ -58,11 +60,46 @@ DeckGUI::DeckGUI(int _id,
     addAndMakeVisible(&bandPassSlider);
     addAndMakeVisible(&highPassSlider);
 
+    //isolator band knobs, fully left kills the band and double click returns to unity
+    for (auto* bandSlider : { &lowBandSlider, &midBandSlider, &highBandSlider })
+    {
+        bandSlider->setSliderStyle(juce::Slider::Rotary);
+        bandSlider->setRange(0.0, 2.0, 0.01);
+        bandSlider->setValue(1.0); // Initial value
+        bandSlider->setDoubleClickReturnValue(true, 1.0);
+        bandSlider->addListener(this);
+        addAndMakeVisible(bandSlider);
+    }
+    lowBandSlider.setTooltip("Low (turn fully left to kill)");
+    midBandSlider.setTooltip("Mid (turn fully left to kill)");
+    highBandSlider.setTooltip("High (turn fully left to kill)");
+
+    //filter on/off toggles, the processor fades a filter in or out when it is switched
+    lowPassButton.setButtonText("LP");
+    bandPassButton.setButtonText("BP");
+    highPassButton.setButtonText("HP");
+    lowPassButton.setToggleState(lowPassEnabled, juce::dontSendNotification);
+    bandPassButton.setToggleState(bandPassEnabled, juce::dontSendNotification);
+    highPassButton.setToggleState(highPassEnabled, juce::dontSendNotification);
+    lowPassButton.onClick = [this] { toggleLowPassFilter(); };
+    bandPassButton.onClick = [this] { toggleBandPassFilter(); };
+    highPassButton.onClick = [this] { toggleHighPassFilter(); };
+
+    addAndMakeVisible(&lowPassButton);
+    addAndMakeVisible(&bandPassButton);
+    addAndMakeVisible(&highPassButton);
+
+    player->getAudioProcessor().setLowPassEnabled(lowPassEnabled);
+    player->getAudioProcessor().setBandPassEnabled(bandPassEnabled);
+    player->getAudioProcessor().setHighPassEnabled(highPassEnabled);
+
 
     // add listeners
     playButton.addListener(this);
     stopButton.addListener(this);
     loadButton.addListener(this);
+    impulseResponseButton.addListener(this);
+    doubleButton.addListener(this);
     volSlider.addListener(this);
     speedSlider.addListener(this);
     posSlider.addListener(this);
@@ -74,6 +111,9 @@ DeckGUI::DeckGUI(int _id,
     playButton.setLookAndFeel(&customLookAndFeel);
     stopButton.setLookAndFeel(&customLookAndFeel);
     loadButton.setLookAndFeel(&customLookAndFeel);
+    impulseResponseButton.setLookAndFeel(&customLookAndFeel);
+    doubleButton.setLookAndFeel(&customLookAndFeel);
+    doubleButton.setTooltip("Double the other deck: same track and position, no reload");
     volSlider.setLookAndFeel(&customLookAndFeel);
     speedSlider.setLookAndFeel(&customLookAndFeel);
     posSlider.setLookAndFeel(&customLookAndFeel);
@@ -126,6 +166,7 @@ DeckGUI::DeckGUI(int _id,
     reverbSlider.setNumDecimalPlacesToDisplay(2);
 
     //configure reverb plots
+    impulseResponseButton.setTooltip("Load an impulse response for the reverb, click again to go back to the built in reverb");
     
     reverbPlot1.setTooltip("Set reverbe");
     reverbPlot2.setTooltip("Set reverbe");
@@ -147,6 +188,8 @@ DeckGUI::~DeckGUI()
     playButton.setLookAndFeel(nullptr);
     stopButton.setLookAndFeel(nullptr);
     loadButton.setLookAndFeel(nullptr);
+    impulseResponseButton.setLookAndFeel(nullptr);
+    doubleButton.setLookAndFeel(nullptr);
     volSlider.setLookAndFeel(nullptr);
     speedSlider.setLookAndFeel(nullptr);
     posSlider.setLookAndFeel(nullptr);
@@ -195,16 +238,27 @@ void DeckGUI::resized()
     //                   x start, y start, width, height
     playButton.setBounds(0, 0, mainRight / 3, buttonHeight);
     stopButton.setBounds(mainRight / 3, 0, mainRight / 3, buttonHeight);
-    loadButton.setBounds(2 * mainRight / 3, 0, mainRight / 3, buttonHeight);
+    loadButton.setBounds(2 * mainRight / 3, 0, mainRight / 3 - 2 * buttonHeight, buttonHeight);
+    doubleButton.setBounds(mainRight - 2 * buttonHeight, 0, buttonHeight, buttonHeight);
+    impulseResponseButton.setBounds(mainRight - buttonHeight, 0, buttonHeight, buttonHeight);
+
+    int toggleWidth = buttonHeight;
+    lowPassButton.setBounds(0, buttonHeight, toggleWidth, buttonHeight);
+    bandPassButton.setBounds(mainRight / 3, buttonHeight, toggleWidth, buttonHeight);
+    highPassButton.setBounds(2 * mainRight / 3, buttonHeight, toggleWidth, buttonHeight);
 
-    lowPassSlider.setBounds(0, buttonHeight, mainRight / 3, buttonHeight);
-    bandPassSlider.setBounds(mainRight / 3, buttonHeight, mainRight / 3, buttonHeight);
-    highPassSlider.setBounds(2 * mainRight / 3, buttonHeight, mainRight / 3, buttonHeight);
+    lowPassSlider.setBounds(toggleWidth, buttonHeight, mainRight / 3 - toggleWidth, buttonHeight);
+    bandPassSlider.setBounds(mainRight / 3 + toggleWidth, buttonHeight, mainRight / 3 - toggleWidth, buttonHeight);
+    highPassSlider.setBounds(2 * mainRight / 3 + toggleWidth, buttonHeight, mainRight / 3 - toggleWidth, buttonHeight);
 
-    // Increasing the height of the sliders below to use up the space left by removed toggle buttons
-    volSlider.setBounds(sliderLeft, 2 * buttonHeight, mainRight - sliderLeft, buttonHeight * 1.5);
-    speedSlider.setBounds(sliderLeft, 3.5 * buttonHeight, mainRight - sliderLeft, buttonHeight * 1.5);
-    posSlider.setBounds(sliderLeft, 5 * buttonHeight, mainRight - sliderLeft, buttonHeight * 1.5);
+    lowBandSlider.setBounds(0, 2 * buttonHeight, mainRight / 3, buttonHeight);
+    midBandSlider.setBounds(mainRight / 3, 2 * buttonHeight, mainRight / 3, buttonHeight);
+    highBandSlider.setBounds(2 * mainRight / 3, 2 * buttonHeight, mainRight / 3, buttonHeight);
+
+    // The sliders below share the space between the isolator row and the waveform
+    volSlider.setBounds(sliderLeft, 3 * buttonHeight, mainRight - sliderLeft, buttonHeight * 7 / 6);
+    speedSlider.setBounds(sliderLeft, 3 * buttonHeight + buttonHeight * 7 / 6, mainRight - sliderLeft, buttonHeight * 7 / 6);
+    posSlider.setBounds(sliderLeft, 3 * buttonHeight + buttonHeight * 7 / 3, mainRight - sliderLeft, buttonHeight * 7 / 6);
 
     reverbPlot1.setBounds(mainRight, 0, plotRight, getHeight() / 2);
     reverbPlot2.setBounds(mainRight, getHeight() / 2, plotRight, getHeight() / 2);
@@ -236,6 +290,40 @@ void DeckGUI::buttonClicked(juce::Button* button)
             loadFile(juce::URL{ chooser.getResult() });
         }
     }
+    if (button == &impulseResponseButton)
+    {
+        DBG("IR button was clicked ");
+        if (player->hasImpulseResponse())
+        {
+            player->clearImpulseResponse();
+        }
+        else
+        {
+            juce::FileChooser chooser{ "Select an impulse response", {}, "*.wav;*.aif;*.aiff;*.flac" };
+            if (chooser.browseForFileToOpen())
+            {
+                player->loadImpulseResponse(chooser.getResult());
+            }
+        }
+        impulseResponseButton.setToggleState(player->hasImpulseResponse(), juce::dontSendNotification);
+    }
+    if (button == &doubleButton)
+    {
+        if (onDoubleRequested)
+            onDoubleRequested();
+    }
+}
+
+// Function: cloneFrom
+// Purpose: Clones the other deck's player and shows its waveform; the speed slider follows
+//          without notifying, since the player already took the speed over. (Personal code)
+void DeckGUI::cloneFrom(DeckGUI& source)
+{
+    if (!player->cloneFrom(*source.player))
+        return;
+
+    waveformDisplay.shareWaveform(source.waveformDisplay);
+    speedSlider.setValue(source.speedSlider.getValue(), juce::dontSendNotification);
 }
 
 //to handle the slider value changes
@@ -260,16 +348,34 @@ void DeckGUI::sliderValueChanged(juce::Slider* sliderP)
     {
         DBG("Low Pass slider moved " << sliderP->getValue());
         player->getAudioProcessor().setLowPassFrequency(sliderP->getValue());
+        player->recordParameterEvent("lowPassFrequency", sliderP->getValue());
     }
     if (sliderP == &bandPassSlider)
     {
         DBG("Band Pass slider moved " << sliderP->getValue());
         player->getAudioProcessor().setBandPassFrequency(sliderP->getValue());
+        player->recordParameterEvent("bandPassFrequency", sliderP->getValue());
     }
     if (sliderP == &highPassSlider)
     {
         DBG("High Pass slider moved " << sliderP->getValue());
         player->getAudioProcessor().setHighPassFrequency(sliderP->getValue());
+        player->recordParameterEvent("highPassFrequency", sliderP->getValue());
+    }
+    if (sliderP == &lowBandSlider)
+    {
+        player->getAudioProcessor().setLowBandGain(sliderP->getValue());
+        player->recordParameterEvent("lowBandGain", sliderP->getValue());
+    }
+    if (sliderP == &midBandSlider)
+    {
+        player->getAudioProcessor().setMidBandGain(sliderP->getValue());
+        player->recordParameterEvent("midBandGain", sliderP->getValue());
+    }
+    if (sliderP == &highBandSlider)
+    {
+        player->getAudioProcessor().setHighBandGain(sliderP->getValue());
+        player->recordParameterEvent("highBandGain", sliderP->getValue());
     }
 
 }
@@ -313,7 +419,17 @@ void DeckGUI::loadFile(juce::URL audioURL)
 {
     DBG("DeckGUI::loadFile called");
     player->loadURL(audioURL);
-    waveformDisplay.loadURL(audioURL);
+
+    // (Self-written code) A remote URL streams; reading it for a thumbnail would block the UI
+    if (audioURL.isLocalFile())
+    {
+        waveformDisplay.loadURL(audioURL);
+        updateBeatGrid();
+    }
+    else
+    {
+        waveformDisplay.showStream(audioURL.getFileName());
+    }
 
    
 }
@@ -327,26 +443,93 @@ void DeckGUI::timerCallback()
     {
         waveformDisplay.setPositionRelative(player->getPositionRelative());
     }
+
+    waveformDisplay.setStatusText(getStreamStatusText(player->updateStream()));
+}
+
+// Function: getStreamStatusText
+// Purpose: Describes a stream's state and jitter buffer for the waveform display.
+// Inputs: The deck's stream, or nullptr when it plays a file
+// Outputs: The text, empty for a file
+juce::String DeckGUI::getStreamStatusText(const StreamingAudioSource* stream)
+{
+    if (stream == nullptr)
+        return {};
+
+    const auto buffered = juce::String(stream->getBufferedSeconds(), 1) + " s";
+    const auto underruns = stream->getNumUnderruns() > 0 ? ", underruns: " + juce::String(stream->getNumUnderruns()) : juce::String();
+
+    switch (stream->getState())
+    {
+        case StreamingAudioSource::connecting: return "Connecting...";
+        case StreamingAudioSource::buffering:
+            // A paused deck stays buffering however much has arrived
+            if (stream->getBufferedSeconds() >= stream->getTargetSeconds())
+                return "Ready, " + buffered + " buffered" + underruns;
+            return "Buffering " + buffered + " of " + juce::String(stream->getTargetSeconds(), 1) + " s" + underruns;
+        case StreamingAudioSource::playing:    return "Streaming, " + buffered + " buffered" + underruns;
+        case StreamingAudioSource::ended:      return "Stream ended";
+        case StreamingAudioSource::failed:     return "Stream failed";
+    }
+
+    return {};
 }
 
 
 void DeckGUI::toggleLowPassFilter()
 {
     lowPassEnabled = !lowPassEnabled;
+    lowPassButton.setToggleState(lowPassEnabled, juce::dontSendNotification);
+    player->getAudioProcessor().setLowPassEnabled(lowPassEnabled);
+    player->recordParameterEvent("lowPassEnabled", lowPassEnabled ? 1.0 : 0.0);
 }
 
 void DeckGUI::toggleBandPassFilter()
 {
     bandPassEnabled = !bandPassEnabled;
+    bandPassButton.setToggleState(bandPassEnabled, juce::dontSendNotification);
+    player->getAudioProcessor().setBandPassEnabled(bandPassEnabled);
+    player->recordParameterEvent("bandPassEnabled", bandPassEnabled ? 1.0 : 0.0);
 }
 
 void DeckGUI::toggleHighPassFilter()
 {
     highPassEnabled = !highPassEnabled;
+    highPassButton.setToggleState(highPassEnabled, juce::dontSendNotification);
+    player->getAudioProcessor().setHighPassEnabled(highPassEnabled);
+    player->recordParameterEvent("highPassEnabled", highPassEnabled ? 1.0 : 0.0);
 }
 
 
 void DeckGUI::setDJAudioPlayer(DJAudioPlayer* playerInstance)
 {
     player = playerInstance;
+}
+
+void DeckGUI::setBeatAnalyzer(BeatAnalyzer* analyzer)
+{
+    beatAnalyzer = analyzer;
+}
+
+// Function: updateBeatGrid
+// Purpose: A track just loaded goes to the front of the analyzer's queue; its grid appears
+//          when the analyzer calls back. A stream has no grid. (Personal code)
+void DeckGUI::updateBeatGrid()
+{
+    const juce::File file = player->getLoadedFile();
+    BeatAnalyzer::Result result;
+
+    if (beatAnalyzer == nullptr || file == juce::File())
+    {
+        waveformDisplay.setBeatGrid(0.0, 0.0, BeatAnalyzer::beatsPerBar);
+    }
+    else if (beatAnalyzer->getResult(file, result))
+    {
+        waveformDisplay.setBeatGrid(result.hasBeat ? result.bpm : 0.0, result.firstDownbeat, BeatAnalyzer::beatsPerBar);
+    }
+    else
+    {
+        waveformDisplay.setBeatGrid(0.0, 0.0, BeatAnalyzer::beatsPerBar);
+        beatAnalyzer->analyze(file, true);
+    }
 }
\ No newline at end of file
@@ -16,6 +16,7 @@
 #include "CoordinatePlot.h"
 #include "CustomLookAndFeel.h"
 #include "AudioProcessorClass.h"
+#include "BeatAnalyzer.h"
 
 //==============================================================================
 /*
@@ -61,12 +62,27 @@ public:
 
     void setDJAudioPlayer(DJAudioPlayer* playerInstance);
 
+    // Function: cloneFrom
+    // Purpose: Makes this deck an instant double of another: same track, position, speed and
+    //          trim, sharing its decoder and waveform instead of loading the file again.
+    void cloneFrom(DeckGUI& source);
+
+    /**Called when the DOUBLE button is clicked; the owner knows which deck to clone*/
+    std::function<void()> onDoubleRequested;
+
+    /**Draws the beat grids the analyzer finds on the waveform; call before loading*/
+    void setBeatAnalyzer(BeatAnalyzer* analyzer);
+    /**Shows the loaded track's beat grid if the analyzer knows it by now, or asks for it*/
+    void updateBeatGrid();
+
 private:
     int id;
     
     juce::TextButton playButton{ "PLAY" };
     juce::TextButton stopButton{ "STOP" };
     juce::TextButton loadButton{ "LOAD" };
+    juce::TextButton impulseResponseButton{ "IR" };
+    juce::TextButton doubleButton{ "DBL" };
     juce::Slider volSlider;
     juce::Label volLabel;
     juce::Slider speedSlider;
@@ -82,18 +98,28 @@ private:
     juce::Slider bandPassSlider;
     juce::Slider highPassSlider;
 
+    juce::Slider lowBandSlider;
+    juce::Slider midBandSlider;
+    juce::Slider highBandSlider;
+
     juce::ToggleButton lowPassButton;
     juce::ToggleButton bandPassButton;
     juce::ToggleButton highPassButton;
 
 
     void loadFile(juce::URL audioURL);
+    /**Describes the state of the deck's stream, empty when it plays a file*/
+    static juce::String getStreamStatusText(const StreamingAudioSource* stream);
 
     DJAudioPlayer* player;
     WaveformDisplay waveformDisplay;
+    BeatAnalyzer* beatAnalyzer = nullptr;
     juce::SharedResourcePointer< juce::TooltipWindow > sharedTooltip;
 
     friend class PlaylistComponent;
+    friend class AutoDJ;
+    friend class TimecodeControl;
+    friend class MidiControl;
 
     CustomLookAndFeel customLookAndFeel;
 
@@ -0,0 +1,224 @@
+/*
+  ==============================================================================
+    DeckTransport.cpp
+    Created: 19 Oct 2026 2:14:08pm
+  ==============================================================================
+*/
+
+#include "DeckTransport.h"
+
+DeckTransport::DeckTransport(double maximumRatioToUse)
+    : maximumRatio(maximumRatioToUse)
+{
+}
+
+DeckTransport::~DeckTransport()
+{
+    setSource(nullptr, 0.0, nullptr);
+}
+
+// Function: setSource
+// Purpose: Like the JUCE transport, prepares the new source if the transport is prepared and
+//          stops. Once the pointer is swapped, a block that starts reads the new source; the
+//          wait is only for blocks that started before.
+void DeckTransport::setSource(juce::PositionableAudioSource* newSource, double sourceSampleRate, ReadAheadAudioSource* readAhead)
+{
+    const juce::ScopedLock lock(preparationLock);
+
+    if (newSource != nullptr && preparedBlockSize > 0)
+        newSource->prepareToPlay(input.getNumSamples(), deviceRate.load());
+
+    playing = false;
+
+    if (sourceSampleRate > 0.0)
+        sourceRate = sourceSampleRate;
+
+    readAheadSource = readAhead;
+    auto* oldSource = source.exchange(newSource);
+    bufferedInput = 0;
+    ++seeks;
+
+    while (sourceUsers.load() > 0)
+        juce::Thread::yield();
+
+    if (oldSource != nullptr && oldSource != newSource && preparedBlockSize > 0)
+        oldSource->releaseResources();
+}
+
+double DeckTransport::getResamplingRatio() const noexcept
+{
+    return juce::jlimit(0.0001, maximumRatio, speed.load() * sourceRate.load() / deviceRate.load());
+}
+
+void DeckTransport::setPosition(double seconds)
+{
+    setNextReadPosition((juce::int64) (seconds * sourceRate.load()));
+}
+
+double DeckTransport::getLengthInSeconds() const
+{
+    return (double) getTotalLength() / sourceRate.load();
+}
+
+bool DeckTransport::isBuffered(juce::int64 start, int numSamples) const noexcept
+{
+    const SourceUse use(*this);
+    auto* readAhead = readAheadSource.load();
+    return readAhead == nullptr || readAhead->isBuffered(start, numSamples);
+}
+
+void DeckTransport::flush() noexcept
+{
+    inputStart = 0;
+    inputCount = 0;
+    bufferedInput = 0;
+
+    for (auto& interpolator : interpolators)
+        interpolator.reset();
+}
+
+size_t DeckTransport::getInputMemoryBytes() const noexcept
+{
+    return (size_t) (input.getNumChannels() * input.getNumSamples()) * sizeof(float);
+}
+
+void DeckTransport::prepareToPlay(int samplesPerBlockExpected, double sampleRate)
+{
+    const juce::ScopedLock lock(preparationLock);
+
+    deviceRate = sampleRate;
+    preparedBlockSize = juce::jmax(1, samplesPerBlockExpected);
+    input.setSize(numChannels, (int) std::ceil(preparedBlockSize * maximumRatio) + interpolationHeadroom);
+    flush();
+
+    if (auto* current = source.load())
+        current->prepareToPlay(input.getNumSamples(), sampleRate);
+}
+
+void DeckTransport::releaseResources()
+{
+    const juce::ScopedLock lock(preparationLock);
+
+    if (auto* current = source.load())
+        current->releaseResources();
+
+    preparedBlockSize = 0;
+    input.setSize(numChannels, 0);
+    flush();
+}
+
+// Function: getNextAudioBlock
+// Purpose: A stopped transport renders the block it was stopped in, faded out, and silence
+//          after it; like the JUCE transport it stops by itself at the end of the source.
+void DeckTransport::getNextAudioBlock(const juce::AudioSourceChannelInfo& bufferToFill)
+{
+    const SourceUse use(*this);
+    auto* current = source.load();
+    const bool shouldPlay = playing.load();
+    const auto seekCount = seeks.load();
+
+    if (seekCount != seenSeeks)
+    {
+        seenSeeks = seekCount;
+        flush();
+    }
+
+    if (current == nullptr || input.getNumSamples() == 0 || (!shouldPlay && !wasPlaying))
+    {
+        bufferToFill.clearActiveBufferRegion();
+        wasPlaying = false;
+        return;
+    }
+
+    resample(*current, bufferToFill, getResamplingRatio());
+
+    if (shouldPlay != wasPlaying)
+        for (int channel = 0; channel < bufferToFill.buffer->getNumChannels(); ++channel)
+            bufferToFill.buffer->applyGainRamp(channel, bufferToFill.startSample, bufferToFill.numSamples,
+                                               shouldPlay ? 0.0f : 1.0f, shouldPlay ? 1.0f : 0.0f);
+
+    wasPlaying = shouldPlay;
+
+    if (shouldPlay && !current->isLooping() && current->getNextReadPosition() - inputCount >= current->getTotalLength())
+    {
+        auto expected = true;
+        playing.compare_exchange_strong(expected, false);
+    }
+}
+
+// Function: resample
+// Purpose: Tops the input up to what the block needs at most, one source read per block, and
+//          interpolates each channel from it. The channels consume the same input, since they
+//          run at the same ratio from the same state; what is left stays for the next block.
+//          Only as many channels as the block has are read and interpolated, so a mono track
+//          handed a one-channel block costs one channel.
+void DeckTransport::resample(juce::PositionableAudioSource& current, const juce::AudioSourceChannelInfo& bufferToFill, double ratio) noexcept
+{
+    const int channels = juce::jmin(bufferToFill.buffer->getNumChannels(), numChannels);
+    const int needed = juce::jmin(input.getNumSamples(), (int) std::ceil(bufferToFill.numSamples * ratio) + 2);
+
+    // The input kept from the last block lacks the channels it wasn't asked for
+    if (channels != inputChannels)
+    {
+        flush();
+        inputChannels = channels;
+    }
+
+    if (inputCount < needed)
+    {
+        if (inputStart > 0)
+        {
+            for (int channel = 0; channel < channels; ++channel)
+                std::memmove(input.getWritePointer(channel), input.getReadPointer(channel, inputStart), (size_t) inputCount * sizeof(float));
+
+            inputStart = 0;
+        }
+
+        // A view of the channels needed, which refers to the input without allocating
+        juce::AudioBuffer<float> inputView(input.getArrayOfWritePointers(), channels, input.getNumSamples());
+        current.getNextAudioBlock(juce::AudioSourceChannelInfo(&inputView, inputCount, needed - inputCount));
+        inputCount = needed;
+    }
+
+    int used = 0;
+
+    for (int channel = 0; channel < channels; ++channel)
+        used = interpolators[channel].process(ratio, input.getReadPointer(channel, inputStart),
+                                              bufferToFill.buffer->getWritePointer(channel, bufferToFill.startSample),
+                                              bufferToFill.numSamples, inputCount, 0);
+
+    // A buffer with more channels than the input repeats its last one
+    for (int channel = channels; channel < bufferToFill.buffer->getNumChannels(); ++channel)
+        bufferToFill.buffer->copyFrom(channel, bufferToFill.startSample, *bufferToFill.buffer, channels - 1,
+                                      bufferToFill.startSample, bufferToFill.numSamples);
+
+    used = juce::jmin(used, inputCount);
+    inputStart += used;
+    inputCount -= used;
+    bufferedInput = inputCount;
+}
+
+void DeckTransport::setNextReadPosition(juce::int64 newPosition)
+{
+    const SourceUse use(*this);
+
+    if (auto* current = source.load())
+        current->setNextReadPosition(newPosition);
+
+    bufferedInput = 0;
+    ++seeks;
+}
+
+juce::int64 DeckTransport::getNextReadPosition() const
+{
+    const SourceUse use(*this);
+    auto* current = source.load();
+    return current != nullptr ? current->getNextReadPosition() - bufferedInput.load() : 0;
+}
+
+juce::int64 DeckTransport::getTotalLength() const
+{
+    const SourceUse use(*this);
+    auto* current = source.load();
+    return current != nullptr ? current->getTotalLength() : 0;
+}
@@ -0,0 +1,129 @@
+/*
+  ==============================================================================
+    DeckTransport.h
+    Created: 19 Oct 2026 2:14:08pm
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <atomic>
+#include "ReadAheadAudioSource.h"
+
+// Plays a deck's source at a variable speed, as a juce::AudioTransportSource feeding a
+// juce::ResamplingAudioSource did, without a lock anywhere the audio thread goes. Both of
+// those take a CriticalSection on every block and on every seek.
+//
+// Starting, stopping, the speed and seeks are atomics the next block picks up; a seek also
+// makes that block forget the input kept for interpolation. The source is swapped by the
+// message thread, which then waits for any block still reading the old one, so it is the
+// message thread that waits, never the audio thread. Positions count in source samples, and
+// the speed is corrected for the source's sample rate here.
+class DeckTransport : public juce::PositionableAudioSource
+{
+public:
+    // Extra source samples read beyond the scaled block for the interpolation
+    static constexpr int interpolationHeadroom = 32;
+
+    /**Plays at most maximumRatio source samples per output sample, counting the rate correction*/
+    explicit DeckTransport(double maximumRatio);
+    ~DeckTransport() override;
+
+    // Function: setSource
+    // Purpose: Plays a new source from its position, stopped. Message thread; returns once no
+    //          block reads the old source any more.
+    // Inputs:
+    // - juce::PositionableAudioSource* newSource: The source, or nullptr. The caller keeps it
+    //   alive until it has been replaced.
+    // - double sourceSampleRate: The rate the source plays at.
+    // - ReadAheadAudioSource* readAhead: newSource if it is a read-ahead source, else nullptr.
+    void setSource(juce::PositionableAudioSource* newSource, double sourceSampleRate, ReadAheadAudioSource* readAhead);
+
+    /**Starts playing, fading in over the next block; any thread*/
+    void start() noexcept { playing = true; }
+    /**Stops playing, fading out over the next block; any thread*/
+    void stop() noexcept { playing = false; }
+    /**Returns whether the transport plays; it stops by itself at the end of the source*/
+    bool isPlaying() const noexcept { return playing.load(); }
+
+    /**Sets the playback speed, 1 playing the source at its own rate; any thread*/
+    void setSpeed(double newSpeed) noexcept { speed = newSpeed; }
+    /**Returns the speed set*/
+    double getSpeed() const noexcept { return speed.load(); }
+    /**Returns the source samples played per output sample: the speed corrected for the sample rates, within the maximum*/
+    double getResamplingRatio() const noexcept;
+
+    /**Moves to a position in seconds; any thread*/
+    void setPosition(double seconds);
+    /**Returns the length of the source in seconds, 0 without one*/
+    double getLengthInSeconds() const;
+    /**Tells whether a range of the source is decoded already; a source that isn't a read-ahead source always is*/
+    bool isBuffered(juce::int64 start, int numSamples) const noexcept;
+    /**Forgets the input kept for interpolation; the thread rendering only*/
+    void flush() noexcept;
+    /**Returns the memory of the interpolation input, in bytes*/
+    size_t getInputMemoryBytes() const noexcept;
+
+    // Function: prepareToPlay
+    // Purpose: Sizes the interpolation input for blocks of up to samplesPerBlockExpected
+    //          output samples at the maximum ratio, so a block never has to grow it.
+    void prepareToPlay(int samplesPerBlockExpected, double sampleRate) override;
+    void releaseResources() override;
+    // Function: getNextAudioBlock
+    // Purpose: Interpolates the block from the source, fading in or out over it when the
+    //          transport was started or stopped since the last one. Never blocks.
+    void getNextAudioBlock(const juce::AudioSourceChannelInfo& bufferToFill) override;
+
+    /**Seeks the source; any thread, never blocks*/
+    void setNextReadPosition(juce::int64 newPosition) override;
+    /**Returns the source position of the sample played next; any thread*/
+    juce::int64 getNextReadPosition() const override;
+    juce::int64 getTotalLength() const override;
+    bool isLooping() const override { return false; }
+
+private:
+    // Counts a thread using the source, so setSource knows when the old one is free
+    class SourceUse
+    {
+    public:
+        explicit SourceUse(const DeckTransport& ownerToUse) noexcept : owner(ownerToUse) { ++owner.sourceUsers; }
+        ~SourceUse() noexcept { --owner.sourceUsers; }
+
+    private:
+        const DeckTransport& owner;
+    };
+
+    /**Interpolates the block from the source at the ratio*/
+    void resample(juce::PositionableAudioSource& current, const juce::AudioSourceChannelInfo& bufferToFill, double ratio) noexcept;
+
+    static constexpr int numChannels = 2;
+
+    const double maximumRatio;
+
+    std::atomic<juce::PositionableAudioSource*> source{ nullptr };
+    std::atomic<ReadAheadAudioSource*> readAheadSource{ nullptr };
+    mutable std::atomic<int> sourceUsers{ 0 };
+    std::atomic<double> sourceRate{ 44100.0 };
+    std::atomic<double> deviceRate{ 44100.0 };
+    std::atomic<double> speed{ 1.0 };
+    std::atomic<bool> playing{ false };
+    std::atomic<juce::uint32> seeks{ 0 };
+    // Source samples read but not played yet
+    std::atomic<int> bufferedInput{ 0 };
+
+    // Taken by setSource and prepareToPlay against each other, never by a block
+    juce::CriticalSection preparationLock;
+    int preparedBlockSize = 0;
+
+    // The thread rendering only
+    juce::AudioBuffer<float> input;
+    int inputStart = 0;
+    int inputCount = 0;
+    int inputChannels = numChannels;
+    juce::LagrangeInterpolator interpolators[numChannels];
+    juce::uint32 seenSeeks = 0;
+    bool wasPlaying = false;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(DeckTransport)
+};
@@ -0,0 +1,158 @@
+/*
+  ==============================================================================
+    DeviceSwitcher.cpp
+    Created: 19 Oct 2026 6:58:09am
+  ==============================================================================
+*/
+
+#include "DeviceSwitcher.h"
+#include "AsyncLogger.h"
+
+DeviceSwitcher::DeviceSwitcher(juce::AudioDeviceManager& manager)
+    : deviceManager(manager)
+{
+}
+
+DeviceSwitcher::~DeviceSwitcher()
+{
+    stopTimer();
+}
+
+// Function: setLatencyMode
+// Purpose: Looks up the sizes the device offers and switches to the one closest to the mode's.
+bool DeviceSwitcher::setLatencyMode(LatencyMode mode)
+{
+    auto* device = deviceManager.getCurrentAudioDevice();
+
+    if (device == nullptr)
+        return false;
+
+    const int wanted = mode == lowLatencyMode ? lowLatencyBlockSize : safeBlockSize;
+    int nearest = device->getCurrentBufferSizeSamples();
+
+    for (const int size : device->getAvailableBufferSizes())
+        if (std::abs(size - wanted) < std::abs(nearest - wanted))
+            nearest = size;
+
+    auto setup = deviceManager.getAudioDeviceSetup();
+
+    if (nearest == setup.bufferSize)
+        return false;
+
+    setup.bufferSize = nearest;
+    return switchTo(setup);
+}
+
+// Function: setSampleRate
+// Purpose: Looks up the rates the device offers and switches to the one closest to the rate.
+bool DeviceSwitcher::setSampleRate(double sampleRate)
+{
+    auto* device = deviceManager.getCurrentAudioDevice();
+
+    if (device == nullptr)
+        return false;
+
+    double nearest = device->getCurrentSampleRate();
+
+    for (const double rate : device->getAvailableSampleRates())
+        if (std::abs(rate - sampleRate) < std::abs(nearest - sampleRate))
+            nearest = rate;
+
+    auto setup = deviceManager.getAudioDeviceSetup();
+
+    if (nearest == setup.sampleRate)
+        return false;
+
+    setup.sampleRate = nearest;
+    return switchTo(setup);
+}
+
+// Function: switchTo
+// Purpose: Keeps the setup and starts the fade-out; the timer restarts the device after it.
+bool DeviceSwitcher::switchTo(const juce::AudioDeviceManager::AudioDeviceSetup& setup)
+{
+    int expected = idle;
+
+    if (!state.compare_exchange_strong(expected, fadingOut))
+        return false;
+
+    pendingSetup = setup;
+    switchStartTime = juce::Time::getMillisecondCounter();
+    startTimer(5);
+    return true;
+}
+
+void DeviceSwitcher::prepare(double sampleRate)
+{
+    fadeSamples = juce::jmax(1, juce::roundToInt(sampleRate * fadeSeconds));
+}
+
+// Function: processOutput
+// Purpose: Ramps the gain towards silence or back to unity. The fade picks up from whatever
+//          gain it reached, so a switch that starts while fading in doesn't click.
+void DeviceSwitcher::processOutput(juce::AudioBuffer<float>& buffer, int startSample, int numSamples) noexcept
+{
+    const int current = state.load();
+
+    if (current == idle)
+        return;
+
+    if (current == silent)
+    {
+        fadeGain = 0.0f;
+        buffer.clear(startSample, numSamples);
+        return;
+    }
+
+    const bool out = current == fadingOut;
+    const float step = 1.0f / (float) fadeSamples;
+    const int remaining = (int) std::ceil((out ? fadeGain : 1.0f - fadeGain) * (float) fadeSamples);
+    const int rampSamples = juce::jmin(numSamples, remaining);
+    const float endGain = juce::jlimit(0.0f, 1.0f, fadeGain + (out ? -step : step) * (float) rampSamples);
+
+    buffer.applyGainRamp(startSample, rampSamples, fadeGain, endGain);
+    fadeGain = endGain;
+
+    // The rest of a fading out block is silent, the rest of a fading in block plays as it is
+    if (out)
+        buffer.clear(startSample + rampSamples, numSamples - rampSamples);
+
+    if (rampSamples == remaining)
+    {
+        fadeGain = out ? 0.0f : 1.0f;
+        int expected = current;
+        state.compare_exchange_strong(expected, out ? (int) silent : (int) idle);
+    }
+}
+
+// Function: timerCallback
+// Purpose: Applies the setup once the output is silent. JUCE releases and prepares the chain
+//          inside setAudioDeviceSetup; a setup the device refuses is undone.
+void DeviceSwitcher::timerCallback()
+{
+    if (state.load() == fadingOut && juce::Time::getMillisecondCounter() - switchStartTime < maxFadeWaitMilliseconds)
+        return;
+
+    stopTimer();
+    state = silent;
+
+    const auto previousSetup = deviceManager.getAudioDeviceSetup();
+    const auto error = deviceManager.setAudioDeviceSetup(pendingSetup, true);
+
+    if (error.isNotEmpty())
+    {
+        juce::Logger::writeToLog("DeviceSwitcher: the device refused the new setup: " + error);
+        deviceManager.setAudioDeviceSetup(previousSetup, true);
+    }
+
+    const auto* device = deviceManager.getCurrentAudioDevice();
+
+    if (device != nullptr)
+        RT_LOG(info, "DeviceSwitcher restarted the device, block size and sample rate:",
+               device->getCurrentBufferSizeSamples(), device->getCurrentSampleRate());
+
+    state = fadingIn;
+
+    if (onSwitched)
+        onSwitched(error);
+}
@@ -0,0 +1,99 @@
+/*
+  ==============================================================================
+    DeviceSwitcher.h
+    Created: 19 Oct 2026 6:58:09am
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <atomic>
+#include <functional>
+
+// Changes the audio device's block size or sample rate while the decks play.
+//
+// JUCE restarts the device for any such change, which releases and prepares the whole chain.
+// The decks keep their tracks, positions, speeds and parameters through that, since every
+// parameter lives in an atomic target rather than in the stages. What the restart would
+// still do is cut the sound off and on mid-waveform, and the decks would run on while it
+// fades. So the output is faded out over a few milliseconds first, the decks aren't pulled
+// while it is silent, the device is restarted, and the output fades back in: one short gap.
+class DeviceSwitcher : private juce::Timer
+{
+public:
+    // Block sizes asked for by the two latency modes; the device's nearest size is used
+    enum LatencyMode
+    {
+        lowLatencyMode = 0,
+        safeMode
+    };
+
+    static constexpr int lowLatencyBlockSize = 128;
+    static constexpr int safeBlockSize = 1024;
+
+    explicit DeviceSwitcher(juce::AudioDeviceManager& manager);
+    ~DeviceSwitcher() override;
+
+    // Function: setLatencyMode
+    // Purpose: Switches to the device's block size nearest to the mode's, keeping the rate.
+    // Outputs: False if there is no device, the size is already in use or a switch is running.
+    bool setLatencyMode(LatencyMode mode);
+
+    // Function: setSampleRate
+    // Purpose: Switches to the device's sample rate nearest to the one asked for, keeping the
+    //          block size.
+    // Outputs: False if there is no device, the rate is already in use or a switch is running.
+    bool setSampleRate(double sampleRate);
+
+    // Function: switchTo
+    // Purpose: Fades the output out, applies a device setup and fades back in. Message thread.
+    // Outputs: False if a switch is already running.
+    bool switchTo(const juce::AudioDeviceManager::AudioDeviceSetup& setup);
+
+    /**Returns whether a switch is fading or waiting for the device*/
+    bool isSwitching() const noexcept { return state.load() != idle; }
+
+    /**Sets the fade length for the device's rate; call from prepareToPlay*/
+    void prepare(double sampleRate);
+
+    // Function: isSilent
+    // Purpose: True between the fade-out and the restart; the caller then outputs silence
+    //          without pulling the decks, so they don't move on. Audio thread.
+    bool isSilent() const noexcept { return state.load() == silent; }
+
+    // Function: processOutput
+    // Purpose: Applies the fade to the finished output block. Audio thread, allocation-free.
+    void processOutput(juce::AudioBuffer<float>& buffer, int startSample, int numSamples) noexcept;
+
+    /**Called on the message thread after a switch, with JUCE's error or an empty string*/
+    std::function<void(const juce::String& error)> onSwitched;
+
+private:
+    enum State
+    {
+        idle = 0,
+        fadingOut,
+        silent,
+        fadingIn
+    };
+
+    static constexpr double fadeSeconds = 0.01;
+    // A device that has stopped calling back never fades out; it is switched anyway
+    static constexpr juce::uint32 maxFadeWaitMilliseconds = 200;
+
+    /**Restarts the device once the output is silent*/
+    void timerCallback() override;
+
+    juce::AudioDeviceManager& deviceManager;
+    juce::AudioDeviceManager::AudioDeviceSetup pendingSetup;
+    juce::uint32 switchStartTime = 0;
+
+    std::atomic<int> state{ idle };
+
+    // Audio thread only
+    int fadeSamples = 441;
+    float fadeGain = 1.0f;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(DeviceSwitcher)
+};
@@ -0,0 +1,408 @@
+/*
+  ==============================================================================
+    FDNReverb.cpp
+    Created: 18 Oct 2026 5:03:52pm
+  ==============================================================================
+*/
+
+#include "FDNReverb.h"
+#include "BlockBenchmark.h"
+#include <iostream>
+
+namespace
+{
+    // Delay line lengths at 44.1 kHz. Mutually prime so the modes do not pile up.
+    constexpr int lineLengths44k[] = { 887, 1009, 1123, 1259, 1381, 1499, 1621, 1747 };
+
+    // Input diffuser lengths at 44.1 kHz
+    constexpr int diffuserLengths44k[] = { 142, 107, 379, 277 };
+    constexpr float diffuserGain = 0.6f;
+
+    // Average loop length the room size decay is referenced to, matching the comb
+    // filters of juce::Reverb so that a room size gives a similar tail length
+    constexpr float referenceLength44k = 1380.0f;
+
+    // Output tap gain that matches the wet level of juce::Reverb for the same settings
+    constexpr float outputLevel = 5.5f;
+
+    // Sign patterns for feeding the lines and for the two output taps. The taps are
+    // orthogonal to each other, which decorrelates the left and right outputs.
+    constexpr float inputPattern[] = { 1.0f, -1.0f, -1.0f, 1.0f, -1.0f, 1.0f, 1.0f, -1.0f };
+    constexpr float leftPattern[] = { 1.0f, -1.0f, 1.0f, -1.0f, 1.0f, -1.0f, 1.0f, -1.0f };
+    constexpr float rightPattern[] = { 1.0f, 1.0f, -1.0f, -1.0f, 1.0f, 1.0f, -1.0f, -1.0f };
+
+    const char* const benchmarkOption = "--benchmark-reverb";
+    // How many times faster than juce::Reverb the FDN has to be
+    const double minimumSpeedUp = 2.0;
+}
+
+// Constructor: Loads the tap patterns and prepares for a default sample rate
+FDNReverb::FDNReverb()
+{
+    alignas (Vector::SIMDRegisterSize) float lanes[Vector::SIMDNumElements] = {};
+
+    for (int v = 0; v < numVectors; ++v)
+    {
+        for (int lane = 0; lane < linesPerVector; ++lane)
+            lanes[lane] = inputPattern[v * linesPerVector + lane];
+        inputSigns[(size_t) v] = Vector::fromRawArray(lanes);
+
+        for (int lane = 0; lane < linesPerVector; ++lane)
+            lanes[lane] = leftPattern[v * linesPerVector + lane] * outputLevel;
+        leftTaps[(size_t) v] = Vector::fromRawArray(lanes);
+
+        for (int lane = 0; lane < linesPerVector; ++lane)
+            lanes[lane] = rightPattern[v * linesPerVector + lane] * outputLevel;
+        rightTaps[(size_t) v] = Vector::fromRawArray(lanes);
+    }
+
+    prepare(currentSampleRate);
+}
+
+// Function: prepare
+// Purpose: Sizes the delay lines and diffusers for the sample rate and clears them.
+// Inputs:
+//   sampleRate - The sample rate of the audio that will be processed.
+void FDNReverb::prepare(double sampleRate)
+{
+    currentSampleRate = sampleRate;
+    const double scale = sampleRate / 44100.0;
+
+    for (int i = 0; i < numLines; ++i)
+    {
+        delayLengths[(size_t) i] = juce::jmax(1, juce::roundToInt(lineLengths44k[i] * scale));
+        delayLines[(size_t) i].assign((size_t) delayLengths[(size_t) i], 0.0f);
+    }
+
+    for (size_t i = 0; i < diffusers.size(); ++i)
+        diffusers[i].buffer.assign((size_t) juce::jmax(1, juce::roundToInt(diffuserLengths44k[i] * scale)), 0.0f);
+
+    // Same ramp time juce::Reverb uses for its parameters
+    for (auto* smoothed : { &roomSize, &damping, &wetGain1, &wetGain2, &dryGain })
+        smoothed->reset(sampleRate, 0.01);
+
+    parametersChanged = true;
+    lastFeedback = -1.0f;
+    updateParameters(0);
+
+    for (auto* smoothed : { &roomSize, &damping, &wetGain1, &wetGain2, &dryGain })
+        smoothed->setCurrentAndTargetValue(smoothed->getTargetValue());
+
+    reset();
+}
+
+// Function: reset
+// Purpose: Silences the network without changing the parameters.
+void FDNReverb::reset()
+{
+    for (auto& line : delayLines)
+        std::fill(line.begin(), line.end(), 0.0f);
+
+    for (auto& diffuser : diffusers)
+    {
+        std::fill(diffuser.buffer.begin(), diffuser.buffer.end(), 0.0f);
+        diffuser.index = 0;
+    }
+
+    for (auto& state : dampingState)
+        state = Vector::expand(0.0f);
+
+    lineIndices.fill(0);
+}
+
+// Function: setParameters
+// Purpose: Hands new parameters to the audio thread.
+// Inputs:
+//   newParameters - The new reverb settings.
+void FDNReverb::setParameters(const juce::Reverb::Parameters& newParameters)
+{
+    const juce::SpinLock::ScopedLockType lock(parameterLock);
+    pendingParameters = newParameters;
+    parametersChanged = true;
+}
+
+// Function: getParameters
+// Purpose: Returns the most recently set parameters.
+juce::Reverb::Parameters FDNReverb::getParameters() const
+{
+    const juce::SpinLock::ScopedLockType lock(parameterLock);
+    return pendingParameters;
+}
+
+// Function: updateParameters
+// Purpose: Picks up new parameters without ever waiting for the message thread, and
+//          advances the decay and damping ramps by one block.
+// Inputs:
+//   numSamples - The length of the block about to be processed.
+void FDNReverb::updateParameters(int numSamples) noexcept
+{
+    if (parametersChanged.load())
+    {
+        // If the message thread holds the lock the change is picked up next block
+        const juce::SpinLock::ScopedTryLockType lock(parameterLock);
+
+        if (lock.isLocked())
+        {
+            activeParameters = pendingParameters;
+            parametersChanged = false;
+
+            // In freeze mode the network stops taking input and stops losing energy
+            const bool frozen = activeParameters.freezeMode >= 0.5f;
+            const float wet = activeParameters.wetLevel * wetScaleFactor;
+            const float width = activeParameters.width;
+
+            roomSize.setTargetValue(activeParameters.roomSize);
+            damping.setTargetValue(frozen ? 0.0f : activeParameters.damping);
+            wetGain1.setTargetValue(0.5f * wet * (1.0f + width));
+            wetGain2.setTargetValue(0.5f * wet * (1.0f - width));
+            dryGain.setTargetValue(activeParameters.dryLevel * dryScaleFactor);
+            inputGain = frozen ? 0.0f : 0.015f;
+        }
+    }
+
+    // Decay and damping are updated once per block, the output gains per sample
+    const float currentRoomSize = roomSize.skip(numSamples);
+    const float currentDamping = damping.skip(numSamples);
+
+    const bool frozen = activeParameters.freezeMode >= 0.5f;
+    const float feedback = frozen ? 1.0f : currentRoomSize * 0.28f + 0.7f;
+    const float referenceLength = referenceLength44k * (float) (currentSampleRate / 44100.0);
+
+    if (feedback == lastFeedback)
+    {
+        dampingCoefficient = Vector::expand(currentDamping * 0.4f);
+        return;
+    }
+
+    lastFeedback = feedback;
+    alignas (Vector::SIMDRegisterSize) float lanes[Vector::SIMDNumElements] = {};
+
+    for (int v = 0; v < numVectors; ++v)
+    {
+        // Every line decays at the same rate per second, whatever its length
+        for (int lane = 0; lane < linesPerVector; ++lane)
+            lanes[lane] = std::pow(feedback, (float) delayLengths[(size_t) (v * linesPerVector + lane)] / referenceLength);
+
+        lineGains[(size_t) v] = Vector::fromRawArray(lanes);
+    }
+
+    dampingCoefficient = Vector::expand(currentDamping * 0.4f);
+}
+
+// Function: tick
+// Purpose: Diffuses the input, reads every line, damps and scales the outputs, mixes them
+//          through the Householder matrix and writes them back together with the input.
+// Inputs:
+//   input - The mono input sample.
+// Outputs:
+//   wetLeft, wetRight - The left and right reverb outputs.
+void FDNReverb::tick(float input, float& wetLeft, float& wetRight) noexcept
+{
+    // Input allpass diffusion
+    for (auto& diffuser : diffusers)
+    {
+        auto& delayed = diffuser.buffer[(size_t) diffuser.index];
+        const float output = delayed - diffuserGain * input;
+        delayed = input + diffuserGain * output;
+        input = output;
+
+        if (++diffuser.index >= (int) diffuser.buffer.size())
+            diffuser.index = 0;
+    }
+
+    alignas (Vector::SIMDRegisterSize) float lines[numLines];
+
+    // Every line is read at its own position, so this part stays scalar
+    for (int i = 0; i < numLines; ++i)
+        lines[i] = delayLines[(size_t) i][(size_t) lineIndices[(size_t) i]];
+
+    std::array<Vector, numVectors> outputs;
+    Vector left = Vector::expand(0.0f);
+    Vector right = Vector::expand(0.0f);
+    float sum = 0.0f;
+
+    const auto oneMinusDamping = Vector::expand(1.0f) - dampingCoefficient;
+
+    for (int v = 0; v < numVectors; ++v)
+    {
+        const auto delayed = Vector::fromRawArray(lines + v * linesPerVector);
+        left += delayed * leftTaps[(size_t) v];
+        right += delayed * rightTaps[(size_t) v];
+
+        // One pole low pass in the loop, as in the comb filters of juce::Reverb
+        auto& state = dampingState[(size_t) v];
+        state = delayed * oneMinusDamping + state * dampingCoefficient;
+
+        outputs[(size_t) v] = state * lineGains[(size_t) v];
+        sum += outputs[(size_t) v].sum();
+    }
+
+    // Householder feedback: y = x - (2 / N) * sum(x)
+    const auto reflection = Vector::expand(sum * (2.0f / (float) numLines));
+    const auto injected = Vector::expand(input * inputGain);
+
+    for (int v = 0; v < numVectors; ++v)
+        (outputs[(size_t) v] - reflection + injected * inputSigns[(size_t) v]).copyToRawArray(lines + v * linesPerVector);
+
+    for (int i = 0; i < numLines; ++i)
+    {
+        auto& index = lineIndices[(size_t) i];
+        delayLines[(size_t) i][(size_t) index] = lines[i];
+
+        if (++index >= delayLengths[(size_t) i])
+            index = 0;
+    }
+
+    wetLeft = left.sum();
+    wetRight = right.sum();
+}
+
+// Function: processStereo
+// Purpose: Adds the reverb to a stereo signal in place.
+// Inputs:
+//   left, right - The channel data.
+//   numSamples - The number of samples per channel.
+void FDNReverb::processStereo(float* left, float* right, int numSamples) noexcept
+{
+    updateParameters(numSamples);
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        float wetLeft, wetRight;
+        tick(left[i] + right[i], wetLeft, wetRight);
+
+        const float wet1 = wetGain1.getNextValue();
+        const float wet2 = wetGain2.getNextValue();
+        const float dry = dryGain.getNextValue();
+
+        left[i] = wetLeft * wet1 + wetRight * wet2 + left[i] * dry;
+        right[i] = wetRight * wet1 + wetLeft * wet2 + right[i] * dry;
+    }
+}
+
+// Function: processMono
+// Purpose: Adds the reverb to a mono signal in place.
+// Inputs:
+//   samples - The channel data.
+//   numSamples - The number of samples.
+void FDNReverb::processMono(float* samples, int numSamples) noexcept
+{
+    updateParameters(numSamples);
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        float wetLeft, wetRight;
+        tick(samples[i], wetLeft, wetRight);
+
+        const float wet1 = wetGain1.getNextValue();
+        wetGain2.getNextValue();
+        const float dry = dryGain.getNextValue();
+
+        samples[i] = wetLeft * wet1 + samples[i] * dry;
+    }
+}
+
+bool FDNReverb::isBenchmark(const juce::StringArray& arguments)
+{
+    return arguments.size() >= 1 && arguments[0] == benchmarkOption;
+}
+
+// Function: runBenchmark
+// Purpose: Both reverbs get the default juce::Reverb parameters. The block size matters
+//          because the FDN reads its parameters and sets up its ramps once per block. No
+//          audio device is opened, so the numbers don't depend on which one is plugged in.
+int FDNReverb::runBenchmark(const juce::StringArray& arguments)
+{
+    const int blockSize = BlockBenchmark::getBlockSize(arguments, 512);
+    const double sampleRate = 48000.0;
+    const BlockBenchmark benchmark(blockSize, sampleRate);
+    juce::AudioBuffer<float> buffer(2, blockSize);
+    const juce::Reverb::Parameters parameters;
+
+    FDNReverb fdn;
+    fdn.prepare(sampleRate);
+    fdn.setParameters(parameters);
+
+    juce::Reverb reverb;
+    reverb.setSampleRate(sampleRate);
+    reverb.setParameters(parameters);
+
+    float* const left = buffer.getWritePointer(0);
+    float* const right = buffer.getWritePointer(1);
+
+    const double fdnSeconds = benchmark.time(buffer, [&] { fdn.processStereo(left, right, blockSize); });
+    const double reverbSeconds = benchmark.time(buffer, [&] { reverb.processStereo(left, right, blockSize); });
+
+    benchmark.printHeader();
+    benchmark.printResult("FDN reverb", fdnSeconds);
+    benchmark.printResult("juce::Reverb", reverbSeconds);
+    std::cout << "FDN speed-up " << reverbSeconds / fdnSeconds << "x\n";
+
+    if (reverbSeconds < minimumSpeedUp * fdnSeconds)
+    {
+        std::cout << "the FDN is less than " << minimumSpeedUp << "x faster than juce::Reverb\n";
+        return 2;
+    }
+
+    return 0;
+}
+
+//==============================================================================
+// Constructor: Wraps an input source, optionally taking ownership of it
+FDNReverbAudioSource::FDNReverbAudioSource(juce::AudioSource* inputSource, bool deleteInputWhenDeleted)
+    : input(inputSource, deleteInputWhenDeleted)
+{
+    jassert(inputSource != nullptr);
+}
+
+void FDNReverbAudioSource::prepareToPlay(int samplesPerBlockExpected, double sampleRate)
+{
+    juce::ignoreUnused(samplesPerBlockExpected);
+    reverb.prepare(sampleRate);
+}
+
+void FDNReverbAudioSource::releaseResources()
+{
+}
+
+void FDNReverbAudioSource::getNextAudioBlock(const juce::AudioSourceChannelInfo& bufferToFill)
+{
+    input->getNextAudioBlock(bufferToFill);
+    processBlock(bufferToFill);
+}
+
+// Function: processBlock
+// Purpose: Runs the reverb over a block in place.
+void FDNReverbAudioSource::processBlock(const juce::AudioSourceChannelInfo& bufferToFill)
+{
+    if (bypass.load())
+        return;
+
+    // Coming back from bypass starts without the old tail, cleared here on the audio thread
+    if (resetPending.exchange(false))
+        reverb.reset();
+
+    auto& buffer = *bufferToFill.buffer;
+
+    if (buffer.getNumChannels() > 1)
+    {
+        reverb.processStereo(buffer.getWritePointer(0, bufferToFill.startSample),
+                             buffer.getWritePointer(1, bufferToFill.startSample),
+                             bufferToFill.numSamples);
+    }
+    else if (buffer.getNumChannels() == 1)
+    {
+        reverb.processMono(buffer.getWritePointer(0, bufferToFill.startSample), bufferToFill.numSamples);
+    }
+}
+
+void FDNReverbAudioSource::setParameters(const juce::Reverb::Parameters& newParameters)
+{
+    reverb.setParameters(newParameters);
+}
+
+void FDNReverbAudioSource::setBypassed(bool shouldBeBypassed) noexcept
+{
+    if (bypass.exchange(shouldBeBypassed) != shouldBeBypassed && !shouldBeBypassed)
+        resetPending = true;
+}
@@ -0,0 +1,127 @@
+/*
+  ==============================================================================
+    IsolatorEQ.h
+    Created: 18 Oct 2026 2:41:05pm
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <array>
+
+// A DJ-style three band isolator. The signal is split into low, mid and high bands with
+// 4th order Linkwitz-Riley crossovers and every band gets its own gain, down to a full kill.
+// With all gains at 1 the bands sum back to an allpass, so the magnitude response is flat.
+//
+// The crossover is rearranged so that all filters fit into three 4-lane SIMD biquads:
+//   hp   = AP1(x) - LP1(LP1(x))              (LR4 high pass of the first crossover)
+//   out  = AP2(gLow * low + gHigh * hp) + (gMid - gHigh) * LP2(LP2(hp))
+// where AP is the allpass that an LR4 low and high pass pair sum to. The lanes carry the
+// left and right channel of two parallel paths. The second LP2 section is pipelined by one
+// sample to share a register with LP1, so the stage has a latency of one sample.
+//
+// A deck runs the isolator after its filter section, not instead of it: the section is the
+// deck's low, band and high pass controls, which the isolator's bands don't replace. So the
+// isolator's three sections add to the deck's cost; --benchmark-isolator measures by how
+// much, and checks that the isolator alone costs less than the section.
+class IsolatorEQ
+{
+public:
+    // The bands of the isolator
+    enum Band
+    {
+        lowBand = 0,
+        midBand,
+        highBand,
+        numBands
+    };
+
+    // Constructor: All bands at unity gain, crossovers at 250 Hz and 2.5 kHz
+    IsolatorEQ();
+
+    // Function: prepare
+    // Purpose: Computes the crossover filters for the sample rate and clears the state.
+    // Inputs:
+    // - double sampleRate: The sample rate of the audio that will be processed.
+    void prepare(double sampleRate);
+
+    // Function: reset
+    // Purpose: Clears the filter state and snaps the band gains to their targets.
+    void reset();
+
+    // Function: setCrossoverFrequencies
+    // Purpose: Sets the low/mid and mid/high split points. Takes effect on the next prepare.
+    // Inputs:
+    // - float lowMid: The low/mid crossover in Hz.
+    // - float midHigh: The mid/high crossover in Hz.
+    void setCrossoverFrequencies(float lowMid, float midHigh);
+
+    // Function: setBandGain
+    // Purpose: Sets the target gain of one band. The gain is ramped over 20 ms.
+    // Inputs:
+    // - Band band: The band to change.
+    // - float gain: The linear gain, 0 for a kill.
+    void setBandGain(Band band, float gain);
+
+    // Function: process
+    // Purpose: Runs the isolator in place over one or two channels in a single pass.
+    // Inputs:
+    // - float* left: The first channel.
+    // - float* right: The second channel, or nullptr for mono material.
+    // - int numSamples: The number of samples in each channel.
+    void process(float* left, float* right, int numSamples) noexcept;
+
+    // Function: runBenchmark
+    // Purpose: Times the isolator, the deck filter section, and both in a row as a deck runs
+    //          them, on the same stereo noise, and prints the times to the standard output.
+    // Inputs:
+    // - const juce::StringArray& arguments: --benchmark-isolator and optionally the block size.
+    // Outputs: 0 if the isolator alone is cheaper than the filter section, 2 if not.
+    static int runBenchmark(const juce::StringArray& arguments);
+
+    // Function: isBenchmark
+    // Purpose: Tells whether the app was started to benchmark the isolator.
+    // Inputs:
+    // - const juce::StringArray& arguments: The command line arguments.
+    // Outputs: true if the first argument is --benchmark-isolator.
+    static bool isBenchmark(const juce::StringArray& arguments);
+
+private:
+    using Vector = juce::dsp::SIMDRegister<float>;
+    static_assert (Vector::SIMDNumElements >= 4, "IsolatorEQ needs at least four SIMD lanes");
+
+    // Transposed direct form II biquad with separate coefficients per lane
+    struct Biquad
+    {
+        Vector b0, b1, b2, a1, a2;
+        Vector s1, s2;
+
+        Vector tick(Vector x) noexcept
+        {
+            auto y = b0 * x + s1;
+            s1 = b1 * x - a1 * y + s2;
+            s2 = b2 * x - a2 * y;
+            return y;
+        }
+    };
+
+    // Loads coefficients for lanes 0-1 and lanes 2-3 of a section
+    static void setLanes(Biquad& biquad, const std::array<float, 6>& lanes01, const std::array<float, 6>& lanes23);
+
+    Biquad lowPassOrAllPass;   // LP1 on lanes 0-1, AP1 on lanes 2-3
+    Biquad lowPassPipelined;   // LP1 on lanes 0-1, LP2 (one sample behind) on lanes 2-3
+    Biquad allPassOrLowPass;   // AP2 on lanes 0-1, LP2 on lanes 2-3
+
+    // Values carried between samples by the pipelined section
+    float pendingLowPass[2] = {};
+    float pendingAllPass[2] = {};
+
+    std::array<juce::SmoothedValue<float, juce::ValueSmoothingTypes::Linear>, numBands> bandGains;
+
+    float lowMidFrequency = 250.0f;
+    float midHighFrequency = 2500.0f;
+    double currentSampleRate = 44100.0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(IsolatorEQ)
+};
@@ -0,0 +1,443 @@
+/*
+  ==============================================================================
+    LoudnessAnalyzer.cpp
+    Created: 19 Oct 2026 5:48:16am
+  ==============================================================================
+*/
+
+#include "LoudnessAnalyzer.h"
+#include "AsyncLogger.h"
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+    // One biquad in transposed direct form II, in double precision for the low shelf's poles
+    struct Biquad
+    {
+        double b0 = 1.0, b1 = 0.0, b2 = 0.0, a1 = 0.0, a2 = 0.0;
+        double s1 = 0.0, s2 = 0.0;
+
+        double process(double x) noexcept
+        {
+            const double y = b0 * x + s1;
+            s1 = b1 * x - a1 * y + s2;
+            s2 = b2 * x - a2 * y;
+            return y;
+        }
+    };
+
+    // The two K-weighting stages of BS.1770, a high shelf and a high pass, for any sample rate
+    void makeKWeighting(double sampleRate, Biquad& shelf, Biquad& highPass)
+    {
+        {
+            const double f0 = 1681.974450955533, gainDecibels = 3.999843853973347, q = 0.7071752369554196;
+            const double k = std::tan(juce::MathConstants<double>::pi * f0 / sampleRate);
+            const double vh = std::pow(10.0, gainDecibels / 20.0);
+            const double vb = std::pow(vh, 0.4996667741545416);
+            const double a0 = 1.0 + k / q + k * k;
+
+            shelf.b0 = (vh + vb * k / q + k * k) / a0;
+            shelf.b1 = 2.0 * (k * k - vh) / a0;
+            shelf.b2 = (vh - vb * k / q + k * k) / a0;
+            shelf.a1 = 2.0 * (k * k - 1.0) / a0;
+            shelf.a2 = (1.0 - k / q + k * k) / a0;
+        }
+
+        {
+            const double f0 = 38.13547087602444, q = 0.5003270373238773;
+            const double k = std::tan(juce::MathConstants<double>::pi * f0 / sampleRate);
+            const double a0 = 1.0 + k / q + k * k;
+
+            highPass.b0 = 1.0;
+            highPass.b1 = -2.0;
+            highPass.b2 = 1.0;
+            highPass.a1 = 2.0 * (k * k - 1.0) / a0;
+            highPass.a2 = (1.0 - k / q + k * k) / a0;
+        }
+    }
+
+    constexpr int oversampling = 4;
+    constexpr int tapsPerPhase = 12;
+
+    double toLoudness(double meanSquare) { return -0.691 + 10.0 * std::log10(meanSquare); }
+}
+
+//==============================================================================
+// Function: FileMeasurement
+// Purpose: Filters every channel with the K-weighting and sums their mean squares in 100 ms
+//          steps as the blocks come in; four steps make a gating block. The true peak comes
+//          from a windowed-sinc interpolator with four phases of twelve taps, next to the plain
+//          sample peak. Without an owner it only keeps the result, for measure.
+class LoudnessAnalyzer::FileMeasurement : public TrackAnalysisPool::Measurement
+{
+public:
+    FileMeasurement(LoudnessAnalyzer* ownerToUse, const juce::File& fileToUse, const juce::AudioFormatReader& reader)
+        : owner(ownerToUse),
+          file(fileToUse),
+          numChannels(juce::jmin((int) reader.numChannels, 8)),
+          stepLength(juce::jmax(1, juce::roundToInt(reader.sampleRate * 0.1)))
+    {
+        for (int channel = 0; channel < numChannels; ++channel)
+            makeKWeighting(reader.sampleRate, shelves[channel], highPasses[channel]);
+
+        // Phase p of the interpolator holds taps p, p + 4, p + 8 ... of the prototype filter
+        const double centre = (oversampling * tapsPerPhase - 1) / 2.0;
+
+        for (int tap = 0; tap < oversampling * tapsPerPhase; ++tap)
+        {
+            const double x = (tap - centre) / oversampling;
+            const double sinc = x == 0.0 ? 1.0 : std::sin(juce::MathConstants<double>::pi * x) / (juce::MathConstants<double>::pi * x);
+            const double window = 0.5 - 0.5 * std::cos(juce::MathConstants<double>::twoPi * (tap + 0.5) / (oversampling * tapsPerPhase));
+            taps[tap % oversampling][tap / oversampling] = sinc * window;
+        }
+
+        stepEnergies.reserve((size_t) (reader.lengthInSamples / stepLength + 1));
+    }
+
+    void addBlock(const juce::AudioBuffer<float>& buffer, int numSamples) override
+    {
+        for (int i = 0; i < numSamples; ++i)
+        {
+            historyIndex = (historyIndex + tapsPerPhase - 1) % tapsPerPhase;
+
+            for (int channel = 0; channel < numChannels; ++channel)
+            {
+                const double x = buffer.getSample(channel, i);
+                const double weighted = highPasses[channel].process(shelves[channel].process(x));
+                stepSum += weighted * weighted;
+
+                auto& channelHistory = history[channel];
+                channelHistory[historyIndex] = x;
+                peak = juce::jmax(peak, std::abs(x));
+
+                for (int phase = 0; phase < oversampling; ++phase)
+                {
+                    double interpolated = 0.0;
+
+                    for (int tap = 0; tap < tapsPerPhase; ++tap)
+                        interpolated += taps[phase][tap] * channelHistory[(historyIndex + tap) % tapsPerPhase];
+
+                    peak = juce::jmax(peak, std::abs(interpolated));
+                }
+            }
+
+            if (++stepCount == stepLength)
+            {
+                stepEnergies.push_back(stepSum / stepLength);
+                stepSum = 0.0;
+                stepCount = 0;
+            }
+        }
+    }
+
+    void finish(bool complete) override
+    {
+        if (complete)
+            computeResult();
+
+        if (owner != nullptr)
+            owner->finishFile(file, complete ? &result : nullptr);
+    }
+
+    Result result;
+
+private:
+    // Gating blocks of 400 ms, one every 100 ms
+    void computeResult()
+    {
+        std::vector<double> blocks;
+
+        for (size_t step = 3; step < stepEnergies.size(); ++step)
+            blocks.push_back((stepEnergies[step - 3] + stepEnergies[step - 2] + stepEnergies[step - 1] + stepEnergies[step]) / 4.0);
+
+        const double absoluteGate = std::pow(10.0, (-70.0 + 0.691) / 10.0);
+        double sum = 0.0;
+        int count = 0;
+
+        for (auto block : blocks)
+        {
+            if (block > absoluteGate)
+            {
+                sum += block;
+                ++count;
+            }
+        }
+
+        result.truePeak = juce::Decibels::gainToDecibels(peak, -200.0);
+        result.hasAudio = count > 0;
+        result.integratedLoudness = -70.0;
+
+        if (!result.hasAudio)
+            return;
+
+        const double relativeGate = sum / count * std::pow(10.0, -10.0 / 10.0);
+        double gatedSum = 0.0;
+        int gatedCount = 0;
+
+        for (auto block : blocks)
+        {
+            if (block > absoluteGate && block > relativeGate)
+            {
+                gatedSum += block;
+                ++gatedCount;
+            }
+        }
+
+        result.integratedLoudness = toLoudness(gatedSum / gatedCount);
+    }
+
+    LoudnessAnalyzer* owner;
+    const juce::File file;
+    const int numChannels;
+
+    Biquad shelves[8], highPasses[8];
+    double taps[oversampling][tapsPerPhase];
+    double history[8][tapsPerPhase] = {};
+    int historyIndex = 0;
+    double peak = 0.0;
+
+    const int stepLength;
+    std::vector<double> stepEnergies;
+    double stepSum = 0.0;
+    int stepCount = 0;
+};
+
+//==============================================================================
+LoudnessAnalyzer::LoudnessAnalyzer(TrackAnalysisPool& poolToUse)
+    : pool(poolToUse)
+{
+    loadCache();
+    pool.addAnalysis(*this);
+}
+
+LoudnessAnalyzer::~LoudnessAnalyzer()
+{
+    pool.removeAnalysis(*this);
+    cancelPendingUpdate();
+    saveCache();
+}
+
+void LoudnessAnalyzer::analyze(const juce::File& file, bool urgently)
+{
+    Result result;
+
+    if (getResult(file, result))
+        return;
+
+    {
+        const juce::ScopedLock scopedLock(lock);
+        const auto path = file.getFullPathName();
+
+        if (queuedPaths.contains(path))
+        {
+            // Still waiting: move it to the front. A file being analyzed is not in pending.
+            for (auto it = pending.begin(); urgently && it != pending.end(); ++it)
+            {
+                if (*it == file)
+                {
+                    if (it - pending.begin() >= numUrgent)
+                        ++numUrgent;
+
+                    pending.erase(it);
+                    pending.push_front(file);
+                    break;
+                }
+            }
+
+            return;
+        }
+
+        queuedPaths.add(path);
+
+        if (urgently)
+        {
+            pending.push_front(file);
+            ++numUrgent;
+        }
+        else
+        {
+            pending.push_back(file);
+        }
+    }
+
+    pool.fileQueued();
+}
+
+bool LoudnessAnalyzer::getResult(const juce::File& file, Result& result) const
+{
+    return getResult(file, file.getSize(), file.getLastModificationTime().toMilliseconds(), result);
+}
+
+bool LoudnessAnalyzer::getResult(const juce::File& file, juce::int64 size, juce::int64 modified, Result& result) const
+{
+    const juce::ScopedLock scopedLock(lock);
+    const auto entry = cache.find(file.getFullPathName());
+
+    if (entry == cache.end() || entry->second.size != size || entry->second.modified != modified)
+        return false;
+
+    result = entry->second.result;
+    return true;
+}
+
+// Function: getNormalizationGain
+// Purpose: A quiet track is only raised as far as its true peak allows; a loud one is always
+//          brought down.
+double LoudnessAnalyzer::getNormalizationGain(const Result& result)
+{
+    if (!result.hasAudio)
+        return 1.0;
+
+    double trimDecibels = targetLoudness - result.integratedLoudness;
+    trimDecibels = juce::jmin(trimDecibels, juce::jmax(0.0, truePeakCeiling - result.truePeak));
+    trimDecibels = juce::jlimit(-maxTrimDecibels, maxTrimDecibels, trimDecibels);
+
+    return juce::Decibels::decibelsToGain(trimDecibels);
+}
+
+// Function: measure
+// Purpose: Feeds the whole file to a measurement of its own.
+bool LoudnessAnalyzer::measure(juce::AudioFormatReader& reader, Result& result, const std::function<bool()>& shouldExit)
+{
+    if (reader.numChannels <= 0 || reader.sampleRate <= 0.0)
+        return false;
+
+    FileMeasurement measurement(nullptr, {}, reader);
+
+    if (!TrackAnalysisPool::decode(reader, { &measurement }, shouldExit))
+        return false;
+
+    measurement.finish(true);
+    result = measurement.result;
+    return true;
+}
+
+bool LoudnessAnalyzer::takeNextFile(juce::File& file, bool urgentOnly)
+{
+    const juce::ScopedLock scopedLock(lock);
+
+    if (pending.empty() || (urgentOnly && numUrgent == 0))
+        return false;
+
+    file = pending.front();
+    pending.pop_front();
+    numUrgent = juce::jmax(0, numUrgent - 1);
+    return true;
+}
+
+bool LoudnessAnalyzer::takeFile(const juce::File& file)
+{
+    const juce::ScopedLock scopedLock(lock);
+    const auto it = std::find(pending.begin(), pending.end(), file);
+
+    if (it == pending.end())
+        return false;
+
+    if (it - pending.begin() < numUrgent)
+        --numUrgent;
+
+    pending.erase(it);
+    return true;
+}
+
+std::unique_ptr<TrackAnalysisPool::Measurement> LoudnessAnalyzer::startMeasurement(const juce::File& file, const juce::AudioFormatReader& reader)
+{
+    if (reader.numChannels <= 0 || reader.sampleRate <= 0.0)
+    {
+        finishFile(file, nullptr);
+        return nullptr;
+    }
+
+    return std::make_unique<FileMeasurement>(this, file, reader);
+}
+
+void LoudnessAnalyzer::skipFile(const juce::File& file)
+{
+    finishFile(file, nullptr);
+}
+
+// Stores a measured result, or only forgets the file if it couldn't be read
+void LoudnessAnalyzer::finishFile(const juce::File& file, const Result* result)
+{
+    {
+        const juce::ScopedLock scopedLock(lock);
+        queuedPaths.removeString(file.getFullPathName());
+
+        if (result == nullptr)
+            return;
+
+        cache[file.getFullPathName()] = { file.getSize(), file.getLastModificationTime().toMilliseconds(), *result };
+        finished.add(file);
+    }
+
+    triggerAsyncUpdate();
+}
+
+// Saves the cache once per batch of finished files and tells the owner about each file
+void LoudnessAnalyzer::handleAsyncUpdate()
+{
+    juce::Array<juce::File> files;
+
+    {
+        const juce::ScopedLock scopedLock(lock);
+        files.swapWith(finished);
+    }
+
+    saveCache();
+    RT_LOG(debug, "LoudnessAnalyzer files analyzed:", files.size());
+
+    if (onAnalyzed)
+        for (auto& file : files)
+            onAnalyzed(file);
+}
+
+juce::File LoudnessAnalyzer::getCacheFile() const
+{
+    return juce::File::getSpecialLocation(juce::File::userApplicationDataDirectory)
+        .getChildFile("OtoDecks").getChildFile("Loudness.xml");
+}
+
+void LoudnessAnalyzer::loadCache()
+{
+    auto xml = juce::parseXML(getCacheFile());
+
+    if (xml == nullptr)
+        return;
+
+    const juce::ScopedLock scopedLock(lock);
+
+    for (auto* element : xml->getChildWithTagNameIterator("TRACK"))
+    {
+        CacheEntry entry;
+        entry.size = element->getStringAttribute("size").getLargeIntValue();
+        entry.modified = element->getStringAttribute("modified").getLargeIntValue();
+        entry.result.integratedLoudness = element->getDoubleAttribute("loudness");
+        entry.result.truePeak = element->getDoubleAttribute("truePeak");
+        entry.result.hasAudio = element->getBoolAttribute("hasAudio");
+        cache[element->getStringAttribute("path")] = entry;
+    }
+}
+
+void LoudnessAnalyzer::saveCache()
+{
+    juce::XmlElement root("LOUDNESS");
+
+    {
+        const juce::ScopedLock scopedLock(lock);
+
+        for (auto& [path, entry] : cache)
+        {
+            auto* element = root.createNewChildElement("TRACK");
+            element->setAttribute("path", path);
+            element->setAttribute("size", juce::String(entry.size));
+            element->setAttribute("modified", juce::String(entry.modified));
+            element->setAttribute("loudness", entry.result.integratedLoudness);
+            element->setAttribute("truePeak", entry.result.truePeak);
+            element->setAttribute("hasAudio", entry.result.hasAudio);
+        }
+    }
+
+    getCacheFile().getParentDirectory().createDirectory();
+    root.writeTo(getCacheFile());
+}
@@ -0,0 +1,102 @@
+/*
+  ==============================================================================
+    LoudnessAnalyzer.h
+    Created: 19 Oct 2026 5:48:16am
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "TrackAnalysisPool.h"
+#include <deque>
+#include <functional>
+#include <map>
+#include <vector>
+
+// Measures the integrated loudness and true peak of library tracks on the shared analysis
+// pool's threads and keeps the results between sessions, so the decks can play every track at the
+// same loudness.
+//
+// The measurement follows EBU R128 / ITU-R BS.1770-4: K-weighted mean square in 400 ms blocks
+// overlapping by 75%, gated at -70 LUFS and 10 LU below the ungated mean. The true peak is the
+// largest sample of a 4 times oversampled signal. The pool decodes each file once for every
+// analyzer that queued it; nothing here runs on the audio thread.
+class LoudnessAnalyzer : private juce::AsyncUpdater,
+                         private TrackAnalysisPool::Analysis
+{
+public:
+    struct Result
+    {
+        double integratedLoudness = 0.0;   // LUFS
+        double truePeak = 0.0;             // dBTP
+        bool hasAudio = false;             // false if every block was below the absolute gate
+    };
+
+    // Loudness every track is brought to, and the true peak a trim may raise a track to
+    static constexpr double targetLoudness = -14.0;
+    static constexpr double truePeakCeiling = -1.0;
+    static constexpr double maxTrimDecibels = 12.0;
+
+    /**Measures files on the pool; the pool must outlive this*/
+    explicit LoudnessAnalyzer(TrackAnalysisPool& pool);
+    ~LoudnessAnalyzer() override;
+
+    // Function: analyze
+    // Purpose: Queues a file unless its result is cached or it is queued already. Message thread.
+    // Inputs:
+    // - const juce::File& file: An audio file.
+    // - bool urgently: Analyzes it before the files queued so far, for a track just loaded.
+    void analyze(const juce::File& file, bool urgently = false);
+
+    /**Gets the cached result of a file, if it was analyzed since it last changed*/
+    bool getResult(const juce::File& file, Result& result) const;
+    /**Like getResult, but checks the cached result against a size and modification time the caller already has*/
+    bool getResult(const juce::File& file, juce::int64 size, juce::int64 modified, Result& result) const;
+
+    // Function: getNormalizationGain
+    // Purpose: Works out the trim that brings a track to the target loudness, lowered so its
+    //          true peak stays under the ceiling and limited to maxTrimDecibels either way.
+    // Outputs: The linear trim, 1 for silent tracks.
+    static double getNormalizationGain(const Result& result);
+
+    // Function: measure
+    // Purpose: Decodes a whole file and measures it. Runs on the calling thread.
+    // Outputs: False if the file can't be read.
+    static bool measure(juce::AudioFormatReader& reader, Result& result, const std::function<bool()>& shouldExit);
+
+    /**Called on the message thread after a file was analyzed*/
+    std::function<void(const juce::File&)> onAnalyzed;
+
+private:
+    class FileMeasurement;
+
+    struct CacheEntry
+    {
+        juce::int64 size;
+        juce::int64 modified;
+        Result result;
+    };
+
+    void handleAsyncUpdate() override;
+    bool takeNextFile(juce::File& file, bool urgentOnly) override;
+    bool takeFile(const juce::File& file) override;
+    std::unique_ptr<TrackAnalysisPool::Measurement> startMeasurement(const juce::File& file, const juce::AudioFormatReader& reader) override;
+    void skipFile(const juce::File& file) override;
+    void finishFile(const juce::File& file, const Result* result);
+    juce::File getCacheFile() const;
+    void loadCache();
+    void saveCache();
+
+    TrackAnalysisPool& pool;
+
+    // Shared with the pool's threads; the first numUrgent files of pending were queued urgently
+    juce::CriticalSection lock;
+    std::map<juce::String, CacheEntry> cache;
+    std::deque<juce::File> pending;
+    int numUrgent = 0;
+    juce::StringArray queuedPaths;
+    juce::Array<juce::File> finished;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(LoudnessAnalyzer)
+};
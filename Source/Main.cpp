@@ -8,6 +8,41 @@
 
 #include <JuceHeader.h>
 #include "MainComponent.h"
+#include "PluginHost.h"
+#include "TimecodeDecoder.h"
+#include "MidiControl.h"
+#include "StereoBiquadCascade.h"
+#include "IsolatorEQ.h"
+#include "FDNReverb.h"
+#include "StreamingAudioSource.h"
+
+namespace
+{
+    // A mode the app can be started in instead of opening its window
+    struct CommandLineMode
+    {
+        bool (*isRequested)(const juce::StringArray& arguments);
+        int (*run)(const juce::StringArray& arguments);
+    };
+
+    const CommandLineMode commandLineModes[] =
+    {
+        // The plugin scanner starts the app again to load each plugin binary in its own process
+        { PluginHost::isScanWorker, PluginHost::runScanWorker },
+        // Decodes a recorded timecode file, to check the decoder without a turntable
+        { TimecodeDecoder::isOfflineCheck, TimecodeDecoder::runOfflineCheck },
+        // Measures how long controller messages take to reach the audio, without a controller
+        { MidiControl::isLatencyCheck, MidiControl::runLatencyCheck },
+        // Plays a file through a throttled local server to check the jitter buffer without a network
+        { StreamingAudioSource::isStreamCheck, StreamingAudioSource::runStreamCheck },
+        // Times the deck filter section against the filter loop it replaced
+        { StereoBiquadCascade::isBenchmark, StereoBiquadCascade::runBenchmark },
+        // Times the isolator EQ against the filter section it runs after
+        { IsolatorEQ::isBenchmark, IsolatorEQ::runBenchmark },
+        // Times the deck reverb against the juce::Reverb it replaced
+        { FDNReverb::isBenchmark, FDNReverb::runBenchmark }
+    };
+}
 
 //==============================================================================
 class OtoDecksApplication  : public juce::JUCEApplication
@@ -25,6 +60,19 @@ public:
     {
         // This method is where you should put your application's initialisation code..
 
+        // Started in one of the command line modes, the app runs it and exits without a window
+        const auto arguments = getCommandLineParameterArray();
+
+        for (const auto& mode : commandLineModes)
+        {
+            if (mode.isRequested(arguments))
+            {
+                setApplicationReturnValue(mode.run(arguments));
+                quit();
+                return;
+            }
+        }
+
         mainWindow.reset (new MainWindow (getApplicationName()));
     }
 
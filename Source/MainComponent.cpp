@@ -7,6 +7,26 @@ MainComponent::MainComponent()
     // you add any child components.
     setSize (944, 600);
 
+    // The decks are wired up before the device starts calling them, so the audio thread never
+    // reads these pointers while they are being set
+
+    // Time both decks and the mix, and dump the flight recorder after a missed deadline
+    performanceMonitor.setAudioDeviceManager(&deviceManager);
+    player1.setPerformanceMonitor(&performanceMonitor, 0);
+    player2.setPerformanceMonitor(&performanceMonitor, 1);
+
+    threadPolicy.applyToTimeSliceThread(thumbCache.getTimeSliceThread(), ThreadPolicy::backgroundRole, "Thumbnail cache");
+
+    readAheadThread.startThread();
+    threadPolicy.applyToTimeSliceThread(readAheadThread, ThreadPolicy::renderWorkerRole, "Deck read-ahead");
+    player1.setReadAheadThread(&readAheadThread);
+    player2.setReadAheadThread(&readAheadThread);
+
+    renderAheadThread.startThread();
+    threadPolicy.applyToTimeSliceThread(renderAheadThread, ThreadPolicy::renderWorkerRole, "Deck render-ahead");
+    player1.setRenderAheadThread(&renderAheadThread);
+    player2.setRenderAheadThread(&renderAheadThread);
+
     // Some platforms require permissions to open input channels so request that here
     if (juce::RuntimePermissions::isRequired (juce::RuntimePermissions::recordAudio)
         && ! juce::RuntimePermissions::isGranted (juce::RuntimePermissions::recordAudio))
@@ -20,17 +40,94 @@ MainComponent::MainComponent()
         setAudioChannels (2, 2);
     }
 
+    // Tracks load trimmed to the target loudness, and take their trim when their analysis is done
+    player1.setLoudnessAnalyzer(&loudnessAnalyzer);
+    player2.setLoudnessAnalyzer(&loudnessAnalyzer);
+    loudnessAnalyzer.onAnalyzed = [this] (const juce::File& file)
+    {
+        // Only a deck playing the file has a new trim; the other keeps rendering ahead
+        for (auto* player : { &player1, &player2 })
+            if (player->getLoadedFile() == file)
+                player->updateNormalization();
+
+        playlistComponent.trackAnalyzed(file);
+    };
+
+    // The BPM column and the decks' beat markers fill in as the beat analysis finishes
+    deckGUI1.setBeatAnalyzer(&beatAnalyzer);
+    deckGUI2.setBeatAnalyzer(&beatAnalyzer);
+    beatAnalyzer.onAnalyzed = [this] (const juce::File& file)
+    {
+        deckGUI1.updateBeatGrid();
+        deckGUI2.updateBeatGrid();
+        playlistComponent.trackAnalyzed(file);
+    };
+
+    // Each deck's DOUBLE button clones the other deck onto it
+    deckGUI1.onDoubleRequested = [this] { deckGUI1.cloneFrom(deckGUI2); };
+    deckGUI2.onDoubleRequested = [this] { deckGUI2.cloneFrom(deckGUI1); };
+
     addAndMakeVisible(deckGUI1);
     addAndMakeVisible(deckGUI2);
     addAndMakeVisible(playlistComponent);
+    addAndMakeVisible(samplePadComponent);
+    addAndMakeVisible(deck1Plugins);
+    addAndMakeVisible(deck2Plugins);
+    addAndMakeVisible(masterPluginsComponent);
+
+    recordButton.setClickingTogglesState(false);
+    recordButton.setColour(juce::TextButton::buttonOnColourId, juce::Colours::red);
+    recordButton.onClick = [this] { toggleRecording(); };
+    addAndMakeVisible(recordButton);
+    addAndMakeVisible(recordStatusLabel);
+
+    timecodeBox.addItem("DVS off", 1);
+    timecodeBox.addItem("DVS deck 1 Serato", 2);
+    timecodeBox.addItem("DVS deck 1 Traktor", 3);
+    timecodeBox.addItem("DVS deck 2 Serato", 4);
+    timecodeBox.addItem("DVS deck 2 Traktor", 5);
+    timecodeBox.setSelectedId(1, juce::dontSendNotification);
+    timecodeBox.setTooltip("Play a deck from a timecode record on the audio input");
+    timecodeBox.onChange = [this] { timecodeSourceChanged(); };
+    addAndMakeVisible(timecodeBox);
+
+    lowLatencyButton.setClickingTogglesState(true);
+    lowLatencyButton.setColour(juce::TextButton::buttonOnColourId, juce::Colours::orange);
+    lowLatencyButton.onClick = [this] { latencyModeChanged(); };
+    deviceSwitcher.onSwitched = [this] (const juce::String&) { updateLatencyButton(); updateSampleRateBox(); };
+    addAndMakeVisible(lowLatencyButton);
+    updateLatencyButton();
+
+    sampleRateBox.setTooltip("Switch the device's sample rate while playing");
+    sampleRateBox.onChange = [this] { sampleRateChanged(); };
+    addAndMakeVisible(sampleRateBox);
+    updateSampleRateBox();
+    startTimer(250);
 
     formatManager.registerBasicFormats();
+
+    midiControl.loadMappings(MidiControl::getMappingFile());
+    midiControl.openDevices(deviceManager);
 }
 
 MainComponent::~MainComponent()
 {
+    stopTimer();
+    midiControl.closeDevices(deviceManager);
+    loudnessAnalyzer.onAnalyzed = nullptr;
+    beatAnalyzer.onAnalyzed = nullptr;
+
     // This shuts down the audio device and clears the audio source.
     shutdownAudio();
+    mixRecorder.stop();
+
+    // The transports are released with the decks; stop them reading and rendering ahead first
+    player1.setRenderAheadThread(nullptr);
+    player2.setRenderAheadThread(nullptr);
+    renderAheadThread.stopThread(2000);
+    player1.setReadAheadThread(nullptr);
+    player2.setReadAheadThread(nullptr);
+    readAheadThread.stopThread(2000);
 }
 
 //==============================================================================
@@ -44,15 +141,118 @@ void MainComponent::prepareToPlay (int samplesPerBlockExpected, double sampleRat
 
     // For more details, see the help for AudioProcessor::prepareToPlay()
 
-    mixerSource.addInputSource(&player1, false);
-    mixerSource.addInputSource(&player2, false);
-    player1.prepareToPlay(samplesPerBlockExpected, sampleRate);
-    player2.prepareToPlay(samplesPerBlockExpected, sampleRate);
+    // The device block size is the largest block any stage is handed, longer callbacks are split
+    maximumBlockSize = juce::jmax(1, samplesPerBlockExpected);
+
+    mixArena.clear();
+    const int deckScratch = mixArena.reserve(2, maximumBlockSize);
+    const int padScratch = mixArena.reserve(2, maximumBlockSize);
+    masterPlugins.reserveScratch(mixArena, maximumBlockSize);
+    mixArena.allocate();
+
+    float* deckChannels[] = { mixArena.getChannelPointer(deckScratch, 0), mixArena.getChannelPointer(deckScratch, 1) };
+    mixBuffer.setDataToReferTo(deckChannels, 2, maximumBlockSize);
+    float* padChannels[] = { mixArena.getChannelPointer(padScratch, 0), mixArena.getChannelPointer(padScratch, 1) };
+    padBuffer.setDataToReferTo(padChannels, 2, maximumBlockSize);
 
+    player1.prepareToPlay(maximumBlockSize, sampleRate);
+    player2.prepareToPlay(maximumBlockSize, sampleRate);
+    samplePad.prepareToPlay(maximumBlockSize, sampleRate);
+    masterPlugins.prepareToPlay(maximumBlockSize, sampleRate);
+
+    // The delay lines hold the largest compensation, so they never grow while playing
+    maxLatencyCompensation = juce::roundToInt(sampleRate * maxLatencyCompensationSeconds);
+    for (int deck = 0; deck < 2; ++deck)
+    {
+        latencyDelays[deck].prepare({ sampleRate, (juce::uint32) maximumBlockSize, 2 });
+        latencyDelays[deck].setMaximumDelayInSamples(maxLatencyCompensation);
+        latencyCompensation[deck] = 0;
+    }
+    performanceMonitor.prepare(sampleRate);
+    mixRecorder.prepare(sampleRate);
+    autoDJ.prepare(sampleRate);
+    timecodeControl.prepare(sampleRate);
+    midiControl.prepare(sampleRate);
+    deviceSwitcher.prepare(sampleRate);
 }
+
 void MainComponent::getNextAudioBlock(const juce::AudioSourceChannelInfo& bufferToFill)
 {
-    mixerSource.getNextAudioBlock(bufferToFill);
+    // Debug builds report anything below this that allocates or locks
+    const RealtimeSafetyChecker::ScopedRealtimeSection realtimeSection;
+    const juce::ScopedNoDenormals noDenormals;
+    ThreadPolicy::noteAudioThread();
+
+    auto& buffer = *bufferToFill.buffer;
+
+    // While the device switches, the decks aren't pulled between the fade-out and the restart,
+    // so they carry on from where they faded out. The recorder gets the silence, so the
+    // recording keeps time with what was heard.
+    if (maximumBlockSize == 0 || deviceSwitcher.isSilent())
+    {
+        bufferToFill.clearActiveBufferRegion();
+
+        if (maximumBlockSize > 0)
+            mixRecorder.pushBlock(buffer, bufferToFill.startSample, bufferToFill.numSamples);
+
+        return;
+    }
+
+    performanceMonitor.beginCallback();
+    midiControl.beginBlock(bufferToFill.numSamples);
+
+    for (int offset = 0; offset < bufferToFill.numSamples;)
+    {
+        // Controller events land on their sample: a chunk ends where the next one is due
+        const int samplesToEvent = midiControl.applyEventsAt(offset);
+        const int numSamples = juce::jmin(maximumBlockSize, bufferToFill.numSamples - offset, samplesToEvent);
+        const int startSample = bufferToFill.startSample + offset;
+        offset += numSamples;
+
+        // A cloned deck takes the other deck's position before either renders
+        player1.applyPendingSync();
+        player2.applyPendingSync();
+
+        // The Auto-DJ decides per chunk which deck plays and where a crossfade starts
+        AutoDJ::DeckPlan plans[AutoDJ::numDecks];
+        autoDJ.planChunk(numSamples, plans);
+
+        // The timecode input is read before the first deck renders over it
+        timecodeControl.processInput(buffer, startSample, numSamples, plans);
+
+        // The first deck renders straight into the output, the second one next to it
+        renderDeck(player1, buffer, startSample, numSamples, plans[0]);
+        renderDeck(player2, mixBuffer, 0, numSamples, plans[1]);
+
+        // The deck with less plugin latency waits for the other one
+        const int latency1 = player1.getPluginChain().getLatencySamples();
+        const int latency2 = player2.getPluginChain().getLatencySamples();
+        compensateLatency(0, buffer, startSample, numSamples, juce::jmax(0, latency2 - latency1));
+        compensateLatency(1, mixBuffer, 0, numSamples, juce::jmax(0, latency1 - latency2));
+
+        samplePad.getNextAudioBlock(juce::AudioSourceChannelInfo(&padBuffer, 0, numSamples));
+        masterGuard.check(0, padBuffer, 0, numSamples);
+
+        const auto mixStart = juce::Time::getHighResolutionTicks();
+
+        for (int channel = 0; channel < buffer.getNumChannels(); ++channel)
+        {
+            buffer.addFrom(channel, startSample, mixBuffer, juce::jmin(channel, 1), 0, numSamples);
+            buffer.addFrom(channel, startSample, padBuffer, juce::jmin(channel, 1), 0, numSamples);
+        }
+
+        masterPlugins.process(buffer, startSample, numSamples);
+        masterGuard.check(1, buffer, startSample, numSamples);
+
+        performanceMonitor.addMixTime(juce::Time::getHighResolutionTicks() - mixStart);
+    }
+
+    deviceSwitcher.processOutput(buffer, bufferToFill.startSample, bufferToFill.numSamples);
+
+    // The recorder only copies into its queue; the file is written on its own thread
+    mixRecorder.pushBlock(buffer, bufferToFill.startSample, bufferToFill.numSamples);
+
+    performanceMonitor.endCallback(bufferToFill.numSamples);
 }
 
 void MainComponent::releaseResources()
@@ -61,10 +261,93 @@ void MainComponent::releaseResources()
     // restarted due to a setting change.
 
     // For more details, see the help for AudioProcessor::releaseResources()
-    mixerSource.removeAllInputs();
-    mixerSource.releaseResources();
     player1.releaseResources();
     player2.releaseResources();
+    samplePad.releaseResources();
+    masterPlugins.releaseResources();
+    maximumBlockSize = 0;
+    mixBuffer.setSize(2, 0);
+    padBuffer.setSize(2, 0);
+    mixArena.clear();
+}
+
+// Function: renderDeck
+// Purpose: Renders a deck from the plan's first sample on, silence before it, and applies the
+//          plan's gain: constant up to rampStart, a ramp up to rampEnd, constant after it.
+//          A deck that is held, by the plan or by a controller, is not pulled at all, so its
+//          transport doesn't move.
+void MainComponent::renderDeck(DJAudioPlayer& player, juce::AudioBuffer<float>& target, int startSample, int numSamples,
+                               const AutoDJ::DeckPlan& plan)
+{
+    if (!plan.render || player.isHeld())
+    {
+        target.clear(startSample, numSamples);
+        return;
+    }
+
+    if (plan.firstSample > 0)
+        target.clear(startSample, plan.firstSample);
+
+    player.getNextAudioBlock(juce::AudioSourceChannelInfo(&target, startSample + plan.firstSample, numSamples - plan.firstSample));
+
+    if (plan.gainStart == 1.0f && plan.gainEnd == 1.0f)
+        return;
+
+    if (plan.rampStart > 0)
+        target.applyGain(startSample, plan.rampStart, plan.gainStart);
+
+    if (plan.rampEnd > plan.rampStart)
+        target.applyGainRamp(startSample + plan.rampStart, plan.rampEnd - plan.rampStart, plan.gainStart, plan.gainEnd);
+
+    if (numSamples > plan.rampEnd)
+        target.applyGain(startSample + plan.rampEnd, numSamples - plan.rampEnd, plan.gainEnd);
+}
+
+// The box's items are off, then deck 1 and deck 2 with each format
+void MainComponent::timecodeSourceChanged()
+{
+    const int item = timecodeBox.getSelectedId() - 2;
+
+    if (item < 0)
+    {
+        timecodeControl.setSource(-1, 0);
+        return;
+    }
+
+    const int deck = item / 2;
+    timecodeControl.setSource(deck, item % 2 == 0 ? TimecodeDecoder::seratoSideA : TimecodeDecoder::traktorSideA);
+}
+
+// Function: compensateLatency
+// Purpose: Runs a deck through its delay line when it needs one. The line is cleared when it
+//          comes into use, so it never plays what it held from an earlier compensation.
+void MainComponent::compensateLatency(int deck, juce::AudioBuffer<float>& target, int startSample, int numSamples, int delay)
+{
+    auto& delayLine = latencyDelays[deck];
+    delay = juce::jmin(delay, maxLatencyCompensation);
+
+    if (delay != latencyCompensation[deck])
+    {
+        if (latencyCompensation[deck] == 0)
+            delayLine.reset();
+
+        delayLine.setDelay((float) delay);
+        latencyCompensation[deck] = delay;
+    }
+
+    if (delay == 0)
+        return;
+
+    for (int channel = 0; channel < juce::jmin(2, target.getNumChannels()); ++channel)
+    {
+        float* samples = target.getWritePointer(channel, startSample);
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            delayLine.pushSample(channel, samples[i]);
+            samples[i] = delayLine.popSample(channel);
+        }
+    }
 }
 
 //==============================================================================
@@ -87,11 +370,185 @@ void MainComponent::resized()
     //deckGUI2.setBounds(getWidth() / 3, getHeight() / 2, 2 * getWidth() / 3, getHeight() / 2);
     int columns = 100;
     auto playlistRight = 28 * getWidth() / columns;
-    playlistComponent.setBounds(0, 0, playlistRight, getHeight());
-    deckGUI1.setBounds(playlistRight, 0, getWidth() - playlistRight, getHeight() / 2);
-    deckGUI2.setBounds(playlistRight, getHeight() / 2, getWidth() - playlistRight, getHeight() / 2);
+    const int recordRowHeight = 30;
+    const int padRowsHeight = 70;
+    playlistComponent.setBounds(0, 0, playlistRight, getHeight() - recordRowHeight - padRowsHeight);
+    samplePadComponent.setBounds(0, getHeight() - recordRowHeight - padRowsHeight, playlistRight, padRowsHeight);
+    recordButton.setBounds(2, getHeight() - recordRowHeight + 2, 60, recordRowHeight - 4);
+    const int timecodeBoxWidth = 130;
+    const int lowLatencyButtonWidth = 60;
+    const int sampleRateBoxWidth = 80;
+    recordStatusLabel.setBounds(66, getHeight() - recordRowHeight, playlistRight - 78 - timecodeBoxWidth - lowLatencyButtonWidth - sampleRateBoxWidth, recordRowHeight);
+    sampleRateBox.setBounds(playlistRight - timecodeBoxWidth - lowLatencyButtonWidth - sampleRateBoxWidth - 10, getHeight() - recordRowHeight + 2, sampleRateBoxWidth, recordRowHeight - 4);
+    lowLatencyButton.setBounds(playlistRight - timecodeBoxWidth - lowLatencyButtonWidth - 6, getHeight() - recordRowHeight + 2, lowLatencyButtonWidth, recordRowHeight - 4);
+    timecodeBox.setBounds(playlistRight - timecodeBoxWidth - 2, getHeight() - recordRowHeight + 2, timecodeBoxWidth, recordRowHeight - 4);
+    const int pluginRowHeight = 24;
+    const int decksHeight = getHeight() - 3 * pluginRowHeight;
+    deckGUI1.setBounds(playlistRight, 0, getWidth() - playlistRight, decksHeight / 2);
+    deckGUI2.setBounds(playlistRight, decksHeight / 2, getWidth() - playlistRight, decksHeight / 2);
+    deck1Plugins.setBounds(playlistRight, decksHeight, getWidth() - playlistRight, pluginRowHeight);
+    deck2Plugins.setBounds(playlistRight, decksHeight + pluginRowHeight, getWidth() - playlistRight, pluginRowHeight);
+    masterPluginsComponent.setBounds(playlistRight, decksHeight + 2 * pluginRowHeight, getWidth() - playlistRight, pluginRowHeight);
 
     //getWidth() - getWidth() / columns - getHeight() / 4
     //deckGUI1.setBounds(playlistRight, 0, getWidth() - playlistRight - getHeight() / 4, getHeight() / 2);
     //deckGUI2.setBounds(playlistRight, getHeight() / 2, getWidth() - playlistRight - getHeight() / 4, getHeight() / 2);
-}
\ No newline at end of file
+}
+
+// Asks for a file and starts recording the mix, or stops the recording that is running.
+// The format follows the extension chosen: .wav, .flac or .ogg
+void MainComponent::toggleRecording()
+{
+    if (mixRecorder.isRecording())
+    {
+        mixRecorder.stop();
+    }
+    else
+    {
+        const auto defaultFile = juce::File::getSpecialLocation(juce::File::userMusicDirectory)
+            .getChildFile("OtoDecks mix " + juce::Time::getCurrentTime().formatted("%Y-%m-%d %H-%M") + ".wav");
+
+        juce::FileChooser chooser{ "Record the mix to", defaultFile, "*.wav;*.flac;*.ogg" };
+        if (chooser.browseForFileToSave(true) && !mixRecorder.start(chooser.getResult()))
+        {
+            juce::AlertWindow::showMessageBoxAsync(juce::AlertWindow::WarningIcon, "Recording",
+                                                   "Could not create " + chooser.getResult().getFullPathName());
+        }
+    }
+
+    timerCallback();
+}
+
+// Updates the recording status a few times per second
+void MainComponent::timerCallback()
+{
+    checkSignalGuards();
+
+    recordButton.setToggleState(mixRecorder.isRecording(), juce::dontSendNotification);
+
+    if (!mixRecorder.isRecording() && mixRecorder.getFile() == juce::File())
+        return;
+
+    const int seconds = (int) mixRecorder.getRecordedSeconds();
+    juce::String status;
+    status << (mixRecorder.isRecording() ? "Recording " : "Saved ")
+           << juce::String(seconds / 3600) << ":" << juce::String((seconds / 60) % 60).paddedLeft('0', 2)
+           << ":" << juce::String(seconds % 60).paddedLeft('0', 2);
+
+    if (mixRecorder.getDroppedBlocks() > 0)
+        status << ", " << juce::String(mixRecorder.getDroppedBlocks()) << " blocks dropped";
+
+    recordStatusLabel.setText(status, juce::dontSendNotification);
+    recordStatusLabel.setTooltip(mixRecorder.getFile().getFullPathName());
+}
+
+// Function: latencyModeChanged
+// Purpose: Switches while playing; the button goes back if the device has no other size or a
+//          switch is still running.
+void MainComponent::latencyModeChanged()
+{
+    const auto mode = lowLatencyButton.getToggleState() ? DeviceSwitcher::lowLatencyMode : DeviceSwitcher::safeMode;
+
+    if (!deviceSwitcher.setLatencyMode(mode))
+        updateLatencyButton();
+}
+
+// Function: updateLatencyButton
+// Purpose: Lights the button when the device runs at the low latency size or below, and puts
+//          the block size and its duration in the tooltip.
+void MainComponent::updateLatencyButton()
+{
+    const auto* device = deviceManager.getCurrentAudioDevice();
+
+    if (device == nullptr)
+    {
+        lowLatencyButton.setToggleState(false, juce::dontSendNotification);
+        lowLatencyButton.setTooltip("No audio device");
+        return;
+    }
+
+    const int blockSize = device->getCurrentBufferSizeSamples();
+    const double milliseconds = 1000.0 * blockSize / juce::jmax(1.0, device->getCurrentSampleRate());
+
+    lowLatencyButton.setToggleState(blockSize <= DeviceSwitcher::lowLatencyBlockSize, juce::dontSendNotification);
+    lowLatencyButton.setTooltip("Blocks of " + juce::String(blockSize) + " samples (" + juce::String(milliseconds, 1)
+                                + " ms); switch between low latency and safe block sizes while playing");
+}
+
+// Function: sampleRateChanged
+// Purpose: Switches while playing; the box goes back if the rate is in use already or a
+//          switch is still running. The decks keep their place, since they count in track samples.
+void MainComponent::sampleRateChanged()
+{
+    const auto* device = deviceManager.getCurrentAudioDevice();
+    const int index = sampleRateBox.getSelectedId() - 1;
+
+    if (device == nullptr || !juce::isPositiveAndBelow(index, device->getAvailableSampleRates().size())
+        || !deviceSwitcher.setSampleRate(device->getAvailableSampleRates()[index]))
+        updateSampleRateBox();
+}
+
+// Function: updateSampleRateBox
+// Purpose: Fills the box with the rates the device offers; without a device it is disabled.
+void MainComponent::updateSampleRateBox()
+{
+    const auto* device = deviceManager.getCurrentAudioDevice();
+    sampleRateBox.clear(juce::dontSendNotification);
+    sampleRateBox.setEnabled(device != nullptr);
+
+    if (device == nullptr)
+        return;
+
+    const auto rates = device->getAvailableSampleRates();
+
+    for (int i = 0; i < rates.size(); ++i)
+    {
+        sampleRateBox.addItem(juce::String(rates[i] / 1000.0, 1) + " kHz", i + 1);
+
+        if (rates[i] == device->getCurrentSampleRate())
+            sampleRateBox.setSelectedId(i + 1, juce::dontSendNotification);
+    }
+}
+
+// Function: checkSignalGuards
+// Purpose: Lets the decks rebuild what their audio thread took out, and writes every guard's
+//          counts to the log when a non-finite block was silenced or the first denormals showed up.
+void MainComponent::checkSignalGuards()
+{
+    player1.recoverFromSignalFaults();
+    player2.recoverFromSignalFaults();
+
+    const std::pair<const char*, const SignalGuard*> guards[] = {
+        { "Deck 1", &player1.getSignalGuard() },
+        { "Deck 1 plugin", &player1.getPluginChain().getSignalGuard() },
+        { "Deck 2", &player2.getSignalGuard() },
+        { "Deck 2 plugin", &player2.getPluginChain().getSignalGuard() },
+        { "Master plugin", &masterPlugins.getSignalGuard() },
+        { "Master", &masterGuard }
+    };
+
+    int denormalBlocks = 0;
+    int nonFiniteBlocks = 0;
+
+    for (auto& guard : guards)
+    {
+        denormalBlocks += guard.second->getTotalDenormalBlocks();
+        nonFiniteBlocks += guard.second->getTotalNonFiniteBlocks();
+    }
+
+    const bool firstDenormals = reportedDenormalBlocks == 0 && denormalBlocks > 0;
+    reportedDenormalBlocks = denormalBlocks;
+
+    if (nonFiniteBlocks == reportedNonFiniteBlocks && !firstDenormals)
+        return;
+
+    reportedNonFiniteBlocks = nonFiniteBlocks;
+
+    juce::StringArray lines;
+
+    for (auto& guard : guards)
+        lines.add(guard.second->getReport(guard.first));
+
+    lines.removeEmptyStrings();
+    juce::Logger::writeToLog("Signal guards:\n" + lines.joinIntoString("\n"));
+}
@@ -6,6 +6,21 @@
 #include "DeckGUI.h"
 #include "PlaylistComponent.h"
 #include "AudioProcessorClass.h"
+#include "ScratchArena.h"
+#include "AsyncLogger.h"
+#include "PerformanceMonitor.h"
+#include "RealtimeSafetyChecker.h"
+#include "ThreadPolicy.h"
+#include "MixRecorder.h"
+#include "AutoDJ.h"
+#include "SamplePadSource.h"
+#include "SamplePadComponent.h"
+#include "PluginHost.h"
+#include "PluginChain.h"
+#include "PluginChainComponent.h"
+#include "TimecodeControl.h"
+#include "MidiControl.h"
+#include "DeviceSwitcher.h"
 
 
 //==============================================================================
@@ -13,7 +28,8 @@
     This component lives inside our window, and this is where you should put all
     your controls and content.
 */
-class MainComponent  : public juce::AudioAppComponent
+class MainComponent  : public juce::AudioAppComponent,
+                       private juce::Timer
 {
 public:
     //==============================================================================
@@ -30,21 +46,110 @@ public:
     void resized() override;
 
 private:
+    /**Starts a recording of the mix after asking for a file, or stops the running one*/
+    void toggleRecording();
+    /**Shows the length and dropped blocks of the recording*/
+    void timerCallback() override;
+    /**Renders one deck into part of a buffer with the gains the Auto-DJ planned for it*/
+    void renderDeck(DJAudioPlayer& player, juce::AudioBuffer<float>& target, int startSample, int numSamples,
+                    const AutoDJ::DeckPlan& plan);
+    /**Puts the deck and format chosen in the timecode box under timecode control*/
+    void timecodeSourceChanged();
+    /**Switches the device to the block size of the latency mode the button shows*/
+    void latencyModeChanged();
+    /**Shows the block size and latency the device runs at on the latency button*/
+    void updateLatencyButton();
+    /**Switches the device to the sample rate chosen in the rate box*/
+    void sampleRateChanged();
+    /**Lists the device's sample rates in the rate box and selects the one it runs at*/
+    void updateSampleRateBox();
+    /**Replaces faulted deck stages and logs the signal guards' counts when they change*/
+    void checkSignalGuards();
+    /**Delays a deck so its plugin latency matches the deck with the most*/
+    void compensateLatency(int deck, juce::AudioBuffer<float>& target, int startSample, int numSamples, int delay);
+
     //==============================================================================
     // Your private member variables go here...
 
+    // Declared first so it is created before and destroyed after everything that logs
+    AsyncLogger logger;
+    // Outlives the decks, which report their stage times to it
+    PerformanceMonitor performanceMonitor;
+    // Declared before the thumbnail cache, whose thread it sets up
+    ThreadPolicy threadPolicy;
+
     juce::AudioFormatManager formatManager;
     juce::AudioThumbnailCache thumbCache{100};
 
     AudioProcessorClass audioProcessor;
 
+    // Finds and creates plugins for the deck and master slots
+    PluginHost pluginHost;
+
+    // Decodes ahead of both decks, so a deck started by the Auto-DJ has its first second ready
+    juce::TimeSliceThread readAheadThread{ "Deck read-ahead" };
+    // Renders decks nobody is controlling ahead of the device callback
+    juce::TimeSliceThread renderAheadThread{ "Deck render-ahead" };
+
+    // Decodes each library track once for both analyzers below
+    TrackAnalysisPool analysisPool;
+    // Measures the library's tracks in the background so the decks play them equally loud
+    LoudnessAnalyzer loudnessAnalyzer{ analysisPool };
+    // Finds the tempo and beat grid of the library's tracks in the background
+    BeatAnalyzer beatAnalyzer{ analysisPool };
+
     DJAudioPlayer player1{formatManager};
     DJAudioPlayer player2{formatManager};
     DJAudioPlayer playerForParsingMetaData{formatManager};
     DeckGUI deckGUI1{1, &player1, formatManager, thumbCache,audioProcessor };
     DeckGUI deckGUI2{2, &player2, formatManager, thumbCache,audioProcessor };
-    PlaylistComponent playlistComponent{ &deckGUI1, &deckGUI2, &playerForParsingMetaData };
+    AutoDJ autoDJ{ deckGUI1, deckGUI2, player1, player2 };
+    PlaylistComponent playlistComponent{ &deckGUI1, &deckGUI2, &playerForParsingMetaData, &autoDJ, &loudnessAnalyzer, &beatAnalyzer };
+
+    // The decks are summed here instead of in a juce::MixerAudioSource, whose temporary buffer
+    // is resized inside the audio callback; the second deck renders into the arena instead
+    ScratchArena mixArena;
+    juce::AudioBuffer<float> mixBuffer;
+    int maximumBlockSize = 0;
+
+    // One-shots played over the decks; they render into the arena like the second deck
+    SamplePadSource samplePad;
+    SamplePadComponent samplePadComponent{ samplePad };
+    juce::AudioBuffer<float> padBuffer;
+
+    // Plugins on the summed mix, and the delays that line the decks up when their plugins'
+    // latencies differ. The pads are played live and are not delayed.
+    PluginChain masterPlugins;
+    // Last line of defence before the device and the recorder
+    SignalGuard masterGuard{ "pads", "output" };
+    int reportedDenormalBlocks = 0;
+    int reportedNonFiniteBlocks = 0;
+    static constexpr double maxLatencyCompensationSeconds = 1.0;
+    juce::dsp::DelayLine<float, juce::dsp::DelayLineInterpolationTypes::None> latencyDelays[2];
+    int latencyCompensation[2] = { 0, 0 };
+    int maxLatencyCompensation = 0;
+
+    PluginChainComponent deck1Plugins{ "DECK 1", pluginHost, player1.getPluginChain() };
+    PluginChainComponent deck2Plugins{ "DECK 2", pluginHost, player2.getPluginChain() };
+    PluginChainComponent masterPluginsComponent{ "MASTER", pluginHost, masterPlugins };
+
+    // A timecode record on the input can play one of the decks
+    TimecodeControl timecodeControl{ deckGUI1, deckGUI2, player1, player2 };
+    juce::ComboBox timecodeBox;
+
+    // Controllers play the decks through the audio thread, at the sample their messages are due
+    MidiControl midiControl{ &deckGUI1, &deckGUI2, &player1, &player2 };
+
+    // Switches between a small and a safe block size, or to another sample rate, while
+    // playing, with one short faded gap
+    DeviceSwitcher deviceSwitcher{ deviceManager };
+    juce::TextButton lowLatencyButton{ "LOW LAT" };
+    juce::ComboBox sampleRateBox;
+
+    // Records what getNextAudioBlock outputs
+    MixRecorder mixRecorder;
+    juce::TextButton recordButton{ "REC" };
+    juce::Label recordStatusLabel;
 
-    juce::MixerAudioSource mixerSource;
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (MainComponent)
 };
@@ -0,0 +1,548 @@
+/*
+  ==============================================================================
+    MidiControl.cpp
+    Created: 19 Oct 2026 5:03:44am
+  ==============================================================================
+*/
+
+#include "MidiControl.h"
+#include "AsyncLogger.h"
+#include <cmath>
+#include <iostream>
+#include <limits>
+
+namespace
+{
+    const char* const latencyCheckOption = "--midi-latency-check";
+
+    const char* const targetNames[] = { "play", "cue", "gain", "speed", "lowPass", "bandPass", "highPass",
+                                        "lowBand", "midBand", "highBand", "jog" };
+    const char* const encodingNames[] = { "absolute", "absolute14", "relative", "relative14" };
+
+    int findName(const char* const* names, int numNames, const juce::String& name)
+    {
+        for (int index = 0; index < numNames; ++index)
+            if (name == names[index])
+                return index;
+
+        return -1;
+    }
+
+    // The filter sliders span 20 Hz to 20 kHz; a controller moves through them in octaves
+    double toFrequency(float value) noexcept { return 20.0 * std::pow(1000.0, (double) value); }
+}
+
+MidiControl::MidiControl(DeckGUI* deckGUI1, DeckGUI* deckGUI2, DJAudioPlayer* player1, DJAudioPlayer* player2)
+    : deckGUIs{ deckGUI1, deckGUI2 },
+      players{ player1, player2 }
+{
+    for (int deck = 0; deck < numDecks; ++deck)
+    {
+        for (int target = 0; target < numTargets; ++target)
+        {
+            sliderValues[deck][target] = 0.0f;
+            sliderPending[deck][target] = false;
+        }
+
+        startRequested[deck] = false;
+        cueRequested[deck] = false;
+    }
+
+    if (deckGUI1 != nullptr || deckGUI2 != nullptr)
+        startTimer(30);
+}
+
+MidiControl::~MidiControl()
+{
+    stopTimer();
+}
+
+void MidiControl::openDevices(juce::AudioDeviceManager& deviceManager)
+{
+    for (auto& device : juce::MidiInput::getAvailableDevices())
+        deviceManager.setMidiInputDeviceEnabled(device.identifier, true);
+
+    // An empty identifier listens to every enabled input, on the MIDI thread
+    deviceManager.addMidiInputDeviceCallback({}, this);
+}
+
+void MidiControl::closeDevices(juce::AudioDeviceManager& deviceManager)
+{
+    deviceManager.removeMidiInputDeviceCallback({}, this);
+}
+
+juce::File MidiControl::getMappingFile()
+{
+    return juce::File::getSpecialLocation(juce::File::userApplicationDataDirectory)
+        .getChildFile("OtoDecks").getChildFile("MidiMappings.xml");
+}
+
+// Function: loadMappings
+// Purpose: Each MAP element names a deck, a channel, a message type, a number, a target and,
+//          for controllers, an encoding. Elements that don't parse are skipped and logged.
+bool MidiControl::loadMappings(const juce::File& file)
+{
+    if (!file.existsAsFile())
+        writeDefaultMappings(file);
+
+    auto xml = juce::parseXML(file);
+
+    if (xml == nullptr)
+        return false;
+
+    std::vector<Mapping> newMappings;
+
+    for (auto* element : xml->getChildWithTagNameIterator("MAP"))
+    {
+        Mapping mapping;
+        const auto type = element->getStringAttribute("type", "cc");
+        const int target = findName(targetNames, numTargets, element->getStringAttribute("target"));
+        const int encoding = findName(encodingNames, 4, element->getStringAttribute("encoding", "absolute"));
+
+        mapping.channel = element->getIntAttribute("channel", 0);
+        mapping.isNote = type == "note";
+        mapping.isPitchWheel = type == "pitchwheel";
+        mapping.number = element->getIntAttribute("number", 0);
+        mapping.deck = element->getIntAttribute("deck", 1) - 1;
+
+        if (target < 0 || encoding < 0 || mapping.deck < 0 || mapping.deck >= numDecks)
+        {
+            RT_LOG(warning, "MidiControl skipped a mapping it couldn't read, number:", mapping.number);
+            continue;
+        }
+
+        mapping.target = (Target) target;
+        mapping.encoding = (Encoding) encoding;
+        newMappings.push_back(mapping);
+    }
+
+    {
+        const juce::SpinLock::ScopedLockType lock(producerLock);
+        std::swap(mappings, newMappings);
+    }
+
+    RT_LOG(info, "MidiControl mappings loaded:", mappings.size());
+    return true;
+}
+
+// Writes a layout for a generic controller: deck 1 on channel 1, deck 2 on channel 2
+void MidiControl::writeDefaultMappings(const juce::File& file)
+{
+    juce::XmlElement root("MIDIMAPPINGS");
+
+    for (int deck = 1; deck <= numDecks; ++deck)
+    {
+        auto addMapping = [&](const char* type, int number, const char* target, const char* encoding)
+        {
+            auto* element = root.createNewChildElement("MAP");
+            element->setAttribute("deck", deck);
+            element->setAttribute("channel", deck);
+            element->setAttribute("type", type);
+            element->setAttribute("number", number);
+            element->setAttribute("target", target);
+            element->setAttribute("encoding", encoding);
+        };
+
+        addMapping("note", 11, "play", "absolute");
+        addMapping("note", 12, "cue", "absolute");
+        addMapping("cc", 7, "gain", "absolute");
+        addMapping("pitchwheel", 0, "speed", "absolute14");
+        addMapping("cc", 20, "lowPass", "absolute");
+        addMapping("cc", 21, "bandPass", "absolute");
+        addMapping("cc", 22, "highPass", "absolute");
+        addMapping("cc", 23, "lowBand", "absolute");
+        addMapping("cc", 24, "midBand", "absolute");
+        addMapping("cc", 25, "highBand", "absolute");
+        addMapping("cc", 16, "jog", "relative");
+    }
+
+    file.getParentDirectory().createDirectory();
+    root.writeTo(file);
+}
+
+void MidiControl::prepare(double sampleRate)
+{
+    currentSampleRate = sampleRate;
+}
+
+// Function: handleIncomingMidiMessage
+// Purpose: The message's time stamp is taken when the device delivered it. 14 bit controllers
+//          send the high 7 bits first, so an event is only queued once the low 7 bits follow.
+void MidiControl::handleIncomingMidiMessage(juce::MidiInput*, const juce::MidiMessage& message)
+{
+    const double arrival = message.getTimeStamp() > 0.0 ? message.getTimeStamp() * 1000.0
+                                                        : juce::Time::getMillisecondCounterHiRes();
+
+    const juce::SpinLock::ScopedLockType lock(producerLock);
+
+    for (auto& mapping : mappings)
+    {
+        if (mapping.channel != 0 && !message.isForChannel(mapping.channel))
+            continue;
+
+        if (mapping.isNote)
+        {
+            if (message.isNoteOn() && message.getNoteNumber() == mapping.number)
+                pushEvent(mapping, 1.0f, arrival);
+
+            continue;
+        }
+
+        int position = -1;
+
+        if (mapping.isPitchWheel)
+        {
+            if (!message.isPitchWheel())
+                continue;
+
+            position = message.getPitchWheelValue();
+        }
+        else
+        {
+            if (!message.isController())
+                continue;
+
+            const int controller = message.getControllerNumber();
+            const int value = message.getControllerValue();
+            const bool isFourteenBit = mapping.encoding == absolute14 || mapping.encoding == relative14;
+
+            if (isFourteenBit && controller == mapping.number)
+            {
+                mapping.msb = value;
+                continue;
+            }
+
+            if (isFourteenBit && controller == mapping.number + 32)
+            {
+                position = mapping.msb * 128 + value;
+            }
+            else if (controller == mapping.number)
+            {
+                if (mapping.encoding == relative)
+                    pushEvent(mapping, (float) (value < 64 ? value : value - 128), arrival);
+                else
+                    pushEvent(mapping, (float) value / 127.0f, arrival);
+
+                continue;
+            }
+            else
+            {
+                continue;
+            }
+        }
+
+        if (mapping.encoding != relative14)
+        {
+            pushEvent(mapping, (float) position / 16383.0f, arrival);
+            continue;
+        }
+
+        // The wheel position wraps around; a step of more than half a turn went the other way
+        if (mapping.lastPosition >= 0)
+        {
+            int change = position - mapping.lastPosition;
+
+            if (change > 8192)
+                change -= 16384;
+            else if (change < -8192)
+                change += 16384;
+
+            // In the ticks of a 7 bit wheel, so both kinds of jog feel the same
+            pushEvent(mapping, (float) change / 128.0f, arrival);
+        }
+
+        mapping.lastPosition = position;
+    }
+}
+
+void MidiControl::pushEvent(const Mapping& mapping, float value, double arrivalMilliseconds)
+{
+    int start1, size1, start2, size2;
+    queue.prepareToWrite(1, start1, size1, start2, size2);
+
+    if (size1 + size2 == 0)
+    {
+        ++droppedEvents;
+        return;
+    }
+
+    queuedEvents[size1 > 0 ? start1 : start2] = { arrivalMilliseconds, value, (juce::uint8) mapping.deck,
+                                                  (juce::uint8) mapping.target, 0 };
+    queue.finishedWrite(1);
+}
+
+// Function: beginBlock
+// Purpose: An event that arrived a fraction into the last block's duration gets the same
+//          fraction into this block, so the latency is one block for every event. Events from
+//          before that, after a late callback, are applied at the start. Jog nudges die away
+//          here, once per block.
+void MidiControl::beginBlock(int numSamples) noexcept
+{
+    blockStartMilliseconds = juce::Time::getMillisecondCounterHiRes();
+    const double blockMilliseconds = numSamples * 1000.0 / currentSampleRate;
+    const double windowStart = blockStartMilliseconds - blockMilliseconds;
+
+    for (int deck = 0; deck < numDecks; ++deck)
+    {
+        if (jogNudge[deck] == 0.0f)
+            continue;
+
+        jogNudge[deck] *= (float) std::exp(-blockMilliseconds * 0.001 / jogDecaySeconds);
+
+        if (std::abs(jogNudge[deck]) < 1.0e-4f)
+            jogNudge[deck] = 0.0f;
+
+        applyJog(deck);
+    }
+
+    int start1, size1, start2, size2;
+    queue.prepareToRead(juce::jmin(queue.getNumReady(), maxEventsPerBlock), start1, size1, start2, size2);
+
+    numBlockEvents = 0;
+    nextBlockEvent = 0;
+    int lastOffset = 0;
+
+    auto takeEvents = [&](int start, int size)
+    {
+        for (int index = start; index < start + size; ++index)
+        {
+            auto event = queuedEvents[index];
+            const int offset = juce::roundToInt((event.arrivalMilliseconds - windowStart) / blockMilliseconds * numSamples);
+
+            // Messages from several devices may arrive slightly out of order; keep the block's order
+            event.sampleOffset = juce::jlimit(lastOffset, juce::jmax(lastOffset, numSamples - 1), offset);
+            lastOffset = event.sampleOffset;
+            blockEvents[numBlockEvents++] = event;
+        }
+    };
+
+    takeEvents(start1, size1);
+    takeEvents(start2, size2);
+    queue.finishedRead(size1 + size2);
+
+    if (droppedEvents.load(std::memory_order_relaxed) > 0)
+        RT_LOG_RATE_LIMITED(warning, 5000, "MidiControl queue was full, events dropped:", droppedEvents.load());
+}
+
+int MidiControl::applyEventsAt(int offset) noexcept
+{
+    while (nextBlockEvent < numBlockEvents && blockEvents[nextBlockEvent].sampleOffset <= offset)
+        applyEvent(blockEvents[nextBlockEvent++]);
+
+    if (nextBlockEvent == numBlockEvents)
+        return std::numeric_limits<int>::max();
+
+    return blockEvents[nextBlockEvent].sampleOffset - offset;
+}
+
+// Function: applyEvent
+// Purpose: Applies one event to its deck through the setters the sliders use, which are safe
+//          on the audio thread. Starting a stopped transport is left to the message thread.
+void MidiControl::applyEvent(const Event& event) noexcept
+{
+    const double latency = blockStartMilliseconds + event.sampleOffset * 1000.0 / currentSampleRate - event.arrivalMilliseconds;
+    latencyEvents.store(latencyEvents.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    latencySum.store(latencySum.load(std::memory_order_relaxed) + latency, std::memory_order_relaxed);
+
+    if (latency > maxLatency.load(std::memory_order_relaxed))
+        maxLatency.store(latency, std::memory_order_relaxed);
+
+    const int deck = event.deck;
+    auto* player = players[deck];
+
+    if (player == nullptr)
+        return;
+
+    auto& processor = player->getAudioProcessor();
+    const float value = event.value;
+
+    switch (event.target)
+    {
+        case play:
+            if (player->isHeld())
+                player->setHeld(false);
+            else if (player->isPlaying())
+                player->setHeld(true);
+            else
+                startRequested[deck] = true;
+
+            player->recordParameterEvent("midiPlay", player->isHeld() ? 0.0 : 1.0);
+            return;
+
+        case cue:
+            player->setHeld(true);
+            cueRequested[deck] = true;
+            player->recordParameterEvent("midiCue", 1.0);
+            return;
+
+        case jog:
+            jogNudge[deck] = juce::jlimit(-0.9f, 0.9f, jogNudge[deck] + value * jogSensitivity);
+            applyJog(deck);
+            return;
+
+        case gain:          processor.setGain(value); break;
+        case speed:         player->setSpeed(0.25 * std::pow(16.0, (double) value)); break;
+        case lowPass:       processor.setLowPassFrequency(toFrequency(value)); break;
+        case bandPass:      processor.setBandPassFrequency(toFrequency(value)); break;
+        case highPass:      processor.setHighPassFrequency(toFrequency(value)); break;
+        case lowBand:       processor.setLowBandGain(2.0 * value); break;
+        case midBand:       processor.setMidBandGain(2.0 * value); break;
+        case highBand:      processor.setHighBandGain(2.0 * value); break;
+        default:            return;
+    }
+
+    if (event.target != speed)
+        player->recordParameterEvent(targetNames[event.target], value);
+
+    sliderValues[deck][event.target].store(value, std::memory_order_relaxed);
+    sliderPending[deck][event.target].store(true, std::memory_order_release);
+}
+
+// The nudge scales the deck's speed setting until it has died away
+void MidiControl::applyJog(int deck) noexcept
+{
+    if (auto* player = players[deck])
+        player->setPlaybackRatio(player->getSpeed() * (1.0 + jogNudge[deck]));
+}
+
+double MidiControl::getMeanLatencyMilliseconds() const noexcept
+{
+    const int events = latencyEvents.load();
+    return events > 0 ? latencySum.load() / events : 0.0;
+}
+
+void MidiControl::resetLatency() noexcept
+{
+    latencyEvents = 0;
+    latencySum = 0.0;
+    maxLatency = 0.0;
+}
+
+// Function: timerCallback
+// Purpose: Moves the sliders to where the controller put them, without notifying the deck
+//          again, and starts or cues the transports the audio thread asked for.
+void MidiControl::timerCallback()
+{
+    for (int deck = 0; deck < numDecks; ++deck)
+    {
+        if (players[deck] != nullptr && startRequested[deck].exchange(false))
+            players[deck]->play();
+
+        if (players[deck] != nullptr && cueRequested[deck].exchange(false))
+            players[deck]->setPositionRelative(0.0);
+
+        auto* deckGUI = deckGUIs[deck];
+
+        if (deckGUI == nullptr)
+            continue;
+
+        juce::Slider* sliders[numTargets] = { nullptr, nullptr, &deckGUI->volSlider, &deckGUI->speedSlider,
+                                              &deckGUI->lowPassSlider, &deckGUI->bandPassSlider, &deckGUI->highPassSlider,
+                                              &deckGUI->lowBandSlider, &deckGUI->midBandSlider, &deckGUI->highBandSlider,
+                                              nullptr };
+
+        for (int target = 0; target < numTargets; ++target)
+        {
+            if (sliders[target] == nullptr || !sliderPending[deck][target].exchange(false, std::memory_order_acquire))
+                continue;
+
+            const float value = sliderValues[deck][target].load(std::memory_order_relaxed);
+            double sliderValue = 2.0 * value;
+
+            if (target == gain)
+                sliderValue = value;
+            else if (target == speed)
+                sliderValue = 0.25 * std::pow(16.0, (double) value);
+            else if (target == lowPass || target == bandPass || target == highPass)
+                sliderValue = toFrequency(value);
+
+            sliders[target]->setValue(sliderValue, juce::dontSendNotification);
+        }
+    }
+}
+
+bool MidiControl::isLatencyCheck(const juce::StringArray& arguments)
+{
+    return arguments.size() >= 1 && arguments[0] == latencyCheckOption;
+}
+
+// Function: runLatencyCheck
+// Purpose: The injecting thread sends a controller message every few milliseconds with its
+//          arrival time stamped like a device does. This thread plays the audio device: it
+//          waits for each block's deadline, then takes and applies the events like
+//          MainComponent does, which records every event's latency.
+int MidiControl::runLatencyCheck(const juce::StringArray& arguments)
+{
+    const int blockSize = arguments.size() > 1 ? juce::jlimit(16, 4096, arguments[1].getIntValue()) : 256;
+    const int numEvents = arguments.size() > 2 ? juce::jmax(1, arguments[2].getIntValue()) : 1000;
+    const double sampleRate = 48000.0;
+    const double blockMilliseconds = blockSize * 1000.0 / sampleRate;
+
+    MidiControl control(nullptr, nullptr, nullptr, nullptr);
+    control.prepare(sampleRate);
+
+    Mapping mapping;
+    mapping.channel = 1;
+    mapping.number = 7;
+    control.mappings.push_back(mapping);
+
+    class Injector : public juce::Thread
+    {
+    public:
+        Injector(MidiControl& controlToUse, int eventsToSend)
+            : juce::Thread("MIDI injector"), control(controlToUse), numEvents(eventsToSend) {}
+
+        void run() override
+        {
+            juce::Random random;
+
+            for (int index = 0; index < numEvents && !threadShouldExit(); ++index)
+            {
+                wait(random.nextInt({ 1, 8 }));
+                auto message = juce::MidiMessage::controllerEvent(1, 7, index % 128);
+                message.setTimeStamp(juce::Time::getMillisecondCounterHiRes() * 0.001);
+                control.handleIncomingMidiMessage(nullptr, message);
+            }
+        }
+
+    private:
+        MidiControl& control;
+        const int numEvents;
+    };
+
+    Injector injector(control, numEvents);
+    injector.startThread(juce::Thread::Priority::high);
+
+    double deadline = juce::Time::getMillisecondCounterHiRes();
+    double maxLateness = 0.0;
+
+    while (injector.isThreadRunning() || control.queue.getNumReady() > 0)
+    {
+        deadline += blockMilliseconds;
+
+        // Sleeps most of the way and yields the rest, so the injecting thread still gets to run
+        while (juce::Time::getMillisecondCounterHiRes() < deadline)
+        {
+            if (deadline - juce::Time::getMillisecondCounterHiRes() > 2.0)
+                juce::Thread::sleep(1);
+            else
+                juce::Thread::yield();
+        }
+
+        // A late callback delays its events by as much; a real device's would too
+        maxLateness = juce::jmax(maxLateness, juce::Time::getMillisecondCounterHiRes() - deadline);
+        control.beginBlock(blockSize);
+
+        for (int offset = 0; offset < blockSize;)
+            offset += juce::jmin(blockSize - offset, control.applyEventsAt(offset));
+    }
+
+    std::cout << "block " << blockMilliseconds << " ms, events " << control.getLatencyEventCount()
+              << ", dropped " << control.droppedEvents.load() << "\n"
+              << "event to audio latency mean " << control.getMeanLatencyMilliseconds()
+              << " ms, max " << control.getMaxLatencyMilliseconds() << " ms\n"
+              << "latest simulated callback " << maxLateness << " ms after its deadline\n";
+
+    const bool allApplied = control.getLatencyEventCount() == numEvents && control.droppedEvents.load() == 0;
+    return allApplied && control.getMaxLatencyMilliseconds() <= 2.0 * blockMilliseconds + maxLateness ? 0 : 2;
+}
@@ -0,0 +1,182 @@
+/*
+  ==============================================================================
+    MidiControl.h
+    Created: 19 Oct 2026 5:03:44am
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <atomic>
+#include <vector>
+#include "DJAudioPlayer.h"
+#include "DeckGUI.h"
+
+// Plays the decks from MIDI controllers with sample-accurate timing.
+//
+// Messages are stamped when they arrive on the MIDI thread, turned into deck events through the
+// mapping file and queued lock-free. At the start of each audio callback the events that
+// arrived during the last callback's duration are spread over the new block at the offsets
+// matching their arrival times, so every event is heard exactly one block after it came in,
+// without jitter. MainComponent splits its chunks at the events, and the sliders follow on the
+// message thread afterwards.
+class MidiControl : public juce::MidiInputCallback,
+                    private juce::Timer
+{
+public:
+    static constexpr int numDecks = 2;
+
+    enum Target
+    {
+        play = 0,   // toggles play and pause, press only
+        cue,        // pauses and returns to the start, press only
+        gain,
+        speed,
+        lowPass,
+        bandPass,
+        highPass,
+        lowBand,
+        midBand,
+        highBand,
+        jog,        // nudges the speed by the ticks turned
+        numTargets
+    };
+
+    // How a controller's values are read. The 14 bit encodings pair a controller below 32 with
+    // the one 32 above it for the low 7 bits, or use the pitch wheel.
+    enum Encoding
+    {
+        absolute = 0,
+        absolute14,
+        relative,     // two's complement ticks, 1 to 63 forwards, 127 down to 65 backwards
+        relative14    // a 14 bit wheel position; the ticks are its change
+    };
+
+    struct Mapping
+    {
+        int channel = 0;                // 1 to 16, or 0 for any
+        bool isNote = false;            // a note, else a controller
+        bool isPitchWheel = false;
+        int number = 0;                 // note or controller number
+        int deck = 0;
+        Target target = gain;
+        Encoding encoding = absolute;
+
+        // MIDI thread state of the 14 bit encodings
+        int msb = 0;
+        int lastPosition = -1;
+    };
+
+    struct Event
+    {
+        double arrivalMilliseconds;
+        float value;
+        juce::uint8 deck;
+        juce::uint8 target;
+        int sampleOffset;
+    };
+
+    // Function: MidiControl
+    // Purpose: Starts without mappings; see loadMappings.
+    // Inputs:
+    // - DeckGUI* deckGUI1, DeckGUI* deckGUI2: The decks whose sliders follow, or nullptr.
+    // - DJAudioPlayer* player1, DJAudioPlayer* player2: The decks played, or nullptr to only
+    //   time the events, as the latency check does.
+    MidiControl(DeckGUI* deckGUI1, DeckGUI* deckGUI2, DJAudioPlayer* player1, DJAudioPlayer* player2);
+    ~MidiControl() override;
+
+    /**Enables every MIDI input of the device manager and listens to them*/
+    void openDevices(juce::AudioDeviceManager& deviceManager);
+    /**Stops listening; call before the device manager shuts down*/
+    void closeDevices(juce::AudioDeviceManager& deviceManager);
+
+    /**Returns the mapping file in the app's data folder*/
+    static juce::File getMappingFile();
+    // Function: loadMappings
+    // Purpose: Replaces the mappings with the MAP elements of a file, writing a default file
+    //          first if there is none. Message thread.
+    // Outputs: False if the file can't be read; the mappings are kept then.
+    bool loadMappings(const juce::File& file);
+
+    /**Sets the rate event times are turned into sample offsets at*/
+    void prepare(double sampleRate);
+
+    // Function: handleIncomingMidiMessage
+    // Purpose: Stamps and maps a message and queues its events. MIDI thread.
+    void handleIncomingMidiMessage(juce::MidiInput* source, const juce::MidiMessage& message) override;
+
+    // Function: beginBlock
+    // Purpose: Takes the events that arrived since the last block and gives each its offset in
+    //          this one. Audio thread only, allocation-free.
+    // Inputs:
+    // - int numSamples: The length of the device block.
+    void beginBlock(int numSamples) noexcept;
+    // Function: applyEventsAt
+    // Purpose: Applies the events due at or before an offset in the block.
+    // Outputs: The samples from the offset to the next event, or a large number if none is left.
+    int applyEventsAt(int offset) noexcept;
+
+    /**Returns the events applied and their mean and largest latency since the last reset*/
+    int getLatencyEventCount() const noexcept { return latencyEvents.load(); }
+    double getMeanLatencyMilliseconds() const noexcept;
+    double getMaxLatencyMilliseconds() const noexcept { return maxLatency.load(); }
+    void resetLatency() noexcept;
+
+    // Function: runLatencyCheck
+    // Purpose: Injects a stream of controller messages from a second thread into a simulated
+    //          audio device running in real time, and prints the event-to-audio latency.
+    // Inputs:
+    // - const juce::StringArray& arguments: --midi-latency-check, and optionally the block size
+    //   and the number of events.
+    // Outputs: 0 if every event was applied within two blocks of its arrival, plus however late
+    //          the simulated device's latest callback was.
+    static int runLatencyCheck(const juce::StringArray& arguments);
+    /**Returns whether the app was started to check the MIDI latency*/
+    static bool isLatencyCheck(const juce::StringArray& arguments);
+
+private:
+    static constexpr int queueSize = 1024;
+    static constexpr int maxEventsPerBlock = 256;
+    // Speed change per jog tick, and how fast a nudge dies away
+    static constexpr float jogSensitivity = 0.01f;
+    static constexpr double jogDecaySeconds = 0.1;
+
+    /**Moves slider positions and requests the audio thread can't carry out itself*/
+    void timerCallback() override;
+    void pushEvent(const Mapping& mapping, float value, double arrivalMilliseconds);
+    void applyEvent(const Event& event) noexcept;
+    void applyJog(int deck) noexcept;
+    static void writeDefaultMappings(const juce::File& file);
+
+    DeckGUI* deckGUIs[numDecks];
+    DJAudioPlayer* players[numDecks];
+
+    // Guards the mappings and the writing end of the queue; only MIDI and message threads take it
+    juce::SpinLock producerLock;
+    std::vector<Mapping> mappings;
+
+    juce::AbstractFifo queue{ queueSize };
+    Event queuedEvents[queueSize];
+
+    // Audio thread only
+    double currentSampleRate = 44100.0;
+    Event blockEvents[maxEventsPerBlock];
+    int numBlockEvents = 0;
+    int nextBlockEvent = 0;
+    double blockStartMilliseconds = 0.0;
+    float jogNudge[numDecks] = { 0.0f, 0.0f };
+
+    // Values for the sliders and requests for the message thread
+    std::atomic<float> sliderValues[numDecks][numTargets];
+    std::atomic<bool> sliderPending[numDecks][numTargets];
+    std::atomic<bool> startRequested[numDecks];
+    std::atomic<bool> cueRequested[numDecks];
+
+    std::atomic<int> latencyEvents{ 0 };
+    std::atomic<double> latencySum{ 0.0 };
+    std::atomic<double> maxLatency{ 0.0 };
+    std::atomic<int> droppedEvents{ 0 };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(MidiControl)
+};
@@ -0,0 +1,213 @@
+/*
+  ==============================================================================
+    MixRecorder.cpp
+    Created: 19 Oct 2026 12:41:09am
+  ==============================================================================
+*/
+
+#include "MixRecorder.h"
+#include "AsyncLogger.h"
+#include "ThreadPolicy.h"
+
+// Constructor: Registers the formats the recorder can write
+MixRecorder::MixRecorder()
+    : juce::Thread("Mix recorder")
+{
+    formatManager.registerBasicFormats();
+}
+
+MixRecorder::~MixRecorder()
+{
+    stop();
+}
+
+// Function: prepare
+// Purpose: Stores the sample rate, stopping a recording made at another rate. The device is
+//          restarting, so the writer thread is left to close the file on its own.
+void MixRecorder::prepare(double sampleRate)
+{
+    if (recording.load() && sampleRate != currentSampleRate.load())
+    {
+        RT_LOG(warning, "MixRecorder stopped because the sample rate changed to:", sampleRate);
+        finishRecording();
+    }
+
+    currentSampleRate = sampleRate;
+}
+
+// Function: start
+// Purpose: Creates the writer for the file's format and the queue, then starts the writer thread.
+// Inputs:
+//   fileToWrite - The file to record to.
+// Outputs: Whether recording started.
+bool MixRecorder::start(const juce::File& fileToWrite)
+{
+    stop();
+
+    auto* format = formatManager.findFormatForFileExtension(fileToWrite.getFileExtension());
+
+    if (format == nullptr)
+        format = formatManager.getDefaultFormat();
+
+    fileToWrite.deleteFile();
+    std::unique_ptr<juce::OutputStream> stream(fileToWrite.createOutputStream());
+
+    if (stream == nullptr)
+        return false;
+
+    // 24 bit where the format has it; FLAC at its default compression, Ogg at its best quality
+    const int bitsPerSample = format->getPossibleBitDepths().contains(24) ? 24 : 16;
+    const auto qualityOptions = format->getQualityOptions();
+    int qualityIndex = 0;
+
+    if (fileToWrite.hasFileExtension("flac"))
+        qualityIndex = juce::jmin(5, qualityOptions.size() - 1);
+    else if (fileToWrite.hasFileExtension("ogg"))
+        qualityIndex = qualityOptions.size() - 1;
+
+    const double sampleRate = currentSampleRate.load();
+    writer.reset(format->createWriterFor(stream.get(), sampleRate, (unsigned int) numChannels,
+                                         bitsPerSample, {}, juce::jmax(0, qualityIndex)));
+
+    if (writer == nullptr)
+        return false;
+
+    stream.release(); // the writer owns it now
+
+    const int queueSize = juce::roundToInt(sampleRate * queueSeconds);
+    queue.setSize(numChannels, queueSize);
+    fifo = std::make_unique<juce::AbstractFifo>(queueSize);
+
+    recordedSampleRate = sampleRate;
+    writtenSamples = 0;
+    droppedBlocks = 0;
+    droppedSamples = 0;
+    file = fileToWrite;
+
+    startThread(juce::Thread::Priority::normal);
+    recording = true;
+
+    RT_LOG(info, "MixRecorder started, queue seconds, bits:", queueSeconds, bitsPerSample);
+    return true;
+}
+
+// Function: stop
+// Purpose: Finishes the recording and waits for the writer thread to close the file.
+void MixRecorder::stop()
+{
+    if (!isThreadRunning())
+        return;
+
+    finishRecording();
+    stopThread(10000);
+}
+
+// Function: finishRecording
+// Purpose: Stops taking blocks, waits until the audio thread has left pushBlock, then tells
+//          the writer thread to write the rest of the queue and close the file.
+void MixRecorder::finishRecording()
+{
+    recording = false;
+
+    while (audioThreadPushing.load())
+        juce::Thread::yield();
+
+    signalThreadShouldExit();
+    notify();
+}
+
+// Function: pushBlock
+// Purpose: Copies the block into the queue, or counts it as dropped if it doesn't fit. A mono
+//          buffer is written to both channels.
+void MixRecorder::pushBlock(const juce::AudioBuffer<float>& buffer, int startSample, int numSamples) noexcept
+{
+    // Announced before checking the flag, so stop can tell when the queue is no longer written
+    audioThreadPushing = true;
+
+    if (recording.load() && buffer.getNumChannels() > 0)
+    {
+        int start1, size1, start2, size2;
+        fifo->prepareToWrite(numSamples, start1, size1, start2, size2);
+
+        if (size1 + size2 < numSamples)
+        {
+            ++droppedBlocks;
+            droppedSamples += numSamples;
+        }
+        else
+        {
+            for (int channel = 0; channel < numChannels; ++channel)
+            {
+                const int sourceChannel = juce::jmin(channel, buffer.getNumChannels() - 1);
+                queue.copyFrom(channel, start1, buffer, sourceChannel, startSample, size1);
+
+                if (size2 > 0)
+                    queue.copyFrom(channel, start2, buffer, sourceChannel, startSample + size1, size2);
+            }
+
+            fifo->finishedWrite(size1 + size2);
+        }
+    }
+
+    audioThreadPushing = false;
+}
+
+// Function: getRecordedSeconds
+// Purpose: Converts the samples written to the file into seconds.
+double MixRecorder::getRecordedSeconds() const noexcept
+{
+    return (double) writtenSamples.load() / recordedSampleRate.load();
+}
+
+// Function: run
+// Purpose: Writer loop. Writes the queue a few times per second and updates the file header
+//          regularly; after the last block it closes the file, which finalises the header.
+void MixRecorder::run()
+{
+    ThreadPolicy::applyToCurrentThread(ThreadPolicy::backgroundRole, "Mix recorder");
+
+    auto lastHeaderUpdate = juce::Time::getMillisecondCounter();
+
+    while (!threadShouldExit())
+    {
+        writeQueued();
+
+        const auto now = juce::Time::getMillisecondCounter();
+
+        if (now - lastHeaderUpdate >= (juce::uint32) headerUpdateMilliseconds)
+        {
+            // WAV rewrites its header here; the stream formats have nothing to update
+            writer->flush();
+            lastHeaderUpdate = now;
+        }
+
+        wait(50);
+    }
+
+    writeQueued();
+    writer.reset();
+
+    RT_LOG(info, "MixRecorder stopped, seconds, dropped blocks:", getRecordedSeconds(), droppedBlocks.load());
+}
+
+// Function: writeQueued
+// Purpose: Encodes the ready part of the queue, in at most two pieces where it wraps around.
+void MixRecorder::writeQueued()
+{
+    int start1, size1, start2, size2;
+    fifo->prepareToRead(fifo->getNumReady(), start1, size1, start2, size2);
+
+    if (size1 + size2 == 0)
+        return;
+
+    bool written = writer->writeFromAudioSampleBuffer(queue, start1, size1);
+
+    if (size2 > 0)
+        written = writer->writeFromAudioSampleBuffer(queue, start2, size2) && written;
+
+    if (!written)
+        RT_LOG_MESSAGE_RATE_LIMITED(error, 5000, "MixRecorder could not write to the file");
+
+    fifo->finishedRead(size1 + size2);
+    writtenSamples += size1 + size2;
+}
@@ -0,0 +1,89 @@
+/*
+  ==============================================================================
+    MixRecorder.h
+    Created: 19 Oct 2026 12:41:09am
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <atomic>
+#include <memory>
+
+// Records the master mix to a WAV, FLAC or Ogg Vorbis file.
+//
+// The audio thread copies each block into a lock-free FIFO that holds several seconds of
+// audio; it never touches the disk and never waits. If the FIFO is full the block is dropped
+// and counted. A background thread encodes what is queued and, for WAV, rewrites the header
+// every few seconds so a file cut short by a crash still opens with almost all of its audio.
+// FLAC and Ogg files are streams that stay readable up to the last complete frame.
+class MixRecorder : private juce::Thread
+{
+public:
+    MixRecorder();
+    ~MixRecorder() override;
+
+    // Function: prepare
+    // Purpose: Sets the rate of the mix. A running recording is stopped if the rate changes,
+    //          since the file would otherwise play back at the wrong speed. Doesn't wait for
+    //          the file to be closed.
+    void prepare(double sampleRate);
+
+    // Function: start
+    // Purpose: Opens the file and starts recording. The format follows the file extension:
+    //          .flac, .ogg, anything else is written as WAV. Message thread only.
+    // Inputs:
+    // - const juce::File& file: The file to create; an existing file is replaced.
+    // Outputs: False if the file could not be created.
+    bool start(const juce::File& file);
+
+    // Function: stop
+    // Purpose: Stops recording, writes whatever is still queued and closes the file.
+    //          Message thread only.
+    void stop();
+
+    // Function: pushBlock
+    // Purpose: Queues a block of the mix. Audio thread only, lock-free and allocation-free.
+    void pushBlock(const juce::AudioBuffer<float>& buffer, int startSample, int numSamples) noexcept;
+
+    /**Returns whether a recording is running*/
+    bool isRecording() const noexcept { return recording.load(); }
+    /**Returns the length of the running or last recording in seconds*/
+    double getRecordedSeconds() const noexcept;
+    /**Returns how many blocks were dropped because the queue was full, since the recording started*/
+    juce::int64 getDroppedBlocks() const noexcept { return droppedBlocks.load(); }
+    /**Returns how many samples per channel were dropped, since the recording started*/
+    juce::int64 getDroppedSamples() const noexcept { return droppedSamples.load(); }
+    /**Returns the file being recorded, or the last one*/
+    juce::File getFile() const { return file; }
+
+private:
+    static constexpr int numChannels = 2;
+    static constexpr double queueSeconds = 10.0;
+    static constexpr int headerUpdateMilliseconds = 2000;
+
+    void run() override;
+    // Encodes everything in the queue; writer thread only
+    void writeQueued();
+    // Stops taking blocks and lets the writer thread close the file, without waiting for it
+    void finishRecording();
+
+    juce::AudioFormatManager formatManager;
+    std::unique_ptr<juce::AudioFormatWriter> writer;
+    juce::File file;
+
+    juce::AudioBuffer<float> queue;
+    std::unique_ptr<juce::AbstractFifo> fifo;
+    std::atomic<double> currentSampleRate{ 44100.0 };
+    // The rate of the running or last recording
+    std::atomic<double> recordedSampleRate{ 44100.0 };
+
+    std::atomic<bool> recording{ false };
+    std::atomic<bool> audioThreadPushing{ false };
+    std::atomic<juce::int64> writtenSamples{ 0 };
+    std::atomic<juce::int64> droppedBlocks{ 0 };
+    std::atomic<juce::int64> droppedSamples{ 0 };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(MixRecorder)
+};
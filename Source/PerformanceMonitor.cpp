@@ -0,0 +1,274 @@
+/*
+  ==============================================================================
+    PerformanceMonitor.cpp
+    Created: 18 Oct 2026 10:36:05pm
+  ==============================================================================
+*/
+
+#include "PerformanceMonitor.h"
+#include "AsyncLogger.h"
+#include "ThreadPolicy.h"
+
+namespace
+{
+    // About ten seconds of callbacks at 64 samples and 48 kHz, more at larger blocks
+    constexpr int callbackRecordCapacity = 8192;
+    constexpr int parameterRecordCapacity = 2048;
+
+    const char* const deckStageNames[] = { "source", "reverb", "filters", "plugins" };
+}
+
+// Constructor: Starts the polling timer and the thread that writes dumps
+PerformanceMonitor::PerformanceMonitor()
+    : juce::Thread("Flight recorder"),
+      ticksToMicroseconds(1.0e6 / (double) juce::Time::getHighResolutionTicksPerSecond()),
+      callbackRing(callbackRecordCapacity),
+      parameterRing(parameterRecordCapacity)
+{
+    startThread(juce::Thread::Priority::low);
+    startTimer(250);
+}
+
+PerformanceMonitor::~PerformanceMonitor()
+{
+    stopTimer();
+    stopThread(2000);
+}
+
+// Function: setAudioDeviceManager
+// Purpose: Stores the device manager whose device is asked for xruns.
+void PerformanceMonitor::setAudioDeviceManager(juce::AudioDeviceManager* manager)
+{
+    deviceManager = manager;
+}
+
+// Function: prepare
+// Purpose: Stores the sample rate and starts a fresh load measurement.
+void PerformanceMonitor::prepare(double sampleRate)
+{
+    currentSampleRate = sampleRate;
+    cpuLoad = 0.0f;
+    peakCpuLoad = 0.0f;
+}
+
+// Function: beginCallback
+// Purpose: Reads the clock and clears the record of the callback.
+void PerformanceMonitor::beginCallback() noexcept
+{
+    callbackStart = juce::Time::getHighResolutionTicks();
+    pendingRecord = {};
+}
+
+// Function: addDeckStageTime
+// Purpose: Adds a stage duration to its histogram and to the callback record. A deck can be
+//          called more than once per callback when the block is split, so times add up.
+void PerformanceMonitor::addDeckStageTime(int deck, DeckStage stage, juce::int64 ticks) noexcept
+{
+    if (deck < 0 || deck >= maxDecks)
+        return;
+
+    const double microseconds = (double) ticks * ticksToMicroseconds;
+    addToHistogram(deckHistograms[(size_t) deck][(size_t) stage], microseconds);
+    pendingRecord.deckMicroseconds[deck][stage] += (float) microseconds;
+}
+
+// Function: addMixTime
+// Purpose: Adds the mixing time to its histogram and to the callback record.
+void PerformanceMonitor::addMixTime(juce::int64 ticks) noexcept
+{
+    const double microseconds = (double) ticks * ticksToMicroseconds;
+    addToHistogram(mixHistogram, microseconds);
+    pendingRecord.mixMicroseconds += (float) microseconds;
+}
+
+// Function: endCallback
+// Purpose: Compares the callback time with the time the block lasts, updates the load, counts
+//          a missed deadline and asks for a dump, then stores the record.
+// Inputs:
+//   numSamples - The length of the block.
+void PerformanceMonitor::endCallback(int numSamples) noexcept
+{
+    const double microseconds = (double) (juce::Time::getHighResolutionTicks() - callbackStart) * ticksToMicroseconds;
+    const double deadlineMicroseconds = numSamples * 1.0e6 / currentSampleRate;
+    const float load = deadlineMicroseconds > 0.0 ? (float) (microseconds / deadlineMicroseconds) : 0.0f;
+
+    addToHistogram(callbackHistogram, microseconds);
+
+    // One pole average, roughly over the last hundred callbacks
+    cpuLoad = cpuLoad.load() + (load - cpuLoad.load()) * 0.01f;
+
+    if (load > peakCpuLoad.load())
+        peakCpuLoad = load;
+
+    if (load > 1.0f)
+    {
+        ++deadlineMisses;
+        lastMissTime = juce::Time::getMillisecondCounter();
+        dumpRequested = true;
+        RT_LOG_RATE_LIMITED(warning, 1000, "Audio callback missed its deadline, load:", load);
+    }
+
+    pendingRecord.time = juce::Time::getMillisecondCounterHiRes();
+    pendingRecord.totalMicroseconds = (float) microseconds;
+    pendingRecord.load = load;
+    pendingRecord.numSamples = numSamples;
+    callbackRing.push(pendingRecord);
+}
+
+// Function: recordParameterEvent
+// Purpose: Stores a control change with its time.
+void PerformanceMonitor::recordParameterEvent(int deck, const char* name, double value) noexcept
+{
+    parameterRing.push({ juce::Time::getMillisecondCounterHiRes(), name, value, deck });
+}
+
+// Function: addToHistogram
+// Purpose: Counts a duration in the bucket of its power of two in microseconds.
+void PerformanceMonitor::addToHistogram(Histogram& histogram, double microseconds) noexcept
+{
+    int bucket = 0;
+    auto whole = (juce::uint32) juce::jmin(microseconds, 4.0e9);
+
+    while (whole > 1 && bucket < numBuckets - 1)
+    {
+        whole >>= 1;
+        ++bucket;
+    }
+
+    histogram[(size_t) bucket].fetch_add(1, std::memory_order_relaxed);
+}
+
+// Function: writeHistogram
+// Purpose: Appends one histogram as "name: <2us=n <4us=n ...", leaving out empty buckets.
+void PerformanceMonitor::writeHistogram(juce::String& text, const char* name, const Histogram& histogram)
+{
+    text << name << ":";
+
+    for (int bucket = 0; bucket < numBuckets; ++bucket)
+    {
+        const auto count = histogram[(size_t) bucket].load(std::memory_order_relaxed);
+
+        if (count > 0)
+            text << " <" << juce::String(2 << bucket) << "us=" << juce::String(count);
+    }
+
+    text << "\n";
+}
+
+// Function: dumpFlightRecorder
+// Purpose: Writes a summary, the histograms, and the recorded callbacks and parameter events
+//          as tab separated lines with times relative to the dump.
+// Inputs:
+//   file - The file to create or replace.
+// Outputs: Whether the file was written.
+bool PerformanceMonitor::dumpFlightRecorder(const juce::File& file) const
+{
+    const auto callbacks = callbackRing.snapshot();
+    const auto parameters = parameterRing.snapshot();
+    const double now = juce::Time::getMillisecondCounterHiRes();
+
+    juce::String text;
+    text << "OtoDecks flight recorder, " << juce::Time::getCurrentTime().toString(true, true) << "\n"
+         << "sample rate " << juce::String(currentSampleRate)
+         << ", load " << juce::String(getCpuLoad(), 3)
+         << ", peak load " << juce::String(getPeakCpuLoad(), 3)
+         << ", deadline misses " << juce::String(getDeadlineMisses())
+         << ", device xruns " << juce::String(getDeviceXRuns()) << "\n\n";
+
+    text << "# histograms\n";
+    writeHistogram(text, "callback", callbackHistogram);
+    writeHistogram(text, "mix", mixHistogram);
+
+    for (int deck = 0; deck < maxDecks; ++deck)
+        for (int stage = 0; stage < numDeckStages; ++stage)
+            writeHistogram(text, (juce::String("deck ") + juce::String(deck + 1) + " " + deckStageNames[stage]).toRawUTF8(),
+                           deckHistograms[(size_t) deck][(size_t) stage]);
+
+    text << "\n# callbacks\nms_before_dump\tsamples\tload\ttotal_us\tmix_us";
+
+    for (int deck = 0; deck < maxDecks; ++deck)
+        for (int stage = 0; stage < numDeckStages; ++stage)
+            text << "\tdeck" << juce::String(deck + 1) << "_" << deckStageNames[stage] << "_us";
+
+    text << "\n";
+
+    for (const auto& record : callbacks)
+    {
+        text << juce::String(record.time - now, 3) << "\t" << juce::String(record.numSamples)
+             << "\t" << juce::String(record.load, 3)
+             << "\t" << juce::String(record.totalMicroseconds, 1)
+             << "\t" << juce::String(record.mixMicroseconds, 1);
+
+        for (int deck = 0; deck < maxDecks; ++deck)
+            for (int stage = 0; stage < numDeckStages; ++stage)
+                text << "\t" << juce::String(record.deckMicroseconds[deck][stage], 1);
+
+        text << "\n";
+    }
+
+    text << "\n# parameter events\nms_before_dump\tdeck\tparameter\tvalue\n";
+
+    for (const auto& record : parameters)
+    {
+        text << juce::String(record.time - now, 3) << "\t" << juce::String(record.deck + 1)
+             << "\t" << (record.name != nullptr ? record.name : "") << "\t" << juce::String(record.value) << "\n";
+    }
+
+    file.getParentDirectory().createDirectory();
+    return file.replaceWithText(text);
+}
+
+// Function: getDumpDirectory
+// Purpose: Returns the OtoDecks folder in the user's application data.
+juce::File PerformanceMonitor::getDumpDirectory()
+{
+    return juce::File::getSpecialLocation(juce::File::userApplicationDataDirectory)
+        .getChildFile("OtoDecks")
+        .getChildFile("FlightRecorder");
+}
+
+// Function: timerCallback
+// Purpose: Polls the device xrun count and, some time after a missed deadline, wakes the dump
+//          thread. Dumps are spaced out so a bad patch does not fill the disk.
+void PerformanceMonitor::timerCallback()
+{
+    if (deviceManager != nullptr)
+        if (auto* device = deviceManager->getCurrentAudioDevice())
+            deviceXRuns = device->getXRunCount();
+
+    if (!dumpRequested.load())
+        return;
+
+    const auto now = juce::Time::getMillisecondCounter();
+
+    if (now - lastMissTime.load() < (juce::uint32) dumpDelayMilliseconds)
+        return;
+
+    if (hasDumped && now - lastDumpTime < (juce::uint32) minimumDumpIntervalMilliseconds)
+        return;
+
+    dumpRequested = false;
+    hasDumped = true;
+    lastDumpTime = now;
+    notify();
+}
+
+// Function: run
+// Purpose: Writes a dump each time the timer asks for one.
+void PerformanceMonitor::run()
+{
+    ThreadPolicy::applyToCurrentThread(ThreadPolicy::backgroundRole, "Flight recorder");
+
+    while (!threadShouldExit())
+    {
+        if (!wait(-1) || threadShouldExit())
+            continue;
+
+        const auto file = getDumpDirectory().getNonexistentChildFile("flight-" + juce::Time::getCurrentTime().formatted("%Y%m%d-%H%M%S"), ".txt");
+
+        if (dumpFlightRecorder(file))
+            juce::Logger::writeToLog("Flight recorder written to " + file.getFullPathName());
+        else
+            juce::Logger::writeToLog("Flight recorder could not be written to " + file.getFullPathName());
+    }
+}
@@ -0,0 +1,211 @@
+/*
+  ==============================================================================
+    PerformanceMonitor.h
+    Created: 18 Oct 2026 10:36:05pm
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <array>
+#include <atomic>
+#include <memory>
+#include <vector>
+
+// Times the audio callback and the stages of every deck, and keeps a flight recorder of the
+// last seconds of callbacks and parameter changes.
+//
+// The audio thread only reads the high resolution clock, bumps atomic histogram counters and
+// writes fixed-size records into rings that overwrite their oldest entry. When a callback takes
+// longer than its block lasts, a dump of the recorder is written to a file a moment later, so
+// the lead-up to a glitch can be looked at after the gig. The message thread also polls the
+// xrun count the audio device reports.
+class PerformanceMonitor : private juce::Timer,
+                           private juce::Thread
+{
+public:
+    // The timed stages of a deck chain
+    enum DeckStage
+    {
+        sourceStage = 0, // transport and resampler
+        reverbStage,     // algorithmic and convolution reverb
+        filterStage,     // filters and isolator
+        pluginStage,     // hosted plugin slots
+        numDeckStages
+    };
+
+    static constexpr int maxDecks = 2;
+
+    PerformanceMonitor();
+    ~PerformanceMonitor() override;
+
+    // Function: setAudioDeviceManager
+    // Purpose: Lets the monitor poll the device's own xrun count. Message thread only.
+    void setAudioDeviceManager(juce::AudioDeviceManager* manager);
+
+    // Function: prepare
+    // Purpose: Sets the sample rate the block deadlines are worked out from.
+    void prepare(double sampleRate);
+
+    // Function: beginCallback
+    // Purpose: Marks the start of an audio callback. Audio thread only.
+    void beginCallback() noexcept;
+
+    // Function: addDeckStageTime
+    // Purpose: Adds the time one stage of one deck took. Audio thread only.
+    // Inputs:
+    // - int deck: The deck index, 0 based.
+    // - DeckStage stage: The stage.
+    // - juce::int64 ticks: Duration in high resolution ticks.
+    void addDeckStageTime(int deck, DeckStage stage, juce::int64 ticks) noexcept;
+
+    // Function: addMixTime
+    // Purpose: Adds the time the summing of the decks took. Audio thread only.
+    void addMixTime(juce::int64 ticks) noexcept;
+
+    // Function: endCallback
+    // Purpose: Closes the callback: updates the load, checks the deadline and records it.
+    // Inputs:
+    // - int numSamples: The length of the block the callback rendered.
+    void endCallback(int numSamples) noexcept;
+
+    // Function: recordParameterEvent
+    // Purpose: Adds a control change to the flight recorder. Lock-free, any thread.
+    // Inputs:
+    // - int deck: The deck index, 0 based.
+    // - const char* name: A string literal naming the control.
+    // - double value: The new value.
+    void recordParameterEvent(int deck, const char* name, double value) noexcept;
+
+    /**Average callback time as a fraction of the block duration*/
+    float getCpuLoad() const noexcept { return cpuLoad.load(); }
+    /**Highest load of a single callback since the last prepare*/
+    float getPeakCpuLoad() const noexcept { return peakCpuLoad.load(); }
+    /**Number of callbacks that took longer than their block lasts*/
+    int getDeadlineMisses() const noexcept { return deadlineMisses.load(); }
+    /**Number of xruns the audio device reported*/
+    int getDeviceXRuns() const noexcept { return deviceXRuns.load(); }
+
+    // Function: dumpFlightRecorder
+    // Purpose: Writes the histograms and the recorded callbacks and events to a text file.
+    //          Called automatically after a missed deadline. Not for the audio thread.
+    // Outputs: Whether the file was written.
+    bool dumpFlightRecorder(const juce::File& file) const;
+
+    /**The folder automatic dumps are written to*/
+    static juce::File getDumpDirectory();
+
+private:
+    // Histogram buckets are powers of two in microseconds, from below 2 us to above 8 s
+    static constexpr int numBuckets = 24;
+    using Histogram = std::array<std::atomic<juce::uint32>, numBuckets>;
+
+    // Time records are kept before and after a missed deadline
+    static constexpr int dumpDelayMilliseconds = 2000;
+    static constexpr int minimumDumpIntervalMilliseconds = 30000;
+
+    struct CallbackRecord
+    {
+        double time;          // milliseconds on the high resolution counter
+        float totalMicroseconds;
+        float mixMicroseconds;
+        float deckMicroseconds[maxDecks][numDeckStages];
+        float load;
+        int numSamples;
+    };
+
+    struct ParameterRecord
+    {
+        double time;
+        const char* name;
+        double value;
+        int deck;
+    };
+
+    // A ring with one writer at a time that overwrites its oldest record. Every slot carries a
+    // sequence number that is odd while it is being written, so a reader can skip torn records.
+    template <typename Record>
+    class FlightRing
+    {
+    public:
+        explicit FlightRing(int capacityToUse) : capacity(capacityToUse), slots(new Slot[(size_t) capacityToUse]) {}
+
+        void push(const Record& record) noexcept
+        {
+            const auto index = writeIndex.fetch_add(1, std::memory_order_relaxed);
+            auto& slot = slots[(size_t) (index % (juce::uint32) capacity)];
+
+            slot.sequence.fetch_add(1, std::memory_order_acq_rel);
+            slot.record = record;
+            slot.sequence.fetch_add(1, std::memory_order_release);
+        }
+
+        std::vector<Record> snapshot() const
+        {
+            const auto end = writeIndex.load(std::memory_order_acquire);
+            const auto count = juce::jmin(end, (juce::uint32) capacity);
+
+            std::vector<Record> records;
+            records.reserve(count);
+
+            for (auto index = end - count; index != end; ++index)
+            {
+                const auto& slot = slots[(size_t) (index % (juce::uint32) capacity)];
+                const auto before = slot.sequence.load(std::memory_order_acquire);
+                const Record copy = slot.record;
+                std::atomic_thread_fence(std::memory_order_acquire);
+
+                if ((before & 1) == 0 && slot.sequence.load(std::memory_order_relaxed) == before)
+                    records.push_back(copy);
+            }
+
+            return records;
+        }
+
+    private:
+        struct Slot
+        {
+            std::atomic<juce::uint32> sequence{ 0 };
+            Record record{};
+        };
+
+        const int capacity;
+        std::unique_ptr<Slot[]> slots;
+        std::atomic<juce::uint32> writeIndex{ 0 };
+    };
+
+    static void addToHistogram(Histogram& histogram, double microseconds) noexcept;
+    static void writeHistogram(juce::String& text, const char* name, const Histogram& histogram);
+
+    void timerCallback() override;
+    void run() override;
+
+    juce::AudioDeviceManager* deviceManager = nullptr;
+    double currentSampleRate = 44100.0;
+    double ticksToMicroseconds;
+
+    // Audio thread state for the callback in progress
+    juce::int64 callbackStart = 0;
+    CallbackRecord pendingRecord{};
+
+    // Braces zero the counters, which std::atomic's default constructor leaves undefined
+    std::array<std::array<Histogram, numDeckStages>, maxDecks> deckHistograms{};
+    Histogram mixHistogram{};
+    Histogram callbackHistogram{};
+
+    std::atomic<float> cpuLoad{ 0.0f };
+    std::atomic<float> peakCpuLoad{ 0.0f };
+    std::atomic<int> deadlineMisses{ 0 };
+    std::atomic<int> deviceXRuns{ 0 };
+
+    FlightRing<CallbackRecord> callbackRing;
+    FlightRing<ParameterRecord> parameterRing;
+
+    std::atomic<bool> dumpRequested{ false };
+    std::atomic<juce::uint32> lastMissTime{ 0 };
+    juce::uint32 lastDumpTime = 0;
+    bool hasDumped = false;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(PerformanceMonitor)
+};
@@ -13,11 +13,17 @@
 //==============================================================================
 PlaylistComponent::PlaylistComponent(DeckGUI* _deckGUI1,
     DeckGUI* _deckGUI2,
-    DJAudioPlayer* _playerForParsingMetaData
+    DJAudioPlayer* _playerForParsingMetaData,
+    AutoDJ* _autoDJ,
+    LoudnessAnalyzer* _loudnessAnalyzer,
+    BeatAnalyzer* _beatAnalyzer
 )
     : deckGUI1(_deckGUI1),
     deckGUI2(_deckGUI2),
-    playerForParsingMetaData(_playerForParsingMetaData)
+    playerForParsingMetaData(_playerForParsingMetaData),
+    autoDJ(_autoDJ),
+    loudnessAnalyzer(_loudnessAnalyzer),
+    beatAnalyzer(_beatAnalyzer)
 {
     // Child components and initial settings setup (Self-written section)
     addAndMakeVisible(importButton);
@@ -25,11 +31,20 @@ PlaylistComponent::PlaylistComponent(DeckGUI* _deckGUI1,
     addAndMakeVisible(library);
     addAndMakeVisible(addToPlayer1Button);
     addAndMakeVisible(addToPlayer2Button);
+    addAndMakeVisible(queueButton);
+    addAndMakeVisible(autoDJButton);
 
     importButton.addListener(this);
     searchField.addListener(this);
     addToPlayer1Button.addListener(this);
     addToPlayer2Button.addListener(this);
+    queueButton.addListener(this);
+    autoDJButton.addListener(this);
+
+    // The queue column shows each track's place in the Auto-DJ queue
+    autoDJButton.setClickingTogglesState(true);
+    autoDJButton.setColour(juce::TextButton::buttonOnColourId, juce::Colours::orange);
+    autoDJ->onQueueChanged = [this] { library.repaint(); };
 
     searchField.setTextToShowWhenEmpty("Search Tracks (enter to submit)", juce::Colours::orange);
     searchField.onReturnKey = [this] { searchLibrary(searchField.getText()); };
@@ -38,6 +53,11 @@ PlaylistComponent::PlaylistComponent(DeckGUI* _deckGUI1,
     library.getHeader().addColumn("Tracks", 1, 1);
     library.getHeader().addColumn("Length", 2, 1);
     library.getHeader().addColumn("", 3, 1);
+    library.getHeader().addColumn("#", 4, 1);
+    // Integrated loudness, blank until the track is analyzed
+    library.getHeader().addColumn("LUFS", 5, 1, 30, -1, juce::TableHeaderComponent::defaultFlags, 2);
+    // Tempo, blank until the track is analyzed or if it has no steady beat
+    library.getHeader().addColumn("BPM", 6, 1, 30, -1, juce::TableHeaderComponent::defaultFlags, 3);
     library.setModel(this);
     loadLibrary();
 }
@@ -45,6 +65,7 @@ PlaylistComponent::PlaylistComponent(DeckGUI* _deckGUI1,
 PlaylistComponent::~PlaylistComponent()
 {
     // Self-written destructor
+    autoDJ->onQueueChanged = nullptr;
     saveLibrary();
 }
 
@@ -71,15 +92,20 @@ void PlaylistComponent::resized()
 {
     // Setting the bounds for each component (Self-written section)
     importButton.setBounds(0, 0, getWidth(), getHeight() / 16);
-    library.setBounds(0, 1 * getHeight() / 16, getWidth(), 13 * getHeight() / 16);
+    library.setBounds(0, 1 * getHeight() / 16, getWidth(), 12 * getHeight() / 16);
+    queueButton.setBounds(0, 13 * getHeight() / 16, getWidth() / 2, getHeight() / 16);
+    autoDJButton.setBounds(getWidth() / 2, 13 * getHeight() / 16, getWidth() / 2, getHeight() / 16);
     searchField.setBounds(0, 14 * getHeight() / 16, getWidth(), getHeight() / 16);
     addToPlayer1Button.setBounds(0, 15 * getHeight() / 16, getWidth() / 2, getHeight() / 16);
     addToPlayer2Button.setBounds(getWidth() / 2, 15 * getHeight() / 16, getWidth() / 2, getHeight() / 16);
 
     // Setting column widths (Self-written section)
-    library.getHeader().setColumnWidth(1, 12.8 * getWidth() / 20);
-    library.getHeader().setColumnWidth(2, 5 * getWidth() / 20);
+    library.getHeader().setColumnWidth(1, 6.8 * getWidth() / 20);
+    library.getHeader().setColumnWidth(2, 3 * getWidth() / 20);
+    library.getHeader().setColumnWidth(5, 3 * getWidth() / 20);
+    library.getHeader().setColumnWidth(6, 3 * getWidth() / 20);
     library.getHeader().setColumnWidth(3, 2 * getWidth() / 20);
+    library.getHeader().setColumnWidth(4, 2 * getWidth() / 20);
 }
 
 int PlaylistComponent::getNumRows()
@@ -114,6 +140,43 @@ void PlaylistComponent::paintCell(juce::Graphics& g, int rowNumber, int columnId
         {
             g.drawText(tracks[rowNumber].length, 2, 0, width - 4, height, juce::Justification::centred, true);
         }
+        if (columnId == 5)
+        {
+            LoudnessAnalyzer::Result result;
+            if (loudnessAnalyzer->getResult(tracks[rowNumber].file, tracks[rowNumber].size, tracks[rowNumber].modified, result) && result.hasAudio)
+            {
+                g.drawText(juce::String(result.integratedLoudness, 1), 2, 0, width - 4, height, juce::Justification::centred, true);
+            }
+        }
+        if (columnId == 6)
+        {
+            BeatAnalyzer::Result result;
+            if (beatAnalyzer->getResult(tracks[rowNumber].file, tracks[rowNumber].size, tracks[rowNumber].modified, result) && result.hasBeat)
+            {
+                g.drawText(juce::String(result.bpm, 1), 2, 0, width - 4, height, juce::Justification::centred, true);
+            }
+        }
+        if (columnId == 4)
+        {
+            int queuePosition{ autoDJ->getQueuePosition(tracks[rowNumber].URL) };
+            if (queuePosition != -1)
+            {
+                g.drawText(juce::String(queuePosition + 1), 2, 0, width - 4, height, juce::Justification::centred, true);
+            }
+        }
+    }
+}
+
+// Restamps the analyzed file's rows, in case it changed since it was imported, and repaints only those
+void PlaylistComponent::trackAnalyzed(const juce::File& file)
+{
+    for (int row = 0; row < getNumRows(); ++row)
+    {
+        if (tracks[row].file == file)
+        {
+            tracks[row].updateStamp();
+            library.repaintRow(row);
+        }
     }
 }
 
@@ -157,6 +220,18 @@ void PlaylistComponent::buttonClicked(juce::Button* button)
         DBG("Add to Player 2 clicked");
         loadInPlayer(deckGUI2);
     }
+    // If the queue button is clicked, adds the selected track to the end of the Auto-DJ queue.
+    else if (button == &queueButton)
+    {
+        DBG("Queue clicked");
+        addToQueue();
+    }
+    // If the Auto-DJ button is toggled, starts or stops the automatic set.
+    else if (button == &autoDJButton)
+    {
+        DBG("Auto DJ toggled");
+        autoDJ->setEnabled(autoDJButton.getToggleState());
+    }
     // For other buttons, retrieves the ID of the button clicked, logs the track removal and removes the track from the tracks vector, and updates the library content.
     else
     {
@@ -188,6 +263,27 @@ void PlaylistComponent::loadInPlayer(DeckGUI* deckGUI)
     }
 }
 
+// This function adds the selected track to the Auto-DJ queue, which plays it after the tracks queued before it.
+// If no track is selected, it displays the same alert as loading a deck.
+void PlaylistComponent::addToQueue()
+{
+    int selectedRow{ library.getSelectedRow() };
+    if (selectedRow != -1)
+    {
+        DBG("Queueing: " << tracks[selectedRow].title);
+        autoDJ->addToQueue(tracks[selectedRow].URL);
+    }
+    else
+    {
+        juce::AlertWindow::showMessageBoxAsync(juce::AlertWindow::InfoIcon,
+            "Queue Information",
+            "Please select a track to queue",
+            "OK",
+            nullptr,
+            new AlertCallback(this));
+    }
+}
+
 void PlaylistComponent::importToLibrary()
 {
     DBG("PlaylistComponent::importToLibrary called");
@@ -205,6 +301,8 @@ void PlaylistComponent::importToLibrary()
                 juce::URL audioURL{ file };
                 newTrack.length = getLength(audioURL);
                 tracks.push_back(newTrack);
+                loudnessAnalyzer->analyze(file);
+                beatAnalyzer->analyze(file);
                 DBG("loaded file: " << newTrack.title);
             }
             else // display info message
@@ -311,6 +409,8 @@ void PlaylistComponent::loadLibrary()
             getline(myLibrary, length);
             newTrack.length = length;
             tracks.push_back(newTrack);
+            loudnessAnalyzer->analyze(file);
+            beatAnalyzer->analyze(file);
         }
     }
     myLibrary.close();
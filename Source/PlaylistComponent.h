@@ -17,6 +17,9 @@
 #include "Track.h"
 #include "DeckGUI.h"
 #include "DJAudioPlayer.h"
+#include "AutoDJ.h"
+#include "LoudnessAnalyzer.h"
+#include "BeatAnalyzer.h"
 
 //==============================================================================
 /*
@@ -29,7 +32,10 @@ class PlaylistComponent  : public juce::Component,
 public:
     PlaylistComponent(DeckGUI* _deckGUI1, 
                       DeckGUI* _deckGUI2, 
-                      DJAudioPlayer* _playerForParsingMetaData
+                      DJAudioPlayer* _playerForParsingMetaData,
+                      AutoDJ* _autoDJ,
+                      LoudnessAnalyzer* _loudnessAnalyzer,
+                      BeatAnalyzer* _beatAnalyzer
                      );
     ~PlaylistComponent() override;
 
@@ -58,6 +64,8 @@ public:
                                        bool isRowSelected, 
                                        Component* existingComponentToUpdate) override;
     void buttonClicked(juce::Button* button) override;
+    /**Repaints the rows of a file an analyzer has just finished*/
+    void trackAnalyzed(const juce::File& file);
 private:
     std::vector<Track> tracks;
     
@@ -66,10 +74,15 @@ private:
     juce::TableListBox library;
     juce::TextButton addToPlayer1Button{ "ADD TO DECK 1" };
     juce::TextButton addToPlayer2Button{ "ADD TO DECK 2" };
+    juce::TextButton queueButton{ "QUEUE" };
+    juce::TextButton autoDJButton{ "AUTO DJ" };
 
     DeckGUI* deckGUI1;
     DeckGUI* deckGUI2;
     DJAudioPlayer* playerForParsingMetaData;
+    AutoDJ* autoDJ;
+    LoudnessAnalyzer* loudnessAnalyzer;
+    BeatAnalyzer* beatAnalyzer;
     
     juce::String getLength(juce::URL audioURL);
     juce::String secondsToMinutes(double seconds);
@@ -82,6 +95,7 @@ private:
     bool isInTracks(juce::String fileNameWithoutExtension);
     int whereInTracks(juce::String searchText);
     void loadInPlayer(DeckGUI* deckGUI);
+    void addToQueue();
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (PlaylistComponent)
 };
@@ -0,0 +1,247 @@
+/*
+  ==============================================================================
+    PluginChain.cpp
+    Created: 19 Oct 2026 3:02:48am
+  ==============================================================================
+*/
+
+#include "PluginChain.h"
+#include "AsyncLogger.h"
+
+PluginChain::PluginChain()
+{
+    for (int slot = 0; slot < numSlots; ++slot)
+    {
+        pluginChangePending[slot] = false;
+        bypassed[slot] = false;
+        loads[slot] = 0.0f;
+        peakLoads[slot] = 0.0f;
+    }
+
+    // Room for the events a plugin may add while processing, so clearing never frees it
+    midiBuffer.ensureSize(2048);
+}
+
+PluginChain::~PluginChain()
+{
+}
+
+// Function: reserveScratch
+// Purpose: Reserves the channels a plugin processes in; the deck's or mix's channels are
+//          copied in and out, so plugins with side-chains or more outputs still fit.
+// Inputs:
+//   arena - The owner's arena, not yet allocated.
+//   maximumBlockSize - The agreed maximum block size.
+void PluginChain::reserveScratch(ScratchArena& arena, int maximumBlockSize)
+{
+    scratch = &arena;
+    pluginScratch = arena.reserve(maxPluginChannels, juce::jmax(1, maximumBlockSize));
+}
+
+// Function: prepareToPlay
+// Purpose: Prepares the active plugins and any plugin waiting to be picked up. The audio
+//          callback isn't running while the device is being prepared.
+void PluginChain::prepareToPlay(int newMaximumBlockSize, double sampleRate)
+{
+    currentSampleRate = sampleRate;
+    maximumBlockSize = juce::jmax(1, newMaximumBlockSize);
+
+    const juce::SpinLock::ScopedLockType lock(pluginLock);
+
+    for (int slot = 0; slot < numSlots; ++slot)
+    {
+        if (activePlugins[slot] != nullptr)
+            activePlugins[slot]->prepareToPlay(sampleRate, maximumBlockSize);
+
+        if (standbyPlugins[slot] != nullptr)
+            standbyPlugins[slot]->prepareToPlay(sampleRate, maximumBlockSize);
+    }
+}
+
+void PluginChain::releaseResources()
+{
+    const juce::SpinLock::ScopedLockType lock(pluginLock);
+
+    for (auto& plugin : activePlugins)
+        if (plugin != nullptr)
+            plugin->releaseResources();
+
+    scratch = nullptr;
+    pluginScratch = -1;
+    maximumBlockSize = 0;
+}
+
+// Function: process
+// Purpose: Picks up new plugins and runs every slot over the block.
+void PluginChain::process(juce::AudioBuffer<float>& buffer, int startSample, int numSamples) noexcept
+{
+    if (anyPluginChangePending.load())
+        swapPendingPlugins();
+
+    if (scratch == nullptr || buffer.getNumChannels() == 0)
+        return;
+
+    int latency = 0;
+
+    for (int slot = 0; slot < numSlots; ++slot)
+    {
+        if (activePlugins[slot] == nullptr)
+            continue;
+
+        for (int offset = 0; offset < numSamples; offset += maximumBlockSize)
+            processSlot(slot, buffer, startSample + offset, juce::jmin(maximumBlockSize, numSamples - offset));
+
+        latency += activePlugins[slot]->getLatencySamples();
+    }
+
+    reportedLatency.store(latency, std::memory_order_relaxed);
+}
+
+// Function: getLatencySamples
+// Purpose: Sums the latency every plugin reports now; a plugin may change it at any time.
+int PluginChain::getLatencySamples() const noexcept
+{
+    int latency = 0;
+
+    for (auto& plugin : activePlugins)
+        if (plugin != nullptr)
+            latency += plugin->getLatencySamples();
+
+    return latency;
+}
+
+// Function: setPlugin
+// Purpose: Sets the plugin up for stereo and for the chain's rate and block size, then hands
+//          it to the audio thread. The plugin this replaces earlier is destroyed here.
+bool PluginChain::setPlugin(int slot, std::unique_ptr<juce::AudioPluginInstance> plugin)
+{
+    jassert(slot >= 0 && slot < numSlots);
+
+    if (plugin != nullptr)
+    {
+        // Not every plugin accepts stereo on its main buses; those keep their own layout
+        auto layout = plugin->getBusesLayout();
+
+        if (layout.inputBuses.size() > 0)
+            layout.inputBuses.getReference(0) = juce::AudioChannelSet::stereo();
+        if (layout.outputBuses.size() > 0)
+            layout.outputBuses.getReference(0) = juce::AudioChannelSet::stereo();
+
+        plugin->setBusesLayout(layout);
+
+        if (plugin->getTotalNumInputChannels() > maxPluginChannels || plugin->getTotalNumOutputChannels() > maxPluginChannels)
+            return false;
+
+        plugin->enableAllBuses();
+
+        if (maximumBlockSize > 0)
+            plugin->prepareToPlay(currentSampleRate, maximumBlockSize);
+    }
+
+    slotPlugins[slot] = plugin.get();
+    loads[slot] = 0.0f;
+    peakLoads[slot] = 0.0f;
+
+    std::unique_ptr<juce::AudioPluginInstance> retiredPlugin;
+
+    {
+        const juce::SpinLock::ScopedLockType lock(pluginLock);
+        retiredPlugin = std::move(standbyPlugins[slot]);
+        standbyPlugins[slot] = std::move(plugin);
+        pluginChangePending[slot] = true;
+        anyPluginChangePending = true;
+    }
+
+    if (retiredPlugin != nullptr)
+        retiredPlugin->releaseResources();
+
+    return true;
+}
+
+void PluginChain::resetPeakLoads()
+{
+    for (auto& peak : peakLoads)
+        peak = 0.0f;
+}
+
+void PluginChain::swapPendingPlugins() noexcept
+{
+    const juce::SpinLock::ScopedTryLockType lock(pluginLock);
+
+    if (!lock.isLocked())
+        return;
+
+    for (int slot = 0; slot < numSlots; ++slot)
+    {
+        if (pluginChangePending[slot].load())
+        {
+            std::swap(activePlugins[slot], standbyPlugins[slot]);
+            pluginChangePending[slot] = false;
+        }
+    }
+
+    anyPluginChangePending = false;
+}
+
+// Function: processSlot
+// Purpose: Copies the block into the plugin's buffer, lets the plugin process it and copies
+//          the main outputs back. Extra input channels, like a side-chain, get silence. The
+//          time the plugin took is kept as a share of the block's duration.
+void PluginChain::processSlot(int slot, juce::AudioBuffer<float>& buffer, int startSample, int numSamples) noexcept
+{
+    auto& plugin = *activePlugins[slot];
+    const int inputs = plugin.getTotalNumInputChannels();
+    const int outputs = plugin.getTotalNumOutputChannels();
+    const int pluginChannels = juce::jmin(maxPluginChannels, juce::jmax(inputs, outputs, 1));
+
+    float* channels[maxPluginChannels];
+
+    for (int channel = 0; channel < pluginChannels; ++channel)
+    {
+        channels[channel] = scratch->getChannelPointer(pluginScratch, channel);
+
+        if (channel < juce::jmin(inputs, 2))
+            juce::FloatVectorOperations::copy(channels[channel],
+                                              buffer.getReadPointer(juce::jmin(channel, buffer.getNumChannels() - 1), startSample),
+                                              numSamples);
+        else
+            juce::FloatVectorOperations::clear(channels[channel], numSamples);
+    }
+
+    // Refers to the arena; with this few channels the buffer doesn't allocate its channel list
+    juce::AudioBuffer<float> pluginBuffer(channels, pluginChannels, numSamples);
+    midiBuffer.clear();
+
+    const auto start = juce::Time::getHighResolutionTicks();
+
+    if (bypassed[slot].load())
+        plugin.processBlockBypassed(pluginBuffer, midiBuffer);
+    else
+        plugin.processBlock(pluginBuffer, midiBuffer);
+
+    const double seconds = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - start);
+    const float load = (float) (seconds * currentSampleRate / numSamples);
+
+    loads[slot].store(loads[slot].load(std::memory_order_relaxed) * 0.9f + load * 0.1f, std::memory_order_relaxed);
+
+    if (load > peakLoads[slot].load(std::memory_order_relaxed))
+        peakLoads[slot].store(load, std::memory_order_relaxed);
+
+    if (load > 0.5f)
+        RT_LOG_RATE_LIMITED(warning, 5000, "PluginChain slot took more than half the block, slot and share:", slot + 1, load);
+
+    // A plugin without outputs, like an analyser, leaves the signal as it was
+    if (outputs == 0)
+        return;
+
+    // Non-finite output would stay in the plugin's state, so the block passes dry and the
+    // plugin starts over. Hosts call reset from the audio thread too.
+    if (signalGuard.check(slot, pluginBuffer, 0, numSamples))
+    {
+        plugin.reset();
+        return;
+    }
+
+    for (int channel = 0; channel < buffer.getNumChannels(); ++channel)
+        buffer.copyFrom(channel, startSample, pluginBuffer, juce::jmin(channel, outputs - 1), 0, numSamples);
+}
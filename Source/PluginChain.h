@@ -0,0 +1,106 @@
+/*
+  ==============================================================================
+    PluginChain.h
+    Created: 19 Oct 2026 3:02:48am
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <atomic>
+#include <memory>
+#include "ScratchArena.h"
+#include "SignalGuard.h"
+
+// A row of insert slots for hosted VST3 or LV2 effects, used on each deck and on the master bus.
+//
+// The slots are processed in order on the audio thread. Plugins are created and prepared on
+// the message thread and handed over like the convolution engines: the audio thread owns the
+// active plugins, and a replaced plugin is released and destroyed on the message thread.
+// Each slot measures how long its plugin takes and keeps that as a share of the block's
+// duration, so a plugin that eats the audio budget shows up by name. A plugin whose output
+// isn't finite is left out of that block and reset.
+class PluginChain
+{
+public:
+    static constexpr int numSlots = 4;
+    // Plugins with more channels than this, side-chains included, are refused
+    static constexpr int maxPluginChannels = 8;
+
+    PluginChain();
+    ~PluginChain();
+
+    /**Reserves the buffer plugins process in, in the owner's arena, before prepareToPlay*/
+    void reserveScratch(ScratchArena& arena, int maximumBlockSize);
+
+    // Function: prepareToPlay
+    // Purpose: Prepares every plugin for the rate and the largest block the chain is handed.
+    void prepareToPlay(int maximumBlockSize, double sampleRate);
+    void releaseResources();
+
+    // Function: process
+    // Purpose: Runs the block through every slot in place. Blocks longer than the prepared size
+    //          are processed in pieces. Audio thread only; the chain itself doesn't lock or
+    //          allocate, what the plugins do is up to them.
+    void process(juce::AudioBuffer<float>& buffer, int startSample, int numSamples) noexcept;
+
+    /**Returns the latency of the whole chain in samples. Audio thread only*/
+    int getLatencySamples() const noexcept;
+    /**Returns the latency measured in the last block, for display*/
+    int getReportedLatencySamples() const noexcept { return reportedLatency.load(); }
+
+    // Function: setPlugin
+    // Purpose: Puts a plugin in a slot, or empties it with nullptr. The plugin is set to stereo
+    //          where it allows it and prepared before the audio thread sees it. Message thread only.
+    // Outputs: False if the plugin has more channels than the chain can give it.
+    bool setPlugin(int slot, std::unique_ptr<juce::AudioPluginInstance> plugin);
+    /**Returns the plugin in a slot, or nullptr. Message thread only*/
+    juce::AudioPluginInstance* getPlugin(int slot) const noexcept { return slotPlugins[slot]; }
+
+    /**Bypasses a slot through the plugin's own bypass processing, which keeps its latency*/
+    void setBypassed(int slot, bool shouldBeBypassed) { bypassed[slot] = shouldBeBypassed; }
+    bool isBypassed(int slot) const noexcept { return bypassed[slot].load(); }
+
+    /**Returns the smoothed processing time of a slot as a share of the block duration*/
+    float getLoad(int slot) const noexcept { return loads[slot].load(); }
+    /**Returns the highest share of the block duration a slot took since resetPeakLoads*/
+    float getPeakLoad(int slot) const noexcept { return peakLoads[slot].load(); }
+    void resetPeakLoads();
+
+    /**Returns the counts of denormal and non-finite blocks of each slot*/
+    const SignalGuard& getSignalGuard() const noexcept { return signalGuard; }
+
+    double getSampleRate() const noexcept { return currentSampleRate; }
+    int getMaximumBlockSize() const noexcept { return maximumBlockSize; }
+
+private:
+    // Picks up plugins set since the last block; tries again next block if the lock is taken
+    void swapPendingPlugins() noexcept;
+    void processSlot(int slot, juce::AudioBuffer<float>& buffer, int startSample, int numSamples) noexcept;
+
+    // As in ConvolutionReverbAudioSource the audio thread owns the active plugins, and a
+    // standby plugin is either waiting to be picked up or retired
+    juce::SpinLock pluginLock;
+    std::unique_ptr<juce::AudioPluginInstance> activePlugins[numSlots];
+    std::unique_ptr<juce::AudioPluginInstance> standbyPlugins[numSlots];
+    std::atomic<bool> pluginChangePending[numSlots];
+    std::atomic<bool> anyPluginChangePending{ false };
+    juce::AudioPluginInstance* slotPlugins[numSlots] = {}; // message thread view
+
+    std::atomic<bool> bypassed[numSlots];
+    std::atomic<float> loads[numSlots];
+    std::atomic<float> peakLoads[numSlots];
+    std::atomic<int> reportedLatency{ 0 };
+    SignalGuard signalGuard{ "slot 1", "slot 2", "slot 3", "slot 4" };
+
+    // The plugins' buffer lives in the owner's arena; MIDI space is allocated once
+    ScratchArena* scratch = nullptr;
+    int pluginScratch = -1;
+    juce::MidiBuffer midiBuffer;
+
+    double currentSampleRate = 44100.0;
+    int maximumBlockSize = 0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(PluginChain)
+};
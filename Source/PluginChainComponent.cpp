@@ -0,0 +1,212 @@
+/*
+  ==============================================================================
+    PluginChainComponent.cpp
+    Created: 19 Oct 2026 3:02:48am
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "PluginChainComponent.h"
+
+namespace
+{
+    // Menu ids; the known plugins use the ids from 1 up
+    const int scanItemId = 100000;
+    const int editorItemId = 1;
+    const int bypassItemId = 2;
+    const int removeItemId = 3;
+}
+
+//==============================================================================
+PluginChainComponent::EditorWindow::EditorWindow(juce::AudioProcessorEditor* editor, const juce::String& title)
+    : DocumentWindow(title, juce::Colours::darkgrey, DocumentWindow::closeButton)
+{
+    setUsingNativeTitleBar(true);
+    setContentOwned(editor, true);
+    setResizable(editor->isResizable(), false);
+    centreWithSize(getWidth(), getHeight());
+    setVisible(true);
+}
+
+void PluginChainComponent::EditorWindow::closeButtonPressed()
+{
+    setVisible(false);
+}
+
+//==============================================================================
+PluginChainComponent::PluginChainComponent(const juce::String& _name, PluginHost& _pluginHost, PluginChain& _pluginChain)
+    : pluginHost(_pluginHost),
+    pluginChain(_pluginChain)
+{
+    nameLabel.setText(_name, juce::dontSendNotification);
+    addAndMakeVisible(nameLabel);
+
+    for (int slot = 0; slot < PluginChain::numSlots; ++slot)
+    {
+        slotButtons[slot].onClick = [this, slot] { slotClicked(slot); };
+        addAndMakeVisible(slotButtons[slot]);
+    }
+
+    timerCallback();
+    startTimer(250);
+}
+
+PluginChainComponent::~PluginChainComponent()
+{
+    // Editors must go before the plugins they belong to
+    for (auto& window : editorWindows)
+        window.reset();
+}
+
+void PluginChainComponent::paint(juce::Graphics& g)
+{
+    g.fillAll(getLookAndFeel().findColour(juce::ResizableWindow::backgroundColourId));
+}
+
+void PluginChainComponent::resized()
+{
+    const int labelWidth = 60;
+    const int slotWidth = (getWidth() - labelWidth) / PluginChain::numSlots;
+
+    nameLabel.setBounds(0, 0, labelWidth, getHeight());
+    for (int slot = 0; slot < PluginChain::numSlots; ++slot)
+    {
+        slotButtons[slot].setBounds(labelWidth + slot * slotWidth + 1, 1, slotWidth - 2, getHeight() - 2);
+    }
+}
+
+// Shows each plugin's name and load; the tooltip adds the peak load and the chain latency
+void PluginChainComponent::timerCallback()
+{
+    const int latency = pluginChain.getReportedLatencySamples();
+    const double latencyMilliseconds = 1000.0 * latency / pluginChain.getSampleRate();
+
+    for (int slot = 0; slot < PluginChain::numSlots; ++slot)
+    {
+        auto* plugin = pluginChain.getPlugin(slot);
+        auto& button = slotButtons[slot];
+
+        if (plugin == nullptr)
+        {
+            button.setButtonText("+");
+            button.setTooltip("Add a plugin");
+            continue;
+        }
+
+        juce::String text{ plugin->getName() };
+        text << " " << juce::String(100.0f * pluginChain.getLoad(slot), 1) << "%";
+        if (pluginChain.isBypassed(slot))
+        {
+            text = "(" + text + ")";
+        }
+        button.setButtonText(text);
+        button.setTooltip(plugin->getName() + ", peak " + juce::String(100.0f * pluginChain.getPeakLoad(slot), 1)
+                          + "% of the block. Chain latency " + juce::String(latency) + " samples ("
+                          + juce::String(latencyMilliseconds, 1) + " ms)");
+    }
+}
+
+void PluginChainComponent::slotClicked(int slot)
+{
+    if (pluginChain.getPlugin(slot) == nullptr)
+    {
+        showPluginMenu(slot);
+    }
+    else
+    {
+        showSlotMenu(slot);
+    }
+}
+
+// Lists the known plugins by manufacturer, and a scan for new ones
+void PluginChainComponent::showPluginMenu(int slot)
+{
+    const auto types = pluginHost.getKnownPlugins().getTypes();
+
+    juce::PopupMenu menu;
+    juce::KnownPluginList::addToMenu(menu, types, juce::KnownPluginList::sortByManufacturer);
+    menu.addSeparator();
+    menu.addItem(scanItemId, pluginHost.isScanning() ? "Scanning for plugins..." : "Scan for plugins",
+                 !pluginHost.isScanning());
+
+    menu.showMenuAsync(juce::PopupMenu::Options().withTargetComponent(slotButtons[slot]),
+                       [this, slot, types](int result)
+                       {
+                           if (result == scanItemId)
+                           {
+                               pluginHost.startScan();
+                               return;
+                           }
+
+                           const int index = juce::KnownPluginList::getIndexChosenByMenu(types, result);
+                           if (index >= 0)
+                           {
+                               loadPlugin(slot, types.getReference(index));
+                           }
+                       });
+}
+
+void PluginChainComponent::showSlotMenu(int slot)
+{
+    juce::PopupMenu menu;
+    menu.addItem(editorItemId, "Show editor", pluginChain.getPlugin(slot)->hasEditor());
+    menu.addItem(bypassItemId, "Bypass", true, pluginChain.isBypassed(slot));
+    menu.addItem(removeItemId, "Remove");
+
+    menu.showMenuAsync(juce::PopupMenu::Options().withTargetComponent(slotButtons[slot]),
+                       [this, slot](int result)
+                       {
+                           if (result == editorItemId)
+                               showEditor(slot);
+                           else if (result == bypassItemId)
+                               pluginChain.setBypassed(slot, !pluginChain.isBypassed(slot));
+                           else if (result == removeItemId)
+                               removePlugin(slot);
+                       });
+}
+
+void PluginChainComponent::loadPlugin(int slot, const juce::PluginDescription& description)
+{
+    juce::String error;
+    auto plugin = pluginHost.createInstance(description, pluginChain.getSampleRate(),
+                                            juce::jmax(1, pluginChain.getMaximumBlockSize()), error);
+
+    if (plugin == nullptr)
+    {
+        juce::AlertWindow::showMessageBoxAsync(juce::AlertWindow::WarningIcon, "Plugins",
+                                               "Could not load " + description.name + ": " + error);
+        return;
+    }
+
+    editorWindows[slot].reset();
+    if (!pluginChain.setPlugin(slot, std::move(plugin)))
+    {
+        juce::AlertWindow::showMessageBoxAsync(juce::AlertWindow::WarningIcon, "Plugins",
+                                               description.name + " needs more channels than a slot has.");
+    }
+    pluginChain.setBypassed(slot, false);
+    timerCallback();
+}
+
+void PluginChainComponent::removePlugin(int slot)
+{
+    editorWindows[slot].reset();
+    pluginChain.setPlugin(slot, nullptr);
+    timerCallback();
+}
+
+void PluginChainComponent::showEditor(int slot)
+{
+    if (editorWindows[slot] == nullptr)
+    {
+        auto* plugin = pluginChain.getPlugin(slot);
+        if (auto* editor = plugin->createEditorIfNeeded())
+        {
+            editorWindows[slot] = std::make_unique<EditorWindow>(editor, plugin->getName());
+        }
+        return;
+    }
+
+    editorWindows[slot]->setVisible(true);
+    editorWindows[slot]->toFront(true);
+}
@@ -0,0 +1,56 @@
+/*
+  ==============================================================================
+    PluginChainComponent.h
+    Created: 19 Oct 2026 3:02:48am
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <memory>
+#include "PluginChain.h"
+#include "PluginHost.h"
+
+//==============================================================================
+/*
+    One row of plugin slots with a label. An empty slot offers the known plugins and a scan;
+    a loaded slot opens, bypasses or removes its plugin. Each slot shows its plugin's share of
+    the audio budget, and the tooltip its peak and the chain's latency.
+*/
+class PluginChainComponent  : public juce::Component,
+                              private juce::Timer
+{
+public:
+    PluginChainComponent(const juce::String& _name, PluginHost& _pluginHost, PluginChain& _pluginChain);
+    ~PluginChainComponent() override;
+
+    void paint (juce::Graphics&) override;
+    void resized() override;
+
+private:
+    // A window for a plugin's editor; closing it only hides it
+    class EditorWindow : public juce::DocumentWindow
+    {
+    public:
+        EditorWindow(juce::AudioProcessorEditor* editor, const juce::String& title);
+        void closeButtonPressed() override;
+    };
+
+    void timerCallback() override;
+    void slotClicked(int slot);
+    void showPluginMenu(int slot);
+    void showSlotMenu(int slot);
+    void loadPlugin(int slot, const juce::PluginDescription& description);
+    void removePlugin(int slot);
+    void showEditor(int slot);
+
+    PluginHost& pluginHost;
+    PluginChain& pluginChain;
+
+    juce::Label nameLabel;
+    juce::TextButton slotButtons[PluginChain::numSlots];
+    std::unique_ptr<EditorWindow> editorWindows[PluginChain::numSlots];
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (PluginChainComponent)
+};
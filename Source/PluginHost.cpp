@@ -0,0 +1,185 @@
+/*
+  ==============================================================================
+    PluginHost.cpp
+    Created: 19 Oct 2026 3:02:48am
+  ==============================================================================
+*/
+
+#include "PluginHost.h"
+#include "AsyncLogger.h"
+#include "ThreadPolicy.h"
+
+namespace
+{
+    const char* const scanWorkerOption = "--scan-plugin";
+}
+
+//==============================================================================
+// Scans one file per child process. Returning false makes the known list blacklist the file.
+class PluginHost::OutOfProcessScanner : public juce::KnownPluginList::CustomScanner
+{
+public:
+    bool findPluginTypesFor(juce::AudioPluginFormat& format,
+                            juce::OwnedArray<juce::PluginDescription>& result,
+                            const juce::String& fileOrIdentifier) override
+    {
+        const auto output = juce::File::createTempFile(".xml");
+        const auto executable = juce::File::getSpecialLocation(juce::File::currentExecutableFile);
+
+        juce::StringArray arguments{ executable.getFullPathName(), scanWorkerOption,
+                                     format.getName(), fileOrIdentifier, output.getFullPathName() };
+
+        juce::ChildProcess worker;
+
+        if (!worker.start(arguments, 0))
+            return false;
+
+        const auto startTime = juce::Time::getMillisecondCounter();
+
+        while (!worker.waitForProcessToFinish(100))
+        {
+            // shouldExit only follows a ThreadPoolJob; the scan runs on a plain juce::Thread
+            if (shouldExit() || juce::Thread::currentThreadShouldExit()
+                || juce::Time::getMillisecondCounter() - startTime > (juce::uint32) scanTimeoutMilliseconds)
+            {
+                RT_LOG(warning, "PluginHost scan worker stopped, did it hang? Milliseconds:",
+                       juce::Time::getMillisecondCounter() - startTime);
+                worker.kill();
+                output.deleteFile();
+                return false;
+            }
+        }
+
+        const bool scanned = worker.getExitCode() == 0;
+
+        if (scanned)
+        {
+            if (auto xml = juce::parseXML(output))
+            {
+                for (auto* element : xml->getChildIterator())
+                {
+                    juce::PluginDescription description;
+
+                    if (description.loadFromXml(*element))
+                        result.add(new juce::PluginDescription(description));
+                }
+            }
+        }
+
+        output.deleteFile();
+        return scanned;
+    }
+};
+
+//==============================================================================
+// Constructor: Registers the formats this build can host and reads the list of a previous scan
+PluginHost::PluginHost()
+    : juce::Thread("Plugin scan")
+{
+    formatManager.addDefaultFormats();
+
+    if (auto xml = juce::parseXML(getListFile()))
+        knownPlugins.recreateFromXml(*xml);
+
+    knownPlugins.setCustomScanner(std::make_unique<OutOfProcessScanner>());
+}
+
+PluginHost::~PluginHost()
+{
+    cancelPendingUpdate();
+    stopThread(scanTimeoutMilliseconds + 1000);
+}
+
+void PluginHost::startScan()
+{
+    if (!isThreadRunning())
+        startThread(juce::Thread::Priority::background);
+}
+
+// Function: createInstance
+// Purpose: Creates the plugin synchronously through the format that found it.
+std::unique_ptr<juce::AudioPluginInstance> PluginHost::createInstance(const juce::PluginDescription& description,
+                                                                      double sampleRate, int blockSize, juce::String& error)
+{
+    return formatManager.createPluginInstance(description, sampleRate, blockSize, error);
+}
+
+bool PluginHost::isScanWorker(const juce::StringArray& arguments)
+{
+    return arguments.size() == 4 && arguments[0] == scanWorkerOption;
+}
+
+// Function: runScanWorker
+// Purpose: The arguments are the option, the format name, the file or identifier and the file
+//          to write the results to. If the plugin crashes the process, the app sees the exit code.
+int PluginHost::runScanWorker(const juce::StringArray& arguments)
+{
+    juce::AudioPluginFormatManager workerFormats;
+    workerFormats.addDefaultFormats();
+
+    for (auto* format : workerFormats.getFormats())
+    {
+        if (format->getName() != arguments[1])
+            continue;
+
+        juce::OwnedArray<juce::PluginDescription> found;
+        format->findAllTypesForFile(found, arguments[2]);
+
+        juce::XmlElement list("PLUGINS");
+
+        for (auto* description : found)
+            list.addChildElement(description->createXml().release());
+
+        return list.writeTo(juce::File(arguments[3])) ? 0 : 1;
+    }
+
+    return 1;
+}
+
+// Function: run
+// Purpose: Walks the default folders of each format. Each file goes to the out-of-process
+//          scanner, so this thread only waits on child processes.
+void PluginHost::run()
+{
+    ThreadPolicy::applyToCurrentThread(ThreadPolicy::backgroundRole, "Plugin scan");
+
+    for (auto* format : formatManager.getFormats())
+    {
+        juce::PluginDirectoryScanner scanner(knownPlugins, *format, format->getDefaultLocationsToSearch(),
+                                             true, juce::File(), true);
+        juce::String pluginName;
+
+        // Files already in the list are skipped, so a rescan only looks at new ones
+        while (!threadShouldExit() && scanner.scanNextFile(true, pluginName))
+            continue;
+
+        for (auto& failedFile : scanner.getFailedFiles())
+            juce::Logger::writeToLog("PluginHost blacklisted a plugin that failed to scan: " + failedFile);
+    }
+
+    saveList();
+    triggerAsyncUpdate();
+}
+
+void PluginHost::handleAsyncUpdate()
+{
+    RT_LOG(info, "PluginHost scan finished, plugins known:", knownPlugins.getNumTypes());
+
+    if (onScanFinished)
+        onScanFinished();
+}
+
+juce::File PluginHost::getListFile() const
+{
+    return juce::File::getSpecialLocation(juce::File::userApplicationDataDirectory)
+        .getChildFile("OtoDecks").getChildFile("Plugins.xml");
+}
+
+void PluginHost::saveList()
+{
+    if (auto xml = knownPlugins.createXml())
+    {
+        getListFile().getParentDirectory().createDirectory();
+        xml->writeTo(getListFile());
+    }
+}
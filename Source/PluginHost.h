@@ -0,0 +1,71 @@
+/*
+  ==============================================================================
+    PluginHost.h
+    Created: 19 Oct 2026 3:02:48am
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <functional>
+#include <memory>
+
+// Finds and creates the VST3 and LV2 plugins the decks and the master bus can host.
+//
+// Scanning loads every plugin binary, and a broken one would take the app down with it, so
+// each file is scanned in a child process: the app starts its own executable with
+// --scan-plugin, which writes what it found to a file and exits. A file whose scan crashes or
+// hangs is blacklisted. The list of plugins found is kept between sessions.
+class PluginHost : private juce::Thread,
+                   private juce::AsyncUpdater
+{
+public:
+    PluginHost();
+    ~PluginHost() override;
+
+    /**Returns the plugins found so far*/
+    juce::KnownPluginList& getKnownPlugins() noexcept { return knownPlugins; }
+
+    // Function: startScan
+    // Purpose: Scans the default folders of every format on a background thread, skipping
+    //          files that are already known. Does nothing if a scan is running.
+    void startScan();
+    /**Returns whether a scan is running*/
+    bool isScanning() const { return isThreadRunning(); }
+    /**Called on the message thread when a scan has finished*/
+    std::function<void()> onScanFinished;
+
+    // Function: createInstance
+    // Purpose: Loads a plugin into this process. Message thread only.
+    // Inputs:
+    // - const juce::PluginDescription& description: A plugin from the known list.
+    // - double sampleRate, int blockSize: The settings to create it with.
+    // - juce::String& error: Set to the reason if the plugin can't be created.
+    std::unique_ptr<juce::AudioPluginInstance> createInstance(const juce::PluginDescription& description,
+                                                              double sampleRate, int blockSize, juce::String& error);
+
+    /**Returns whether the app was started as a scan worker*/
+    static bool isScanWorker(const juce::StringArray& arguments);
+    // Function: runScanWorker
+    // Purpose: Scans the one file given on the command line and writes the plugins in it to
+    //          the output file. Runs in the child process.
+    // Outputs: The process exit code, 0 if the file could be scanned.
+    static int runScanWorker(const juce::StringArray& arguments);
+
+private:
+    class OutOfProcessScanner;
+
+    static constexpr int scanTimeoutMilliseconds = 60000;
+
+    void run() override;
+    void handleAsyncUpdate() override;
+
+    juce::File getListFile() const;
+    void saveList();
+
+    juce::AudioPluginFormatManager formatManager;
+    juce::KnownPluginList knownPlugins;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(PluginHost)
+};
@@ -0,0 +1,48 @@
+/*
+  ==============================================================================
+    ReadAheadAudioSource.cpp
+    Created: 19 Oct 2026 10:12:40am
+  ==============================================================================
+*/
+
+#include "ReadAheadAudioSource.h"
+
+ReadAheadAudioSource::ReadAheadAudioSource(SharedAudioReader::Ptr readerToPlay)
+    : reader(std::move(readerToPlay)),
+      readerIndex(reader->addReader(0))
+{
+    // Every reader slot taken: this source plays what the others have decoded
+    jassert(readerIndex >= 0);
+}
+
+ReadAheadAudioSource::~ReadAheadAudioSource()
+{
+    reader->removeReader(readerIndex);
+}
+
+bool ReadAheadAudioSource::isBuffered(juce::int64 start, int numSamples) const noexcept
+{
+    return reader->isCached(start, numSamples);
+}
+
+// Function: getNextAudioBlock
+// Purpose: Copies what is cached and plays silence for the rest, as the transport's own
+//          buffering does when the disk falls behind. A seek during the block wins.
+void ReadAheadAudioSource::getNextAudioBlock(const juce::AudioSourceChannelInfo& bufferToFill)
+{
+    const auto start = nextPlayPosition.load();
+    const int copied = reader->read(*bufferToFill.buffer, bufferToFill.startSample, start, bufferToFill.numSamples);
+
+    if (copied < bufferToFill.numSamples)
+        bufferToFill.buffer->clear(bufferToFill.startSample + copied, bufferToFill.numSamples - copied);
+
+    auto expected = start;
+    nextPlayPosition.compare_exchange_strong(expected, start + bufferToFill.numSamples);
+    reader->setReaderPosition(readerIndex, nextPlayPosition.load());
+}
+
+void ReadAheadAudioSource::setNextReadPosition(juce::int64 newPosition)
+{
+    nextPlayPosition = newPosition;
+    reader->setReaderPosition(readerIndex, newPosition);
+}
@@ -0,0 +1,50 @@
+/*
+  ==============================================================================
+    ReadAheadAudioSource.h
+    Created: 19 Oct 2026 10:12:40am
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <atomic>
+#include "SharedAudioReader.h"
+
+// Plays a track from its shared cache, which the read-ahead thread fills ahead of the play
+// position, like the buffering the transport does itself, but which also keeps what was
+// played: the samples the track's reader was asked to keep behind the position stay readable.
+// A deck rendered ahead puts its transport back by the rendered-ahead audio when a control
+// changes, and the audio there must still be in memory.
+//
+// The position is an atomic the audio thread advances and any thread can set, and the cache
+// is read without a lock, so neither playing nor seeking waits for the thread. The cache
+// belongs to the track rather than the device, so a device restart keeps it.
+class ReadAheadAudioSource : public juce::PositionableAudioSource
+{
+public:
+    /**Plays a track from its start as one of the readers of its cache*/
+    explicit ReadAheadAudioSource(SharedAudioReader::Ptr readerToPlay);
+    ~ReadAheadAudioSource() override;
+
+    // Function: isBuffered
+    // Purpose: Tells whether a range can be played without waiting for the thread. Any thread.
+    // Inputs: The first track sample and the number of samples; those past the end count as buffered.
+    bool isBuffered(juce::int64 start, int numSamples) const noexcept;
+
+    void prepareToPlay(int, double) override {}
+    void releaseResources() override {}
+    void getNextAudioBlock(const juce::AudioSourceChannelInfo& bufferToFill) override;
+
+    void setNextReadPosition(juce::int64 newPosition) override;
+    juce::int64 getNextReadPosition() const override { return nextPlayPosition.load(); }
+    juce::int64 getTotalLength() const override { return reader->getLengthInSamples(); }
+    bool isLooping() const override { return false; }
+
+private:
+    SharedAudioReader::Ptr reader;
+    const int readerIndex;
+    std::atomic<juce::int64> nextPlayPosition{ 0 };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ReadAheadAudioSource)
+};
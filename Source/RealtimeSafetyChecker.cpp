@@ -0,0 +1,254 @@
+/*
+  ==============================================================================
+    RealtimeSafetyChecker.cpp
+    Created: 18 Oct 2026 11:20:42pm
+  ==============================================================================
+*/
+
+#include "RealtimeSafetyChecker.h"
+
+#if OTODECKS_REALTIME_CHECKS
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+// On Linux with glibc malloc and pthread_mutex_lock themselves are replaced, which also
+// catches allocations made inside JUCE and the C++ library. Elsewhere only operator new and
+// delete are replaced.
+#if JUCE_LINUX && defined(__GLIBC__)
+ #define OTODECKS_REALTIME_CHECKS_LIBC 1
+ #include <dlfcn.h>
+ #include <execinfo.h>
+ #include <pthread.h>
+#else
+ #define OTODECKS_REALTIME_CHECKS_LIBC 0
+ #if JUCE_MAC
+  #include <execinfo.h>
+ #elif JUCE_WINDOWS
+  extern "C" __declspec(dllimport) unsigned short __stdcall RtlCaptureStackBackTrace(unsigned long, unsigned long, void**, unsigned long*);
+ #endif
+#endif
+
+namespace
+{
+    // Plain thread locals without constructors, so reading them never allocates
+    thread_local int realtimeDepth = 0;
+    thread_local bool isReporting = false;
+
+    std::atomic<int> violationCount{ 0 };
+
+    // Call paths that were already reported, as hashes of their return addresses
+    constexpr int maxReportedPaths = 256;
+    std::atomic<juce::uint64> reportedPaths[maxReportedPaths];
+
+    constexpr int maxFrames = 12;
+
+    int captureFrames(void** frames) noexcept
+    {
+       #if JUCE_LINUX || JUCE_MAC
+        return backtrace(frames, maxFrames);
+       #elif JUCE_WINDOWS
+        return (int) RtlCaptureStackBackTrace(0, (unsigned long) maxFrames, frames, nullptr);
+       #else
+        juce::ignoreUnused(frames);
+        return 0;
+       #endif
+    }
+
+    // Returns true the first time a call path is seen. When the table is full everything
+    // counts as seen, so a flood of new paths can't stall the audio thread forever.
+    bool isNewCallPath(juce::uint64 hash) noexcept
+    {
+        hash = juce::jmax((juce::uint64) 1, hash);
+
+        for (int probe = 0; probe < maxReportedPaths; ++probe)
+        {
+            auto& slot = reportedPaths[(hash + (juce::uint64) probe) % maxReportedPaths];
+            juce::uint64 expected = 0;
+
+            if (slot.compare_exchange_strong(expected, hash))
+                return true;
+
+            if (expected == hash)
+                return false;
+        }
+
+        return false;
+    }
+
+    const char* getViolationName(RealtimeSafetyChecker::ViolationType type) noexcept
+    {
+        switch (type)
+        {
+            case RealtimeSafetyChecker::allocation:   return "heap allocation";
+            case RealtimeSafetyChecker::deallocation: return "heap deallocation";
+            case RealtimeSafetyChecker::mutexLock:    return "mutex lock";
+        }
+
+        return "unknown";
+    }
+
+   #if JUCE_LINUX || JUCE_MAC
+    // backtrace loads libgcc on its first call, which allocates; do that before any audio runs
+    [[maybe_unused]] const int framesWarmUp = []
+    {
+        void* frames[maxFrames];
+        return backtrace(frames, maxFrames);
+    }();
+   #endif
+}
+
+void RealtimeSafetyChecker::enterRealtimeSection() noexcept { ++realtimeDepth; }
+void RealtimeSafetyChecker::exitRealtimeSection() noexcept { --realtimeDepth; }
+
+int RealtimeSafetyChecker::getViolationCount() noexcept
+{
+    return violationCount.load();
+}
+
+// Function: reportIfRealtime
+// Purpose: Counts the violation, then hashes the stack so each call path is written to the
+//          log once, with a symbolised stack trace. Whatever the reporting itself allocates or
+//          locks is not reported.
+void RealtimeSafetyChecker::reportIfRealtime(ViolationType type) noexcept
+{
+    if (realtimeDepth <= 0 || isReporting)
+        return;
+
+    isReporting = true;
+    ++violationCount;
+
+    void* frames[maxFrames];
+    const int numFrames = captureFrames(frames);
+    juce::uint64 hash = 14695981039346656037ull;
+
+    // The first frames are this function and the replaced allocator or lock
+    for (int i = 2; i < numFrames; ++i)
+        hash = (hash ^ (juce::uint64) (juce::pointer_sized_uint) frames[i]) * 1099511628211ull;
+
+    hash ^= (juce::uint64) type;
+
+    if (isNewCallPath(hash))
+    {
+        juce::Logger::writeToLog(juce::String("Real-time violation: ") + getViolationName(type)
+                                 + " on the audio thread\n" + juce::SystemStats::getStackBacktrace());
+    }
+
+    isReporting = false;
+}
+
+//==============================================================================
+#if OTODECKS_REALTIME_CHECKS_LIBC
+
+extern "C"
+{
+    void* __libc_malloc(size_t);
+    void* __libc_calloc(size_t, size_t);
+    void* __libc_realloc(void*, size_t);
+    void* __libc_memalign(size_t, size_t);
+    void __libc_free(void*);
+
+    // The C++ allocation functions of libstdc++ end up here, so operator new is covered too
+    void* malloc(size_t size)
+    {
+        RealtimeSafetyChecker::reportIfRealtime(RealtimeSafetyChecker::allocation);
+        return __libc_malloc(size);
+    }
+
+    void* calloc(size_t count, size_t size)
+    {
+        RealtimeSafetyChecker::reportIfRealtime(RealtimeSafetyChecker::allocation);
+        return __libc_calloc(count, size);
+    }
+
+    void* realloc(void* pointer, size_t size)
+    {
+        RealtimeSafetyChecker::reportIfRealtime(RealtimeSafetyChecker::allocation);
+        return __libc_realloc(pointer, size);
+    }
+
+    void* aligned_alloc(size_t alignment, size_t size)
+    {
+        RealtimeSafetyChecker::reportIfRealtime(RealtimeSafetyChecker::allocation);
+        return __libc_memalign(alignment, size);
+    }
+
+    void free(void* pointer)
+    {
+        if (pointer != nullptr)
+            RealtimeSafetyChecker::reportIfRealtime(RealtimeSafetyChecker::deallocation);
+
+        __libc_free(pointer);
+    }
+
+    // juce::CriticalSection and std::mutex both lock through this. Try-locks never block, so
+    // pthread_mutex_trylock is left alone.
+    int pthread_mutex_lock(pthread_mutex_t* mutex)
+    {
+        using LockFunction = int (*)(pthread_mutex_t*);
+        static std::atomic<LockFunction> realLock{ nullptr };
+
+        auto lock = realLock.load(std::memory_order_acquire);
+
+        if (lock == nullptr)
+        {
+            lock = reinterpret_cast<LockFunction>(dlsym(RTLD_NEXT, "pthread_mutex_lock"));
+            realLock.store(lock, std::memory_order_release);
+        }
+
+        RealtimeSafetyChecker::reportIfRealtime(RealtimeSafetyChecker::mutexLock);
+        return lock(mutex);
+    }
+}
+
+#else
+
+void* operator new(size_t size)
+{
+    RealtimeSafetyChecker::reportIfRealtime(RealtimeSafetyChecker::allocation);
+
+    if (auto* pointer = std::malloc(size > 0 ? size : 1))
+        return pointer;
+
+    throw std::bad_alloc();
+}
+
+void* operator new[](size_t size)
+{
+    return operator new(size);
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept
+{
+    RealtimeSafetyChecker::reportIfRealtime(RealtimeSafetyChecker::allocation);
+    return std::malloc(size > 0 ? size : 1);
+}
+
+void* operator new[](size_t size, const std::nothrow_t& tag) noexcept
+{
+    return operator new(size, tag);
+}
+
+void operator delete(void* pointer) noexcept
+{
+    if (pointer != nullptr)
+        RealtimeSafetyChecker::reportIfRealtime(RealtimeSafetyChecker::deallocation);
+
+    std::free(pointer);
+}
+
+void operator delete[](void* pointer) noexcept { operator delete(pointer); }
+void operator delete(void* pointer, size_t) noexcept { operator delete(pointer); }
+void operator delete[](void* pointer, size_t) noexcept { operator delete(pointer); }
+void operator delete(void* pointer, const std::nothrow_t&) noexcept { operator delete(pointer); }
+void operator delete[](void* pointer, const std::nothrow_t&) noexcept { operator delete(pointer); }
+
+#endif
+
+#else
+
+int RealtimeSafetyChecker::getViolationCount() noexcept { return 0; }
+void RealtimeSafetyChecker::reportIfRealtime(ViolationType) noexcept {}
+
+#endif
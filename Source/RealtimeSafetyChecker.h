@@ -0,0 +1,71 @@
+/*
+  ==============================================================================
+    RealtimeSafetyChecker.h
+    Created: 18 Oct 2026 11:20:42pm
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+// Debug builds check the audio thread for calls that can block: heap allocation and
+// deallocation, and on Linux also waiting on a mutex. Define OTODECKS_REALTIME_CHECKS=0 to
+// turn the checks off in a debug build, or =1 to turn them on in a release build.
+#ifndef OTODECKS_REALTIME_CHECKS
+ #if JUCE_DEBUG
+  #define OTODECKS_REALTIME_CHECKS 1
+ #else
+  #define OTODECKS_REALTIME_CHECKS 0
+ #endif
+#endif
+
+// Reports allocations and locks made by a thread while it renders audio.
+//
+// A ScopedRealtimeSection marks the current thread as rendering audio. With the checks on,
+// the global allocation functions and, on Linux, pthread_mutex_lock are replaced by versions
+// that look at that mark. A violation is counted, and the first time a call path is seen it
+// is written to the log with a stack trace. Reporting blocks, so it only belongs in builds
+// made for finding these problems. With the checks off the section does nothing.
+//
+// Nothing can be exempted. A deck plays through DeckTransport and its read-ahead cache, which
+// take no lock, and the spin locks the plugins and effects try never reach pthread, so
+// normal playback reports nothing and every report is worth looking at.
+class RealtimeSafetyChecker
+{
+public:
+    // Marks the current thread as real-time for its lifetime. Sections can be nested.
+    class ScopedRealtimeSection
+    {
+    public:
+       #if OTODECKS_REALTIME_CHECKS
+        ScopedRealtimeSection() noexcept { RealtimeSafetyChecker::enterRealtimeSection(); }
+        ~ScopedRealtimeSection() noexcept { RealtimeSafetyChecker::exitRealtimeSection(); }
+       #else
+        ScopedRealtimeSection() noexcept {}
+       #endif
+
+        JUCE_DECLARE_NON_COPYABLE(ScopedRealtimeSection)
+    };
+
+    enum ViolationType
+    {
+        allocation = 0,
+        deallocation,
+        mutexLock
+    };
+
+    /**Returns how many violations were seen since the program started, 0 with the checks off*/
+    static int getViolationCount() noexcept;
+
+    // Function: reportIfRealtime
+    // Purpose: Counts and reports a violation if the calling thread is in a real-time section.
+    //          Called by the replaced allocation and lock functions.
+    static void reportIfRealtime(ViolationType type) noexcept;
+
+private:
+    static void enterRealtimeSection() noexcept;
+    static void exitRealtimeSection() noexcept;
+
+    RealtimeSafetyChecker() = delete;
+};
@@ -0,0 +1,107 @@
+/*
+  ==============================================================================
+    RenderAheadBuffer.cpp
+    Created: 19 Oct 2026 8:47:12am
+  ==============================================================================
+*/
+
+#include "RenderAheadBuffer.h"
+
+void RenderAheadBuffer::prepare(int numChannels, int blockSizeToUse, int numBlocksToUse)
+{
+    blockSize = juce::jmax(1, blockSizeToUse);
+    numBlocks = juce::jmax(1, numBlocksToUse);
+    storage.setSize(juce::jmax(1, numChannels), blockSize * numBlocks);
+    blockStarts.assign((size_t) numBlocks + 1, 0);
+    blockEnds.assign((size_t) numBlocks + 1, 0);
+    clear(0);
+}
+
+void RenderAheadBuffer::release()
+{
+    storage.setSize(0, 0);
+    blockStarts.clear();
+    blockEnds.clear();
+    blockSize = 0;
+    numBlocks = 0;
+    clear(0);
+}
+
+bool RenderAheadBuffer::hasRoomForBlock() const noexcept
+{
+    return isPrepared() && written.load() + blockSize - consumed.load() <= (juce::int64) blockSize * numBlocks;
+}
+
+// Blocks are whole within the storage, so a block never wraps around its end
+juce::AudioSourceChannelInfo RenderAheadBuffer::beginBlock(juce::int64 positionAtStart) noexcept
+{
+    const auto block = written.load() / blockSize;
+    blockStarts[(size_t) (block % (numBlocks + 1))] = positionAtStart;
+
+    return juce::AudioSourceChannelInfo(&storage, (int) (block % numBlocks) * blockSize, blockSize);
+}
+
+void RenderAheadBuffer::finishBlock(juce::int64 positionAtEnd) noexcept
+{
+    const auto block = written.load() / blockSize;
+    blockEnds[(size_t) (block % (numBlocks + 1))] = positionAtEnd;
+    written.store(written.load() + blockSize, std::memory_order_release);
+}
+
+// Function: read
+// Purpose: Copies in pieces that end at a block boundary or at the end of the storage. A
+//          destination with more channels than the storage repeats its last channel.
+int RenderAheadBuffer::read(juce::AudioBuffer<float>& destination, int startSample, int numSamples) noexcept
+{
+    if (!isPrepared())
+        return 0;
+
+    const auto available = written.load(std::memory_order_acquire) - consumed.load();
+    const int toRead = (int) juce::jmin((juce::int64) numSamples, available);
+    const int capacity = blockSize * numBlocks;
+    auto readFrom = consumed.load();
+
+    for (int done = 0; done < toRead;)
+    {
+        const int offset = (int) (readFrom % capacity);
+        const int piece = juce::jmin(toRead - done, capacity - offset);
+
+        for (int channel = 0; channel < destination.getNumChannels(); ++channel)
+            destination.copyFrom(channel, startSample + done, storage, juce::jmin(channel, storage.getNumChannels() - 1), offset, piece);
+
+        done += piece;
+        readFrom += piece;
+    }
+
+    readPosition = positionAt(readFrom);
+    consumed.store(readFrom, std::memory_order_release);
+    return toRead;
+}
+
+void RenderAheadBuffer::clear(juce::int64 position) noexcept
+{
+    startPosition = position;
+    written = 0;
+    consumed = 0;
+    readPosition = position;
+}
+
+// Function: positionAt
+// Purpose: The transport moves at a steady rate within a block, so the position of a sample
+//          lies on the line between its block's start and end. A sample just after the last
+//          block written is at that block's end.
+juce::int64 RenderAheadBuffer::positionAt(juce::int64 sample) const noexcept
+{
+    if (sample == 0)
+        return startPosition;
+
+    const bool afterLastBlock = sample == written.load(std::memory_order_acquire);
+    const auto block = afterLastBlock ? sample / blockSize - 1 : sample / blockSize;
+    const auto slot = (size_t) (block % (numBlocks + 1));
+
+    if (afterLastBlock)
+        return blockEnds[slot];
+
+    const auto offset = sample - block * blockSize;
+    return blockStarts[slot] + (blockEnds[slot] - blockStarts[slot]) * offset / blockSize;
+}
@@ -0,0 +1,78 @@
+/*
+  ==============================================================================
+    RenderAheadBuffer.h
+    Created: 19 Oct 2026 8:47:12am
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <atomic>
+#include <vector>
+
+// A deck's output rendered ahead of the device callback, for one producer and one consumer.
+//
+// The producer, a worker thread, writes whole blocks and notes the transport position before
+// and after each one. The consumer, the audio thread, reads any number of samples and can
+// tell at which transport position the next sample it plays was rendered, which is where
+// the deck is put back when the rendered-ahead audio is thrown away.
+class RenderAheadBuffer
+{
+public:
+    RenderAheadBuffer() = default;
+
+    // Function: prepare
+    // Purpose: Allocates room for numBlocks blocks and empties the buffer. Not while in use.
+    void prepare(int numChannels, int blockSizeToUse, int numBlocksToUse);
+    /**Frees the memory*/
+    void release();
+
+    /**Returns whether prepare was called since the last release*/
+    bool isPrepared() const noexcept { return blockSize > 0; }
+    /**Returns the number of samples in a block*/
+    int getBlockSize() const noexcept { return blockSize; }
+    /**Returns the samples rendered and not played yet; from any thread*/
+    int getNumReady() const noexcept { return (int) (written.load() - consumed.load()); }
+
+    /**Returns whether the producer can write another block*/
+    bool hasRoomForBlock() const noexcept;
+    // Function: beginBlock
+    // Purpose: Returns the space of the next block, to render into; producer only.
+    // Inputs: The transport position the block starts at
+    juce::AudioSourceChannelInfo beginBlock(juce::int64 positionAtStart) noexcept;
+    /**Makes the block written since beginBlock readable, ending at the given transport position*/
+    void finishBlock(juce::int64 positionAtEnd) noexcept;
+
+    // Function: read
+    // Purpose: Copies up to numSamples into the destination; consumer only.
+    // Outputs: The number of samples copied, less than asked for when the producer fell behind
+    int read(juce::AudioBuffer<float>& destination, int startSample, int numSamples) noexcept;
+
+    /**Returns the transport position the next sample to be read was rendered at; from any thread*/
+    juce::int64 getReadPosition() const noexcept { return readPosition.load(); }
+
+    // Function: clear
+    // Purpose: Throws away what wasn't read and starts over at the position. Only while the
+    //          producer doesn't write.
+    void clear(juce::int64 position) noexcept;
+
+private:
+    /**Interpolates the position of a sample within its block; consumer only*/
+    juce::int64 positionAt(juce::int64 sample) const noexcept;
+
+    juce::AudioBuffer<float> storage;
+    // Start and end positions of each block, with one slot more than blocks, so the slot of
+    // the block just read isn't reused while the buffer is empty
+    std::vector<juce::int64> blockStarts;
+    std::vector<juce::int64> blockEnds;
+    int blockSize = 0;
+    int numBlocks = 0;
+    juce::int64 startPosition = 0;
+
+    std::atomic<juce::int64> written{ 0 };
+    std::atomic<juce::int64> consumed{ 0 };
+    std::atomic<juce::int64> readPosition{ 0 };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(RenderAheadBuffer)
+};
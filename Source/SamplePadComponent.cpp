@@ -0,0 +1,108 @@
+/*
+  ==============================================================================
+    SamplePadComponent.cpp
+    Created: 19 Oct 2026 2:14:36am
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "SamplePadComponent.h"
+
+//==============================================================================
+SamplePadComponent::SamplePadComponent(SamplePadSource& _samplePad)
+    : samplePad(_samplePad)
+{
+    for (int pad = 0; pad < SamplePadSource::numPads; ++pad)
+    {
+        padButtons[pad].onClick = [this, pad] { padClicked(pad); };
+        addAndMakeVisible(padButtons[pad]);
+        updatePadName(pad);
+    }
+}
+
+SamplePadComponent::~SamplePadComponent()
+{
+}
+
+void SamplePadComponent::paint(juce::Graphics& g)
+{
+    g.fillAll(getLookAndFeel().findColour(juce::ResizableWindow::backgroundColourId));
+}
+
+void SamplePadComponent::resized()
+{
+    // Pads in rows of equal width
+    const int columns = SamplePadSource::numPads / numRows;
+    const int padWidth = getWidth() / columns;
+    const int padHeight = getHeight() / numRows;
+
+    for (int pad = 0; pad < SamplePadSource::numPads; ++pad)
+    {
+        padButtons[pad].setBounds((pad % columns) * padWidth + 1, (pad / columns) * padHeight + 1,
+                                  padWidth - 2, padHeight - 2);
+    }
+}
+
+bool SamplePadComponent::isInterestedInFileDrag(const juce::StringArray& files)
+{
+    return files.size() == 1;
+}
+
+// Loads the dropped file onto the pad under the mouse
+void SamplePadComponent::filesDropped(const juce::StringArray& files, int x, int y)
+{
+    for (int pad = 0; pad < SamplePadSource::numPads; ++pad)
+    {
+        if (padButtons[pad].getBounds().contains(x, y))
+        {
+            loadSample(pad, juce::File{ files[0] });
+        }
+    }
+}
+
+// Plays a loaded pad, asks for a file for an empty one. Shift-click always asks for a file,
+// alt-click clears the pad
+void SamplePadComponent::padClicked(int pad)
+{
+    const auto modifiers = juce::ModifierKeys::getCurrentModifiers();
+    if (modifiers.isAltDown())
+    {
+        samplePad.clearSample(pad);
+        updatePadName(pad);
+    }
+    else if (modifiers.isShiftDown() || samplePad.getSampleName(pad).isEmpty())
+    {
+        chooseSample(pad);
+    }
+    else
+    {
+        DBG("Pad " << pad + 1 << " triggered");
+        samplePad.trigger(pad);
+    }
+}
+
+void SamplePadComponent::chooseSample(int pad)
+{
+    juce::FileChooser chooser{ "Select a sample", {}, "*.wav;*.aif;*.aiff;*.flac;*.ogg;*.mp3" };
+    if (chooser.browseForFileToOpen())
+    {
+        loadSample(pad, chooser.getResult());
+    }
+}
+
+void SamplePadComponent::loadSample(int pad, const juce::File& file)
+{
+    if (!samplePad.loadSample(pad, file))
+    {
+        juce::AlertWindow::showMessageBoxAsync(juce::AlertWindow::WarningIcon, "Sample pads",
+                                               "Could not load " + file.getFileName()
+                                               + ". Samples must be readable audio files of at most 30 seconds.");
+    }
+    updatePadName(pad);
+}
+
+void SamplePadComponent::updatePadName(int pad)
+{
+    const auto name = samplePad.getSampleName(pad);
+    padButtons[pad].setButtonText(name.isEmpty() ? "PAD " + juce::String(pad + 1) : name);
+}
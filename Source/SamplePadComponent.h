@@ -0,0 +1,44 @@
+/*
+  ==============================================================================
+    SamplePadComponent.h
+    Created: 19 Oct 2026 2:14:36am
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "SamplePadSource.h"
+
+//==============================================================================
+/*
+    A grid of pads for the sampler. Clicking a loaded pad plays it; clicking an empty pad, or
+    shift-clicking any pad, asks for a file, and alt-click clears a pad. Files can also be
+    dropped onto a pad.
+*/
+class SamplePadComponent  : public juce::Component,
+                            public juce::FileDragAndDropTarget
+{
+public:
+    SamplePadComponent(SamplePadSource& _samplePad);
+    ~SamplePadComponent() override;
+
+    void paint (juce::Graphics&) override;
+    void resized() override;
+
+    bool isInterestedInFileDrag(const juce::StringArray& files) override;
+    void filesDropped(const juce::StringArray& files, int x, int y) override;
+
+private:
+    static constexpr int numRows = 2;
+
+    void padClicked(int pad);
+    void chooseSample(int pad);
+    void loadSample(int pad, const juce::File& file);
+    void updatePadName(int pad);
+
+    SamplePadSource& samplePad;
+    juce::TextButton padButtons[SamplePadSource::numPads];
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (SamplePadComponent)
+};
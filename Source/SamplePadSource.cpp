@@ -0,0 +1,255 @@
+/*
+  ==============================================================================
+    SamplePadSource.cpp
+    Created: 19 Oct 2026 2:14:36am
+  ==============================================================================
+*/
+
+#include "SamplePadSource.h"
+#include "AsyncLogger.h"
+
+// Constructor: Registers the formats pads can load; the voice pool is a member array
+SamplePadSource::SamplePadSource()
+{
+    formatManager.registerBasicFormats();
+
+    for (auto& pending : sampleChangePending)
+        pending = false;
+}
+
+SamplePadSource::~SamplePadSource()
+{
+}
+
+// Function: prepareToPlay
+// Purpose: Stores the device rate, which the voices interpolate to, and sizes the steal fade.
+void SamplePadSource::prepareToPlay(int samplesPerBlockExpected, double sampleRate)
+{
+    juce::ignoreUnused(samplesPerBlockExpected);
+
+    currentSampleRate = sampleRate;
+    stealFadeSamples = juce::jmax(1, juce::roundToInt(sampleRate * stealFadeSeconds));
+}
+
+void SamplePadSource::releaseResources()
+{
+    for (auto& voice : voices)
+        voice.sample = nullptr;
+}
+
+// Function: getNextAudioBlock
+// Purpose: Picks up new samples, starts the triggers queued since the last block and mixes
+//          the voices into the cleared block.
+void SamplePadSource::getNextAudioBlock(const juce::AudioSourceChannelInfo& bufferToFill)
+{
+    auto& buffer = *bufferToFill.buffer;
+    const int startSample = bufferToFill.startSample;
+    const int numSamples = bufferToFill.numSamples;
+
+    bufferToFill.clearActiveBufferRegion();
+
+    if (buffer.getNumChannels() == 0)
+        return;
+
+    if (anySampleChangePending.load())
+        swapPendingSamples(buffer, startSample, numSamples);
+
+    int start1, size1, start2, size2;
+    triggerFifo.prepareToRead(triggerFifo.getNumReady(), start1, size1, start2, size2);
+
+    for (int i = 0; i < size1; ++i)
+        startVoice(triggers[start1 + i].pad, triggers[start1 + i].velocity, buffer, startSample, numSamples);
+
+    for (int i = 0; i < size2; ++i)
+        startVoice(triggers[start2 + i].pad, triggers[start2 + i].velocity, buffer, startSample, numSamples);
+
+    triggerFifo.finishedRead(size1 + size2);
+
+    for (auto& voice : voices)
+        if (voice.sample != nullptr)
+            renderVoice(voice, buffer, startSample, numSamples, voice.gain, voice.gain);
+
+    buffer.applyGain(startSample, numSamples, masterGain.load());
+}
+
+// Function: loadSample
+// Purpose: Decodes the whole file at its own rate, up to two channels, and hands it to the
+//          audio thread.
+bool SamplePadSource::loadSample(int pad, const juce::File& file)
+{
+    jassert(pad >= 0 && pad < numPads);
+
+    std::unique_ptr<juce::AudioFormatReader> reader(formatManager.createReaderFor(file));
+
+    if (reader == nullptr || reader->lengthInSamples > (juce::int64) (reader->sampleRate * maxLengthSeconds))
+        return false;
+
+    auto sample = std::make_unique<Sample>();
+    sample->sampleRate = reader->sampleRate;
+    sample->name = file.getFileNameWithoutExtension();
+    sample->audio.setSize(juce::jmin(2, (int) reader->numChannels), (int) reader->lengthInSamples);
+    reader->read(&sample->audio, 0, (int) reader->lengthInSamples, 0, true, true);
+
+    sampleNames[pad] = sample->name;
+    setSample(pad, std::move(sample));
+
+    RT_LOG(info, "SamplePadSource loaded a sample, pad:", pad + 1);
+    return true;
+}
+
+void SamplePadSource::clearSample(int pad)
+{
+    sampleNames[pad] = juce::String();
+    setSample(pad, nullptr);
+}
+
+juce::String SamplePadSource::getSampleName(int pad) const
+{
+    return sampleNames[pad];
+}
+
+// Function: trigger
+// Purpose: Writes the trigger into the queue the audio thread reads at the start of each block.
+bool SamplePadSource::trigger(int pad, float velocity) noexcept
+{
+    if (pad < 0 || pad >= numPads)
+        return false;
+
+    int start1, size1, start2, size2;
+    triggerFifo.prepareToWrite(1, start1, size1, start2, size2);
+
+    if (size1 + size2 == 0)
+        return false;
+
+    triggers[size1 > 0 ? start1 : start2] = { pad, juce::jlimit(0.0f, 1.0f, velocity) };
+    triggerFifo.finishedWrite(1);
+    return true;
+}
+
+// Function: swapPendingSamples
+// Purpose: Swaps in the samples waiting on standby. If the message thread holds the lock the
+//          samples are picked up next block.
+void SamplePadSource::swapPendingSamples(juce::AudioBuffer<float>& buffer, int startSample, int numSamples) noexcept
+{
+    const juce::SpinLock::ScopedTryLockType lock(sampleLock);
+
+    if (!lock.isLocked())
+        return;
+
+    for (int pad = 0; pad < numPads; ++pad)
+    {
+        if (!sampleChangePending[pad].load())
+            continue;
+
+        // The old sample goes to standby and must not be read by a voice after this
+        for (auto& voice : voices)
+            if (voice.sample != nullptr && voice.pad == pad)
+                fadeOutVoice(voice, buffer, startSample, numSamples);
+
+        std::swap(activeSamples[pad], standbySamples[pad]);
+        sampleChangePending[pad] = false;
+    }
+
+    anySampleChangePending = false;
+}
+
+// Function: startVoice
+// Purpose: Starts a pad on a free voice. With every voice busy the one that started first is
+//          faded out over the steal fade and reused, so what is stolen never depends on timing.
+void SamplePadSource::startVoice(int pad, float velocity, juce::AudioBuffer<float>& buffer, int startSample, int numSamples) noexcept
+{
+    const Sample* sample = activeSamples[pad].get();
+
+    if (sample == nullptr)
+        return;
+
+    Voice* target = nullptr;
+
+    for (auto& voice : voices)
+    {
+        if (voice.sample == nullptr)
+        {
+            target = &voice;
+            break;
+        }
+
+        if (target == nullptr || voice.startOrder < target->startOrder)
+            target = &voice;
+    }
+
+    if (target->sample != nullptr)
+    {
+        fadeOutVoice(*target, buffer, startSample, numSamples);
+        ++stolenVoices;
+        RT_LOG_RATE_LIMITED(warning, 5000, "SamplePadSource stole a voice, pool size:", numVoices);
+    }
+
+    target->sample = sample;
+    target->pad = pad;
+    target->position = 0.0;
+    target->gain = velocity;
+    target->startOrder = nextStartOrder++;
+}
+
+// Function: renderVoice
+// Purpose: Adds a voice to the buffer with linear interpolation from the sample's rate to the
+//          device rate. A mono sample is played on every channel.
+void SamplePadSource::renderVoice(Voice& voice, juce::AudioBuffer<float>& buffer, int startSample, int numSamples,
+                                  float rampStart, float rampEnd) noexcept
+{
+    const auto& audio = voice.sample->audio;
+    const int length = audio.getNumSamples();
+    const int sampleChannels = audio.getNumChannels();
+    const double step = voice.sample->sampleRate / currentSampleRate;
+    const float gainStep = (rampEnd - rampStart) / (float) juce::jmax(1, numSamples);
+
+    for (int channel = 0; channel < buffer.getNumChannels(); ++channel)
+    {
+        const float* source = audio.getReadPointer(juce::jmin(channel, sampleChannels - 1));
+        float* destination = buffer.getWritePointer(channel, startSample);
+        double position = voice.position;
+        float gain = rampStart;
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            const int index = (int) position;
+
+            if (index >= length)
+                break;
+
+            const float fraction = (float) (position - index);
+            const float next = index + 1 < length ? source[index + 1] : 0.0f;
+            destination[i] += gain * (source[index] + fraction * (next - source[index]));
+
+            position += step;
+            gain += gainStep;
+        }
+    }
+
+    voice.position += step * numSamples;
+
+    if ((int) voice.position >= length)
+        voice.sample = nullptr;
+}
+
+void SamplePadSource::fadeOutVoice(Voice& voice, juce::AudioBuffer<float>& buffer, int startSample, int numSamples) noexcept
+{
+    renderVoice(voice, buffer, startSample, juce::jmin(stealFadeSamples, numSamples), voice.gain, 0.0f);
+    voice.sample = nullptr;
+}
+
+// Function: setSample
+// Purpose: Hands a sample, or nullptr for none, to the audio thread. The sample this replaces
+//          earlier is destroyed here rather than on the audio thread.
+void SamplePadSource::setSample(int pad, std::unique_ptr<Sample> newSample)
+{
+    std::unique_ptr<Sample> retiredSample;
+
+    {
+        const juce::SpinLock::ScopedLockType lock(sampleLock);
+        retiredSample = std::move(standbySamples[pad]);
+        standbySamples[pad] = std::move(newSample);
+        sampleChangePending[pad] = true;
+        anySampleChangePending = true;
+    }
+}
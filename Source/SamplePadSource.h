@@ -0,0 +1,125 @@
+/*
+  ==============================================================================
+    SamplePadSource.h
+    Created: 19 Oct 2026 2:14:36am
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <atomic>
+#include <memory>
+
+// Plays short one-shots (horns, drops, vocal tags) on top of the decks.
+//
+// A pad's file is decoded completely into memory when it is loaded, so playing it never reads
+// from disk. The voices are a fixed pool allocated with the source; a trigger takes a free
+// voice, or steals the one that has played longest, which is faded out over a few
+// milliseconds. Triggers go through a lock-free queue and start at the beginning of the next
+// block. Samples are played at their own rate, interpolated to the device rate.
+class SamplePadSource : public juce::AudioSource
+{
+public:
+    static constexpr int numPads = 8;
+    static constexpr int numVoices = 16;
+
+    SamplePadSource();
+    ~SamplePadSource() override;
+
+    void prepareToPlay(int samplesPerBlockExpected, double sampleRate) override;
+    void releaseResources() override;
+    // Function: getNextAudioBlock
+    // Purpose: Starts the queued triggers and renders every playing voice. Replaces the
+    //          content of the block. Lock-free and allocation-free.
+    void getNextAudioBlock(const juce::AudioSourceChannelInfo& bufferToFill) override;
+
+    // Function: loadSample
+    // Purpose: Decodes a file into memory and puts it on a pad. Voices still playing the pad's
+    //          previous sample are faded out. Reads the file, so not for the audio thread.
+    // Inputs:
+    // - int pad: The pad, 0 to numPads - 1.
+    // - const juce::File& file: An audio file readable by the basic formats.
+    // Outputs: False if the file can't be read or is longer than maxLengthSeconds.
+    bool loadSample(int pad, const juce::File& file);
+    /**Removes the sample from a pad*/
+    void clearSample(int pad);
+    /**Returns the name of the file on a pad, or an empty string*/
+    juce::String getSampleName(int pad) const;
+
+    // Function: trigger
+    // Purpose: Queues a pad to start on the next block. Lock-free; call from one thread only.
+    // Inputs:
+    // - int pad: The pad to play.
+    // - float velocity: The gain of this hit, 0 to 1.
+    // Outputs: False if the queue is full and the trigger was dropped.
+    bool trigger(int pad, float velocity = 1.0f) noexcept;
+
+    /**Sets the gain of all pads*/
+    void setGain(float gain) { masterGain = gain; }
+    /**Returns how many voices were stolen since the start*/
+    int getNumStolenVoices() const noexcept { return stolenVoices.load(); }
+
+private:
+    static constexpr double maxLengthSeconds = 30.0;
+    static constexpr double stealFadeSeconds = 0.005;
+    static constexpr int triggerQueueSize = 256;
+
+    // A decoded file, read-only once built
+    struct Sample
+    {
+        juce::AudioBuffer<float> audio;
+        double sampleRate = 44100.0;
+        juce::String name;
+    };
+
+    struct Voice
+    {
+        const Sample* sample = nullptr; // nullptr when the voice is free
+        int pad = -1;
+        double position = 0.0;
+        float gain = 1.0f;
+        juce::uint64 startOrder = 0;    // voices that started earlier are stolen first
+    };
+
+    struct Trigger
+    {
+        int pad;
+        float velocity;
+    };
+
+    // Picks up samples loaded since the last block, fading out voices still on the old ones
+    void swapPendingSamples(juce::AudioBuffer<float>& buffer, int startSample, int numSamples) noexcept;
+    void startVoice(int pad, float velocity, juce::AudioBuffer<float>& buffer, int startSample, int numSamples) noexcept;
+    // Adds numSamples of a voice to the buffer with a gain ramp, and frees it at its end
+    void renderVoice(Voice& voice, juce::AudioBuffer<float>& buffer, int startSample, int numSamples,
+                     float rampStart, float rampEnd) noexcept;
+    // Renders a short fade-out of a voice and frees it
+    void fadeOutVoice(Voice& voice, juce::AudioBuffer<float>& buffer, int startSample, int numSamples) noexcept;
+    void setSample(int pad, std::unique_ptr<Sample> newSample);
+
+    juce::AudioFormatManager formatManager;
+
+    // As in ConvolutionReverbAudioSource, the audio thread owns the active samples. A standby
+    // sample is either waiting to be picked up or retired, and then destroyed on the message thread.
+    juce::SpinLock sampleLock;
+    std::unique_ptr<Sample> activeSamples[numPads];
+    std::unique_ptr<Sample> standbySamples[numPads];
+    std::atomic<bool> sampleChangePending[numPads];
+    std::atomic<bool> anySampleChangePending{ false };
+    juce::String sampleNames[numPads]; // message thread copy
+
+    juce::AbstractFifo triggerFifo{ triggerQueueSize };
+    Trigger triggers[triggerQueueSize];
+
+    // Audio thread only
+    Voice voices[numVoices];
+    juce::uint64 nextStartOrder = 0;
+    double currentSampleRate = 44100.0;
+    int stealFadeSamples = 220;
+
+    std::atomic<float> masterGain{ 1.0f };
+    std::atomic<int> stolenVoices{ 0 };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SamplePadSource)
+};
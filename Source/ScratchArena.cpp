@@ -0,0 +1,64 @@
+/*
+  ==============================================================================
+    ScratchArena.cpp
+    Created: 18 Oct 2026 8:02:31pm
+  ==============================================================================
+*/
+
+#include "ScratchArena.h"
+
+// Function: clear
+// Purpose: Forgets every reservation and releases the memory.
+void ScratchArena::clear()
+{
+    reservations.clear();
+    totalFloats = 0;
+    memory.free();
+    alignedStart = nullptr;
+    sizeInBytes = 0;
+}
+
+// Function: reserve
+// Purpose: Lays out a buffer after the previous ones, padding each channel to a cache line.
+// Inputs:
+//   numChannels - The number of channels.
+//   numSamples - The number of samples per channel.
+// Outputs: The handle of the reservation.
+int ScratchArena::reserve(int numChannels, int numSamples)
+{
+    jassert(alignedStart == nullptr); // reserve everything before allocating
+    jassert(numChannels > 0 && numSamples > 0);
+
+    constexpr size_t floatsPerLine = alignment / sizeof(float);
+    const size_t stride = ((size_t) numSamples + floatsPerLine - 1) / floatsPerLine * floatsPerLine;
+
+    reservations.push_back({ totalFloats, stride, numChannels, numSamples });
+    totalFloats += stride * (size_t) numChannels;
+
+    return (int) reservations.size() - 1;
+}
+
+// Function: allocate
+// Purpose: Allocates the arena with room to align its start to a cache line.
+void ScratchArena::allocate()
+{
+    sizeInBytes = totalFloats * sizeof(float);
+    memory.calloc(sizeInBytes + alignment);
+
+    const auto address = reinterpret_cast<uintptr_t>(memory.get());
+    alignedStart = reinterpret_cast<float*>((address + alignment - 1) & ~(uintptr_t) (alignment - 1));
+}
+
+// Function: getChannelPointer
+// Purpose: Looks up one channel of a reserved buffer.
+// Inputs:
+//   handle - The value returned by reserve.
+//   channel - The channel index.
+float* ScratchArena::getChannelPointer(int handle, int channel) const noexcept
+{
+    jassert(alignedStart != nullptr);
+    const auto& reservation = reservations[(size_t) handle];
+    jassert(channel < reservation.numChannels);
+
+    return alignedStart + reservation.offset + reservation.channelStride * (size_t) channel;
+}
@@ -0,0 +1,71 @@
+/*
+  ==============================================================================
+    ScratchArena.h
+    Created: 18 Oct 2026 8:02:31pm
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <vector>
+
+// One block of memory that the stages of an audio chain share for their temporary buffers.
+//
+// Preparing a chain is done in two steps: every stage reserves the buffers it needs for the
+// agreed maximum block size, then the owner allocates the arena once. On the audio thread
+// stages only look up their channel pointers, so nothing is allocated while processing.
+// Every channel starts on its own cache line.
+class ScratchArena
+{
+public:
+    ScratchArena() = default;
+
+    // Function: clear
+    // Purpose: Drops every reservation and frees the memory. Not for the audio thread.
+    void clear();
+
+    // Function: reserve
+    // Purpose: Requests a multichannel buffer. Only valid before allocate.
+    // Inputs:
+    // - int numChannels: The number of channels.
+    // - int numSamples: The number of samples per channel.
+    // Outputs: A handle for getChannelPointer.
+    int reserve(int numChannels, int numSamples);
+
+    // Function: allocate
+    // Purpose: Allocates one aligned block that holds every reserved buffer, cleared to zero.
+    void allocate();
+
+    // Function: getChannelPointer
+    // Purpose: Returns the start of one channel of a reserved buffer. Safe on the audio thread.
+    // Inputs:
+    // - int handle: The value returned by reserve.
+    // - int channel: The channel index.
+    float* getChannelPointer(int handle, int channel) const noexcept;
+
+    /**Returns the number of samples per channel of a reserved buffer*/
+    int getNumSamples(int handle) const noexcept { return reservations[(size_t) handle].numSamples; }
+    /**Returns the size of the allocated memory in bytes*/
+    size_t getSizeInBytes() const noexcept { return sizeInBytes; }
+
+private:
+    static constexpr size_t alignment = 64;
+
+    struct Reservation
+    {
+        size_t offset;        // in floats from the aligned start
+        size_t channelStride; // in floats, a multiple of the alignment
+        int numChannels;
+        int numSamples;
+    };
+
+    std::vector<Reservation> reservations;
+    size_t totalFloats = 0;
+
+    juce::HeapBlock<char> memory;
+    float* alignedStart = nullptr;
+    size_t sizeInBytes = 0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ScratchArena)
+};
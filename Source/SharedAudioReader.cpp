@@ -0,0 +1,199 @@
+/*
+  ==============================================================================
+    SharedAudioReader.cpp
+    Created: 19 Oct 2026 7:31:26am
+  ==============================================================================
+*/
+
+#include "SharedAudioReader.h"
+#include <limits>
+
+// Each window needs a slot for the partly played block at either end as well
+SharedAudioReader::SharedAudioReader(std::unique_ptr<juce::AudioFormatReader> readerToShare, juce::TimeSliceThread* threadToUse,
+                                     int samplesAheadToUse, int samplesBehindToUse)
+    : reader(std::move(readerToShare)),
+      thread(threadToUse),
+      numChannels(juce::jlimit(1, 2, (int) reader->numChannels)),
+      samplesAhead(juce::jmax(blockSize, samplesAheadToUse)),
+      samplesBehind(juce::jmax(0, samplesBehindToUse)),
+      numSlots(cachedWindows * ((samplesAhead + samplesBehind + blockSize - 1) / blockSize + 2)),
+      storage(numChannels, numSlots * blockSize),
+      slotBlocks(new std::atomic<juce::int64>[(size_t) numSlots])
+{
+    for (int slot = 0; slot < numSlots; ++slot)
+        slotBlocks[(size_t) slot] = noBlock;
+
+    for (auto& position : readerPositions)
+        position = noReader;
+
+    if (thread != nullptr)
+        thread->addTimeSliceClient(this);
+}
+
+SharedAudioReader::~SharedAudioReader()
+{
+    if (thread != nullptr)
+        thread->removeTimeSliceClient(this);
+}
+
+int SharedAudioReader::addReader(juce::int64 position) noexcept
+{
+    for (int index = 0; index < maxReaders; ++index)
+    {
+        auto expected = noReader;
+
+        if (readerPositions[(size_t) index].compare_exchange_strong(expected, juce::jmax((juce::int64) 0, position)))
+            return index;
+    }
+
+    return -1;
+}
+
+void SharedAudioReader::removeReader(int index) noexcept
+{
+    if (juce::isPositiveAndBelow(index, maxReaders))
+        readerPositions[(size_t) index] = noReader;
+}
+
+void SharedAudioReader::setReaderPosition(int index, juce::int64 position) noexcept
+{
+    if (juce::isPositiveAndBelow(index, maxReaders))
+        readerPositions[(size_t) index] = juce::jmax((juce::int64) 0, position);
+}
+
+// Function: read
+// Purpose: Copies block by block. The fence keeps the copy before the second look at the tag,
+//          which pairs with the fence the thread puts between clearing a tag and writing.
+int SharedAudioReader::read(juce::AudioBuffer<float>& destination, int startSample, juce::int64 position, int numSamples) noexcept
+{
+    if (thread == nullptr && !decoding.exchange(true))
+    {
+        while (decodeNextBlock()) {}
+        decoding = false;
+    }
+
+    int copied = 0;
+
+    while (copied < numSamples && position + copied >= 0)
+    {
+        const auto block = (position + copied) / blockSize;
+        const int offset = (int) ((position + copied) % blockSize);
+        const int slot = findSlot(block);
+
+        if (slot < 0)
+            break;
+
+        const int count = juce::jmin(numSamples - copied, blockSize - offset);
+
+        for (int channel = 0; channel < destination.getNumChannels(); ++channel)
+            destination.copyFrom(channel, startSample + copied, storage, juce::jmin(channel, numChannels - 1),
+                                 slot * blockSize + offset, count);
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+
+        if (slotBlocks[(size_t) slot].load(std::memory_order_relaxed) != block)
+            break;
+
+        copied += count;
+    }
+
+    return copied;
+}
+
+bool SharedAudioReader::isCached(juce::int64 start, int numSamples) const noexcept
+{
+    const auto end = juce::jmin(start + numSamples, reader->lengthInSamples);
+
+    for (auto block = juce::jmax((juce::int64) 0, start) / blockSize; block * blockSize < end; ++block)
+        if (findSlot(block) < 0)
+            return false;
+
+    return true;
+}
+
+int SharedAudioReader::findSlot(juce::int64 block) const noexcept
+{
+    for (int slot = 0; slot < numSlots; ++slot)
+        if (slotBlocks[(size_t) slot].load(std::memory_order_acquire) == block)
+            return slot;
+
+    return -1;
+}
+
+int SharedAudioReader::useTimeSlice()
+{
+    return decodeNextBlock() ? 0 : idleMilliseconds;
+}
+
+// Function: decodeNextBlock
+// Purpose: Each reader wants the blocks from its position to samplesAhead past it and keeps
+//          those back to samplesBehind before it. The first missing block of the reader
+//          nearest to running out is decoded next, into an empty slot or one no reader keeps.
+bool SharedAudioReader::decodeNextBlock()
+{
+    const auto length = reader->lengthInSamples;
+    juce::int64 positions[maxReaders];
+    auto wanted = noBlock;
+    auto wantedDistance = std::numeric_limits<juce::int64>::max();
+
+    for (int index = 0; index < maxReaders; ++index)
+    {
+        const auto position = positions[index] = readerPositions[(size_t) index].load();
+
+        if (position == noReader || position >= length)
+            continue;
+
+        const auto lastBlock = (juce::jmin(length, position + samplesAhead) - 1) / blockSize;
+
+        for (auto block = position / blockSize; block <= lastBlock; ++block)
+        {
+            if (findSlot(block) >= 0)
+                continue;
+
+            const auto distance = juce::jmax((juce::int64) 0, block * blockSize - position);
+
+            if (distance < wantedDistance)
+            {
+                wanted = block;
+                wantedDistance = distance;
+            }
+
+            break;
+        }
+    }
+
+    if (wanted == noBlock)
+        return false;
+
+    const auto isKept = [&](juce::int64 block)
+    {
+        for (const auto position : positions)
+            if (position != noReader && block >= (position - samplesBehind) / blockSize
+                && block <= (position + samplesAhead - 1) / blockSize)
+                return true;
+
+        return false;
+    };
+
+    int victim = -1;
+
+    for (int slot = 0; slot < numSlots && victim < 0; ++slot)
+    {
+        const auto block = slotBlocks[(size_t) slot].load(std::memory_order_relaxed);
+
+        if (block == noBlock || !isKept(block))
+            victim = slot;
+    }
+
+    if (victim < 0)
+        return false;
+
+    slotBlocks[(size_t) victim].store(noBlock, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    // Samples past the end are read as silence
+    reader->read(&storage, victim * blockSize, blockSize, wanted * blockSize, true, true);
+
+    slotBlocks[(size_t) victim].store(wanted, std::memory_order_release);
+    return true;
+}
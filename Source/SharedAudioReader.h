@@ -0,0 +1,100 @@
+/*
+  ==============================================================================
+    SharedAudioReader.h
+    Created: 19 Oct 2026 7:31:26am
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <array>
+#include <atomic>
+#include <memory>
+
+// The decoded audio of a loaded track, shared by every deck that plays it.
+//
+// The decoder exists once, and only the read-ahead thread reads it: it decodes the blocks
+// around each deck's play position into one cache, which the decks copy from. Cloning a deck
+// therefore opens, parses and decodes nothing and allocates no audio; the clone starts on the
+// blocks the first deck already has, and only once the two decks are apart does the thread
+// decode for each of them.
+//
+// Copying takes no lock. Each slot of the cache is tagged with the block it holds. The thread
+// clears a slot's tag before overwriting the slot and tags it again once the block is
+// complete, so a reader that finds the tag unchanged after copying has copied a whole block.
+class SharedAudioReader : public juce::ReferenceCountedObject,
+                          private juce::TimeSliceClient
+{
+public:
+    using Ptr = juce::ReferenceCountedObjectPtr<SharedAudioReader>;
+
+    // Function: SharedAudioReader
+    // Purpose: Takes ownership of a reader created by the format manager and sets the cache
+    //          aside, so nothing is allocated while the track plays.
+    // Inputs:
+    // - std::unique_ptr<juce::AudioFormatReader> readerToShare: The decoder.
+    // - juce::TimeSliceThread* thread: The thread that decodes, or nullptr to decode on the
+    //   thread that reads.
+    // - int samplesAhead, samplesBehind: Track samples kept ahead of and behind each reader.
+    SharedAudioReader(std::unique_ptr<juce::AudioFormatReader> readerToShare, juce::TimeSliceThread* thread,
+                      int samplesAhead, int samplesBehind);
+    ~SharedAudioReader() override;
+
+    /**Registers a reader at a position and returns its index, or -1 if every one is taken; message thread*/
+    int addReader(juce::int64 position) noexcept;
+    /**Stops decoding for a reader; message thread*/
+    void removeReader(int reader) noexcept;
+    /**Moves a reader, so the thread decodes around its new position; any thread, never blocks*/
+    void setReaderPosition(int reader, juce::int64 position) noexcept;
+
+    // Function: read
+    // Purpose: Copies samples from a track position on, up to the first block that isn't
+    //          cached. A destination with more channels than the cache repeats its last one.
+    //          Any thread, never blocks; without a thread the missing blocks are decoded first.
+    // Outputs: The number of samples copied.
+    int read(juce::AudioBuffer<float>& destination, int startSample, juce::int64 position, int numSamples) noexcept;
+    /**Tells whether a range is cached; samples past the end count as cached*/
+    bool isCached(juce::int64 start, int numSamples) const noexcept;
+
+    /**Returns the decoder's sample rate*/
+    double getSampleRate() const noexcept { return reader->sampleRate; }
+    /**Returns the channels cached of the track, 1 or 2*/
+    int getNumChannels() const noexcept { return numChannels; }
+    /**Returns the length of the track in samples*/
+    juce::int64 getLengthInSamples() const noexcept { return reader->lengthInSamples; }
+
+private:
+    int useTimeSlice() override;
+    // Function: decodeNextBlock
+    // Purpose: Decodes the missing block nearest ahead of any reader into a slot no reader
+    //          needs. Decoding thread only.
+    // Outputs: False if no block is missing or every slot is needed.
+    bool decodeNextBlock();
+    /**Returns the slot holding a block, or -1*/
+    int findSlot(juce::int64 block) const noexcept;
+
+    // Track samples per slot
+    static constexpr int blockSize = 4096;
+    // Every deck, plus the track each one is replacing while it loads
+    static constexpr int maxReaders = 4;
+    // The cache holds the windows of this many readers apart from each other: both decks
+    static constexpr int cachedWindows = 2;
+    static constexpr int idleMilliseconds = 5;
+    static constexpr juce::int64 noBlock = -1;
+    static constexpr juce::int64 noReader = -1;
+
+    std::unique_ptr<juce::AudioFormatReader> reader;
+    juce::TimeSliceThread* thread;
+    const int numChannels;
+    const int samplesAhead;
+    const int samplesBehind;
+    const int numSlots;
+    juce::AudioBuffer<float> storage;
+    std::unique_ptr<std::atomic<juce::int64>[]> slotBlocks;
+    std::array<std::atomic<juce::int64>, maxReaders> readerPositions;
+    // Without a thread, whichever reader finds it clear decodes; the others play what is cached
+    std::atomic<bool> decoding{ false };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SharedAudioReader)
+};
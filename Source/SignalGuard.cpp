@@ -0,0 +1,121 @@
+/*
+  ==============================================================================
+    SignalGuard.cpp
+    Created: 19 Oct 2026 6:21:52am
+  ==============================================================================
+*/
+
+#include "SignalGuard.h"
+#include "AsyncLogger.h"
+#include <cstring>
+
+SignalGuard::SignalGuard(std::initializer_list<const char*> stageNames)
+{
+    jassert(stageNames.size() <= (size_t) maxStages);
+
+    for (auto* name : stageNames)
+        if (numStages < maxStages)
+            names[numStages++] = name;
+
+    for (int stage = 0; stage < maxStages; ++stage)
+    {
+        denormalBlocks[stage] = 0;
+        nonFiniteBlocks[stage] = 0;
+    }
+}
+
+// Function: scan
+// Purpose: Reads the exponent of every sample: all zeros with a mantissa is a denormal, all
+//          ones is an infinity or a NaN. The flags are OR-ed so the loop vectorizes.
+int SignalGuard::scan(const float* samples, int numSamples) noexcept
+{
+    juce::uint32 denormals = 0;
+    juce::uint32 nonFinite = 0;
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        juce::uint32 bits;
+        std::memcpy(&bits, samples + i, sizeof(bits));
+
+        const juce::uint32 exponent = bits & 0x7f800000u;
+        const juce::uint32 mantissa = bits & 0x007fffffu;
+
+        denormals |= (juce::uint32) (exponent == 0) & (juce::uint32) (mantissa != 0);
+        nonFinite |= (juce::uint32) (exponent == 0x7f800000u);
+    }
+
+    return (denormals != 0 ? denormalValue : none) | (nonFinite != 0 ? nonFiniteValue : none);
+}
+
+int SignalGuard::scan(const juce::AudioBuffer<float>& buffer, int startSample, int numSamples) noexcept
+{
+    int problems = none;
+
+    for (int channel = 0; channel < buffer.getNumChannels(); ++channel)
+        problems |= scan(buffer.getReadPointer(channel, startSample), numSamples);
+
+    return problems;
+}
+
+// Function: check
+// Purpose: Counts the block once per problem, and silences it if it isn't finite.
+bool SignalGuard::check(int stage, juce::AudioBuffer<float>& buffer, int startSample, int numSamples) noexcept
+{
+    jassert(stage >= 0 && stage < numStages);
+
+    const int problems = scan(buffer, startSample, numSamples);
+
+    if (problems == none)
+        return false;
+
+    if ((problems & denormalValue) != 0)
+        denormalBlocks[stage].fetch_add(1, std::memory_order_relaxed);
+
+    if ((problems & nonFiniteValue) == 0)
+        return false;
+
+    nonFiniteBlocks[stage].fetch_add(1, std::memory_order_relaxed);
+    buffer.clear(startSample, numSamples);
+
+    RT_LOG_RATE_LIMITED(warning, 1000, "SignalGuard silenced NaN or infinite output and resets the stage, stage:", stage);
+    return true;
+}
+
+int SignalGuard::getTotalDenormalBlocks() const noexcept
+{
+    int total = 0;
+
+    for (int stage = 0; stage < numStages; ++stage)
+        total += denormalBlocks[stage].load();
+
+    return total;
+}
+
+int SignalGuard::getTotalNonFiniteBlocks() const noexcept
+{
+    int total = 0;
+
+    for (int stage = 0; stage < numStages; ++stage)
+        total += nonFiniteBlocks[stage].load();
+
+    return total;
+}
+
+// Function: getReport
+// Purpose: Lists the counts of every stage that had a problem since the start.
+juce::String SignalGuard::getReport(const juce::String& owner) const
+{
+    juce::StringArray lines;
+
+    for (int stage = 0; stage < numStages; ++stage)
+    {
+        const int denormals = denormalBlocks[stage].load();
+        const int nonFinite = nonFiniteBlocks[stage].load();
+
+        if (denormals > 0 || nonFinite > 0)
+            lines.add(owner + " " + names[stage] + ": " + juce::String(denormals) + " blocks with denormals, "
+                      + juce::String(nonFinite) + " with NaN or infinite samples");
+    }
+
+    return lines.joinIntoString("\n");
+}
@@ -0,0 +1,77 @@
+/*
+  ==============================================================================
+    SignalGuard.h
+    Created: 19 Oct 2026 6:21:52am
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <atomic>
+#include <initializer_list>
+
+// Looks at the output of each stage of a DSP chain for denormal, NaN and infinite samples, and
+// counts the blocks they showed up in.
+//
+// Every thread that renders audio runs with denormals flushed to zero (see ThreadPolicy), so
+// denormals found here came from somewhere that isn't, like a plugin's own thread; they are
+// only counted. A NaN or an infinity would stay in a filter's or a reverb's feedback path and
+// spread to the whole mix, so the block is silenced and the owner resets the stage.
+//
+// A scan is one pass over the block's bits without branches. Counters are written by the audio
+// thread and read by the message thread.
+class SignalGuard
+{
+public:
+    static constexpr int maxStages = 6;
+
+    enum Problem
+    {
+        none = 0,
+        denormalValue = 1,
+        nonFiniteValue = 2
+    };
+
+    // Function: SignalGuard
+    // Inputs:
+    // - std::initializer_list<const char*> stageNames: String literals naming the guarded
+    //   stages in order, at most maxStages.
+    explicit SignalGuard(std::initializer_list<const char*> stageNames);
+
+    // Function: scan
+    // Purpose: Looks for denormal and non-finite samples in some channel data.
+    // Outputs: The Problem flags found.
+    static int scan(const float* samples, int numSamples) noexcept;
+    /**Scans a region of every channel of a buffer*/
+    static int scan(const juce::AudioBuffer<float>& buffer, int startSample, int numSamples) noexcept;
+
+    // Function: check
+    // Purpose: Scans a stage's output and counts what it found. A region with NaN or infinite
+    //          samples is cleared. Audio thread, lock-free.
+    // Outputs: True if the stage produced NaN or infinite samples and must be reset.
+    bool check(int stage, juce::AudioBuffer<float>& buffer, int startSample, int numSamples) noexcept;
+
+    /**Returns the number of blocks of a stage that held denormals*/
+    int getDenormalBlocks(int stage) const noexcept { return denormalBlocks[stage].load(); }
+    /**Returns the number of blocks of a stage that held NaN or infinite samples, one reset each*/
+    int getNonFiniteBlocks(int stage) const noexcept { return nonFiniteBlocks[stage].load(); }
+    /**Returns the blocks with any problem over every stage*/
+    int getTotalDenormalBlocks() const noexcept;
+    int getTotalNonFiniteBlocks() const noexcept;
+
+    // Function: getReport
+    // Purpose: Describes the stages that had problems, one line each.
+    // Inputs:
+    // - const juce::String& owner: Put in front of every line, like the deck's name.
+    juce::String getReport(const juce::String& owner) const;
+
+private:
+    const char* names[maxStages] = {};
+    int numStages = 0;
+
+    std::atomic<int> denormalBlocks[maxStages];
+    std::atomic<int> nonFiniteBlocks[maxStages];
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SignalGuard)
+};
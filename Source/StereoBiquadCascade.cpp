@@ -0,0 +1,313 @@
+/*
+  ==============================================================================
+    StereoBiquadCascade.cpp
+    Created: 18 Oct 2026 10:12:40am
+  ==============================================================================
+*/
+
+#include "StereoBiquadCascade.h"
+#include "BlockBenchmark.h"
+#include <iostream>
+
+namespace
+{
+    const char* const benchmarkOption = "--benchmark-filters";
+}
+
+// Constructor: Sets every stage to unity gain with cleared state
+StereoBiquadCascade::StereoBiquadCascade()
+{
+    for (auto& stage : stages)
+    {
+        stage.b0 = Vector::expand(1.0f);
+        stage.b1 = Vector::expand(0.0f);
+        stage.b2 = Vector::expand(0.0f);
+        stage.a1 = Vector::expand(0.0f);
+        stage.a2 = Vector::expand(0.0f);
+    }
+
+    reset();
+}
+
+// Function: reset
+// Purpose: Clears the delay elements of every stage.
+void StereoBiquadCascade::reset()
+{
+    for (auto& stage : stages)
+    {
+        stage.s1 = Vector::expand(0.0f);
+        stage.s2 = Vector::expand(0.0f);
+    }
+}
+
+// Function: setCoefficients
+// Purpose: Normalises the raw coefficients by a0 and broadcasts them to every lane.
+// Inputs:
+//   stage - The stage to update.
+//   rawCoefficients - b0, b1, b2, a0, a1, a2.
+void StereoBiquadCascade::setCoefficients(Stage stage, const std::array<float, 6>& rawCoefficients)
+{
+    jassert(rawCoefficients[3] != 0.0f);
+    const float a0Inverse = 1.0f / rawCoefficients[3];
+
+    auto& biquad = stages[(size_t) stage];
+    biquad.b0 = Vector::expand(rawCoefficients[0] * a0Inverse);
+    biquad.b1 = Vector::expand(rawCoefficients[1] * a0Inverse);
+    biquad.b2 = Vector::expand(rawCoefficients[2] * a0Inverse);
+    biquad.a1 = Vector::expand(rawCoefficients[4] * a0Inverse);
+    biquad.a2 = Vector::expand(rawCoefficients[5] * a0Inverse);
+}
+
+// Function: setStageEnabled
+// Purpose: Starts a fade towards the requested state, or switches immediately.
+// Inputs:
+//   stage - The stage to switch.
+//   shouldBeEnabled - Whether the stage should be in the signal path.
+//   withFade - Whether to crossfade the change.
+void StereoBiquadCascade::setStageEnabled(Stage stage, bool shouldBeEnabled, bool withFade)
+{
+    const auto index = (size_t) stage;
+
+    // Repeated requests must not restart a fade that is already running
+    if (stageEnabled[index] == shouldBeEnabled && (withFade || fadeSamplesRemaining[index] == 0))
+        return;
+
+    // A stage that has been out of the signal path starts again from silence
+    if (shouldBeEnabled && stageMix[index] == 0.0f)
+    {
+        stages[index].s1 = Vector::expand(0.0f);
+        stages[index].s2 = Vector::expand(0.0f);
+    }
+
+    stageEnabled[index] = shouldBeEnabled;
+    const float target = shouldBeEnabled ? 1.0f : 0.0f;
+
+    if (withFade && fadeLength > 0)
+    {
+        fadeSamplesRemaining[index] = fadeLength;
+        stageMixStep[index] = (target - stageMix[index]) / (float) fadeLength;
+    }
+    else
+    {
+        fadeSamplesRemaining[index] = 0;
+        stageMixStep[index] = 0.0f;
+        stageMix[index] = target;
+    }
+}
+
+// Function: setFadeLength
+// Purpose: Sets the fade length used by setStageEnabled.
+// Inputs:
+//   numSamples - The fade length in samples.
+void StereoBiquadCascade::setFadeLength(int numSamples)
+{
+    fadeLength = juce::jmax(0, numSamples);
+}
+
+// Function: advanceFades
+// Purpose: Steps the mix of every fading stage and snaps it to its target at the end.
+void StereoBiquadCascade::advanceFades() noexcept
+{
+    for (size_t i = 0; i < (size_t) numStages; ++i)
+    {
+        if (fadeSamplesRemaining[i] > 0)
+        {
+            stageMix[i] += stageMixStep[i];
+
+            if (--fadeSamplesRemaining[i] == 0)
+                stageMix[i] = stageEnabled[i] ? 1.0f : 0.0f;
+        }
+    }
+}
+
+// Function: processChain
+// Purpose: Loads one frame of both channels into a register, runs it through the stages
+//          chosen at compile time and writes it back, so the audio is only read and written once.
+// Inputs:
+//   left, right - The channel data, processed in place. right may be nullptr.
+//   numSamples - The number of samples per channel.
+template <bool useLowPass, bool useBandPass, bool useHighPass, bool isFading>
+void StereoBiquadCascade::processChain(float* left, float* right, int numSamples) noexcept
+{
+    // Work on local copies so the compiler can keep the whole cascade in registers
+    auto lp = stages[lowPassStage];
+    auto bp = stages[bandPassStage];
+    auto hp = stages[highPassStage];
+
+    alignas (Vector::SIMDRegisterSize) float frame[Vector::SIMDNumElements] = {};
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        frame[0] = left[i];
+        frame[1] = right != nullptr ? right[i] : 0.0f;
+
+        auto x = Vector::fromRawArray(frame);
+
+        if constexpr (useLowPass)
+        {
+            auto y = lp.b0 * x + lp.s1;
+            lp.s1 = lp.b1 * x - lp.a1 * y + lp.s2;
+            lp.s2 = lp.b2 * x - lp.a2 * y;
+
+            if constexpr (isFading)
+                x = x + (y - x) * stageMix[lowPassStage];
+            else
+                x = y;
+        }
+
+        if constexpr (useBandPass)
+        {
+            auto y = bp.b0 * x + bp.s1;
+            bp.s1 = bp.b1 * x - bp.a1 * y + bp.s2;
+            bp.s2 = bp.b2 * x - bp.a2 * y;
+
+            if constexpr (isFading)
+                x = x + (y - x) * stageMix[bandPassStage];
+            else
+                x = y;
+        }
+
+        if constexpr (useHighPass)
+        {
+            auto y = hp.b0 * x + hp.s1;
+            hp.s1 = hp.b1 * x - hp.a1 * y + hp.s2;
+            hp.s2 = hp.b2 * x - hp.a2 * y;
+
+            if constexpr (isFading)
+                x = x + (y - x) * stageMix[highPassStage];
+            else
+                x = y;
+        }
+
+        if constexpr (isFading)
+            advanceFades();
+
+        x.copyToRawArray(frame);
+        left[i] = frame[0];
+        if (right != nullptr)
+            right[i] = frame[1];
+    }
+
+    if constexpr (useLowPass)
+    {
+        stages[lowPassStage].s1 = lp.s1;
+        stages[lowPassStage].s2 = lp.s2;
+    }
+    if constexpr (useBandPass)
+    {
+        stages[bandPassStage].s1 = bp.s1;
+        stages[bandPassStage].s2 = bp.s2;
+    }
+    if constexpr (useHighPass)
+    {
+        stages[highPassStage].s1 = hp.s1;
+        stages[highPassStage].s2 = hp.s2;
+    }
+}
+
+// Function: makeChainTable
+// Purpose: Instantiates processChain for every combination of stages, with and without fades.
+//          Bit 0 of the index selects the low pass, bit 1 the band pass, bit 2 the high pass
+//          and bit 3 the fading variant.
+template <size_t... index>
+constexpr std::array<StereoBiquadCascade::ChainFunction, sizeof...(index)>
+StereoBiquadCascade::makeChainTable(std::index_sequence<index...>)
+{
+    return { { &StereoBiquadCascade::processChain<(index & 1) != 0, (index & 2) != 0, (index & 4) != 0, (index & 8) != 0>... } };
+}
+
+// Function: process
+// Purpose: Picks the chain variant that matches the active stages and runs it.
+// Inputs:
+//   left, right - The channel data, processed in place. right may be nullptr.
+//   numSamples - The number of samples per channel.
+void StereoBiquadCascade::process(float* left, float* right, int numSamples) noexcept
+{
+    static constexpr auto chains = makeChainTable(std::make_index_sequence<16>());
+
+    size_t variant = 0;
+    bool isFading = false;
+
+    for (size_t i = 0; i < (size_t) numStages; ++i)
+    {
+        // A stage that is fading out stays in the chain until its mix reaches zero
+        if (stageEnabled[i] || stageMix[i] > 0.0f)
+            variant |= (size_t) 1 << i;
+
+        isFading = isFading || fadeSamplesRemaining[i] > 0;
+    }
+
+    if (isFading)
+        variant |= 8;
+
+    (this->*chains[variant])(left, right, numSamples);
+}
+
+bool StereoBiquadCascade::isBenchmark(const juce::StringArray& arguments)
+{
+    return arguments.size() >= 1 && arguments[0] == benchmarkOption;
+}
+
+// Function: runBenchmark
+// Purpose: The old loop is three juce::dsp::IIR::Filter objects per channel, run over one
+//          channel after the other, with the same coefficients as the cascade's stages. Both
+//          process the same blocks from cleared state, so their outputs should match too.
+int StereoBiquadCascade::runBenchmark(const juce::StringArray& arguments)
+{
+    const int blockSize = BlockBenchmark::getBlockSize(arguments, 512);
+    const double sampleRate = 48000.0;
+    const BlockBenchmark benchmark(blockSize, sampleRate);
+
+    juce::AudioBuffer<float> cascadeOutput(2, blockSize);
+    juce::AudioBuffer<float> filterOutput(2, blockSize);
+
+    const std::array<std::array<float, 6>, numStages> coefficients{ {
+        juce::dsp::IIR::ArrayCoefficients<float>::makeLowPass(sampleRate, 8000.0f),
+        juce::dsp::IIR::ArrayCoefficients<float>::makeBandPass(sampleRate, 1000.0f, 0.7f),
+        juce::dsp::IIR::ArrayCoefficients<float>::makeHighPass(sampleRate, 100.0f) } };
+
+    StereoBiquadCascade cascade;
+    std::array<std::array<juce::dsp::IIR::Filter<float>, numStages>, 2> filters;
+    const juce::dsp::ProcessSpec spec{ sampleRate, (juce::uint32) blockSize, 1 };
+
+    for (size_t stage = 0; stage < numStages; ++stage)
+    {
+        cascade.setCoefficients((Stage) stage, coefficients[stage]);
+
+        for (auto& channelFilters : filters)
+        {
+            channelFilters[stage].prepare(spec);
+            *channelFilters[stage].coefficients = coefficients[stage];
+        }
+    }
+
+    const double cascadeSeconds = benchmark.time(cascadeOutput, [&]
+    {
+        cascade.process(cascadeOutput.getWritePointer(0), cascadeOutput.getWritePointer(1), blockSize);
+    });
+
+    const double filterSeconds = benchmark.time(filterOutput, [&]
+    {
+        for (int channel = 0; channel < 2; ++channel)
+        {
+            float* channelData = filterOutput.getWritePointer(channel);
+            juce::dsp::AudioBlock<float> block(&channelData, 1, (size_t) blockSize);
+            juce::dsp::ProcessContextReplacing<float> context(block);
+
+            for (auto& filter : filters[(size_t) channel])
+                filter.process(context);
+        }
+    });
+
+    float largestDifference = 0.0f;
+
+    for (int channel = 0; channel < 2; ++channel)
+        for (int sample = 0; sample < blockSize; ++sample)
+            largestDifference = juce::jmax(largestDifference, std::abs(cascadeOutput.getSample(channel, sample) - filterOutput.getSample(channel, sample)));
+
+    benchmark.printHeader();
+    benchmark.printResult("SIMD cascade", cascadeSeconds);
+    benchmark.printResult("per-channel IIR filters", filterSeconds);
+    std::cout << "cascade speed-up " << filterSeconds / cascadeSeconds << "x, largest output difference " << largestDifference << "\n";
+    return 0;
+}
@@ -0,0 +1,121 @@
+/*
+  ==============================================================================
+    StereoBiquadCascade.h
+    Created: 18 Oct 2026 10:12:40am
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <array>
+#include <utility>
+
+// This class runs the deck filter section (low pass -> band pass -> high pass) on both
+// channels of a stereo signal at once. Every channel keeps its own filter state, and the
+// two channels are carried in separate lanes of one SIMD register so that the whole
+// cascade is a single pass over the audio data.
+//
+// Stages can be switched on and off. The processing loop is a template over the set of
+// active stages, so a disabled stage is not compiled into the loop that runs while it is
+// off. Switching a stage crossfades it in or out over a short fade instead of cutting.
+class StereoBiquadCascade
+{
+public:
+    // The stages of the cascade, in processing order
+    enum Stage
+    {
+        lowPassStage = 0,
+        bandPassStage,
+        highPassStage,
+        numStages
+    };
+
+    // Constructor: Every stage starts as a pass-through filter
+    StereoBiquadCascade();
+
+    // Function: reset
+    // Purpose: Clears the state of every stage on every channel.
+    void reset();
+
+    // Function: setCoefficients
+    // Purpose: Replaces the coefficients of one stage. Does not allocate or touch the
+    //          filter state, so it can be called from the audio thread between blocks.
+    // Inputs:
+    // - Stage stage: The stage to update.
+    // - const std::array<float, 6>& rawCoefficients: b0, b1, b2, a0, a1, a2 as returned by
+    //   juce::dsp::IIR::ArrayCoefficients. They are normalised by a0 here.
+    void setCoefficients(Stage stage, const std::array<float, 6>& rawCoefficients);
+
+    // Function: setStageEnabled
+    // Purpose: Switches a stage on or off. Called from the audio thread between blocks.
+    // Inputs:
+    // - Stage stage: The stage to switch.
+    // - bool shouldBeEnabled: Whether the stage should be part of the chain.
+    // - bool withFade: If true the stage is faded in or out over the fade length,
+    //   otherwise it is switched immediately.
+    void setStageEnabled(Stage stage, bool shouldBeEnabled, bool withFade = true);
+
+    // Function: setFadeLength
+    // Purpose: Sets how long enabling or disabling a stage takes.
+    // Inputs:
+    // - int numSamples: The fade length in samples.
+    void setFadeLength(int numSamples);
+
+    // Function: process
+    // Purpose: Runs the active stages of the cascade in place over one or two channels.
+    // Inputs:
+    // - float* left: The first channel.
+    // - float* right: The second channel, or nullptr for mono material.
+    // - int numSamples: The number of samples in each channel.
+    void process(float* left, float* right, int numSamples) noexcept;
+
+    // Function: runBenchmark
+    // Purpose: Times the cascade against the per-channel IIR filter loop it replaced on the
+    //          same stereo noise and prints both to the standard output.
+    // Inputs:
+    // - const juce::StringArray& arguments: --benchmark-filters and optionally the block size.
+    // Outputs: 0 once both were timed.
+    static int runBenchmark(const juce::StringArray& arguments);
+
+    // Function: isBenchmark
+    // Purpose: Tells whether the app was started to benchmark the filter section.
+    // Inputs:
+    // - const juce::StringArray& arguments: The command line arguments.
+    // Outputs: true if the first argument is --benchmark-filters.
+    static bool isBenchmark(const juce::StringArray& arguments);
+
+private:
+    using Vector = juce::dsp::SIMDRegister<float>;
+
+    // One transposed direct form II biquad; lane 0 is the left channel, lane 1 the right
+    struct Biquad
+    {
+        Vector b0, b1, b2, a1, a2;
+        Vector s1, s2;
+    };
+
+    // Processes numSamples frames through the stages selected by the template arguments.
+    // isFading adds the per-sample crossfade used while a stage is switched.
+    template <bool useLowPass, bool useBandPass, bool useHighPass, bool isFading>
+    void processChain(float* left, float* right, int numSamples) noexcept;
+
+    using ChainFunction = void (StereoBiquadCascade::*)(float*, float*, int) noexcept;
+
+    template <size_t... index>
+    static constexpr std::array<ChainFunction, sizeof...(index)> makeChainTable(std::index_sequence<index...>);
+
+    // Moves every fading stage one sample closer to its target mix
+    void advanceFades() noexcept;
+
+    std::array<Biquad, numStages> stages;
+
+    // Mix of each stage: 0 means bypassed, 1 means fully in the signal path
+    std::array<bool, numStages> stageEnabled{ { true, true, true } };
+    std::array<float, numStages> stageMix{ { 1.0f, 1.0f, 1.0f } };
+    std::array<float, numStages> stageMixStep{};
+    std::array<int, numStages> fadeSamplesRemaining{};
+    int fadeLength = 441;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(StereoBiquadCascade)
+};
@@ -0,0 +1,569 @@
+/*
+  ==============================================================================
+    StreamingAudioSource.cpp
+    Created: 19 Oct 2026 8:02:37am
+  ==============================================================================
+*/
+
+#include "StreamingAudioSource.h"
+#include "AsyncLogger.h"
+#include "ThreadPolicy.h"
+#include <iostream>
+
+namespace
+{
+    const char* const streamCheckOption = "--stream-check";
+    // A cancel that takes longer than this fails the check
+    const double maximumCancelMilliseconds = 1000.0;
+    // Bytes the server sends before it stalls for good, for the cancel check
+    const juce::int64 bytesBeforeHang = 262144;
+
+    double millisecondsNow()
+    {
+        return juce::Time::getMillisecondCounterHiRes();
+    }
+
+    // Serves one file over HTTP to one client at a time, at a fixed rate with regular stalls,
+    // because a connection over the loopback never runs slow by itself. The request is only
+    // read, not parsed: every path gets the file.
+    class ThrottledServer : public juce::Thread
+    {
+    public:
+        ThrottledServer(const juce::File& file, int bytesPerSecondToSend, double stallEverySeconds, double stallLengthSeconds)
+            : juce::Thread("Stream check server"),
+              bytesPerSecond(juce::jmax(1, bytesPerSecondToSend)),
+              stallEveryMilliseconds(stallEverySeconds * 1000.0),
+              stallMilliseconds(stallLengthSeconds * 1000.0)
+        {
+            file.loadFileAsData(data);
+        }
+
+        ~ThrottledServer() override
+        {
+            signalThreadShouldExit();
+            listener.close();
+            stopThread(2000);
+        }
+
+        /**Listens on a free loopback port and starts serving*/
+        bool start()
+        {
+            if (!listener.createListener(0, "127.0.0.1"))
+                return false;
+
+            startThread();
+            return true;
+        }
+
+        int getPort() const { return listener.getBoundPort(); }
+        /**Makes the next connection stop sending after a first part and hold on until the client leaves*/
+        void hangNextConnection() { hangNext = true; }
+
+        void run() override
+        {
+            while (!threadShouldExit())
+            {
+                if (listener.waitUntilReady(true, 100) != 1)
+                    continue;
+
+                std::unique_ptr<juce::StreamingSocket> client(listener.waitForNextConnection());
+
+                if (client != nullptr)
+                    serve(*client);
+            }
+        }
+
+    private:
+        // Paced against the time since the body started, with the stalls added to it
+        void serve(juce::StreamingSocket& client)
+        {
+            char request[4096];
+
+            if (client.waitUntilReady(true, 2000) != 1 || client.read(request, (int) sizeof(request), false) <= 0)
+                return;
+
+            const juce::String header = "HTTP/1.0 200 OK\r\nContent-Type: application/octet-stream\r\nContent-Length: "
+                                        + juce::String((juce::int64) data.getSize()) + "\r\nConnection: close\r\n\r\n";
+
+            if (client.write(header.toRawUTF8(), (int) header.getNumBytesAsUTF8()) < 0)
+                return;
+
+            const bool hang = hangNext.exchange(false);
+            const int chunkBytes = juce::jmax(1, bytesPerSecond / 100);
+            double start = millisecondsNow();
+            double nextStall = start + stallEveryMilliseconds;
+
+            for (size_t sent = 0; sent < data.getSize() && !threadShouldExit();)
+            {
+                if (hang && (juce::int64) sent >= bytesBeforeHang)
+                {
+                    waitForClientToLeave(client);
+                    return;
+                }
+
+                if (stallEveryMilliseconds > 0.0 && millisecondsNow() >= nextStall)
+                {
+                    pause(stallMilliseconds);
+                    start += stallMilliseconds;
+                    nextStall = millisecondsNow() + stallEveryMilliseconds;
+                }
+
+                pause(start + (double) sent * 1000.0 / bytesPerSecond - millisecondsNow());
+
+                const int toSend = (int) juce::jmin((size_t) chunkBytes, data.getSize() - sent);
+
+                if (client.write(static_cast<const char*>(data.getData()) + sent, toSend) != toSend)
+                    return;
+
+                sent += (size_t) toSend;
+            }
+        }
+
+        /**Waits for a while, or until the server is stopped*/
+        void pause(double milliseconds)
+        {
+            const double end = millisecondsNow() + milliseconds;
+
+            while (!threadShouldExit() && millisecondsNow() < end)
+                wait(juce::jlimit(1, 10, (int) (end - millisecondsNow())));
+        }
+
+        // A closed connection reads as ready with nothing to read
+        void waitForClientToLeave(juce::StreamingSocket& client)
+        {
+            while (!threadShouldExit())
+            {
+                const int ready = client.waitUntilReady(true, 10);
+                char byte;
+
+                if (ready < 0 || (ready > 0 && client.read(&byte, 1, false) <= 0))
+                    return;
+            }
+        }
+
+        juce::StreamingSocket listener;
+        juce::MemoryBlock data;
+        const int bytesPerSecond;
+        const double stallEveryMilliseconds;
+        const double stallMilliseconds;
+        std::atomic<bool> hangNext{ false };
+    };
+
+    // Waits until a stream has connected or failed
+    bool waitUntilConnected(const StreamingAudioSource& source, double timeoutMilliseconds)
+    {
+        const double end = millisecondsNow() + timeoutMilliseconds;
+
+        while (!source.isReady() && source.getState() != StreamingAudioSource::failed && millisecondsNow() < end)
+            juce::Thread::sleep(5);
+
+        return source.isReady();
+    }
+}
+
+StreamingAudioSource::StreamingAudioSource(const juce::URL& urlToStream, juce::AudioFormatManager& manager)
+    : juce::Thread("Network stream"),
+      url(urlToStream),
+      formatManager(manager)
+{
+    startThread(juce::Thread::Priority::high);
+}
+
+// A worker waiting on the network is woken by cancelling its stream, so this never waits
+// for a connection timeout
+StreamingAudioSource::~StreamingAudioSource()
+{
+    signalThreadShouldExit();
+
+    {
+        const juce::ScopedLock lock(streamLock);
+
+        if (webStream != nullptr)
+            webStream->cancel();
+    }
+
+    stopThread(connectionTimeoutMs);
+}
+
+double StreamingAudioSource::getBufferedSeconds() const noexcept
+{
+    return isReady() ? fifo->getNumReady() / sourceSampleRate : 0.0;
+}
+
+double StreamingAudioSource::getTargetSeconds() const noexcept
+{
+    return isReady() ? targetSamples.load() / sourceSampleRate : initialTargetSeconds;
+}
+
+// The fade is sized when the stream's rate is known, and the transport prepares the source at that rate
+void StreamingAudioSource::prepareToPlay(int, double)
+{
+}
+
+void StreamingAudioSource::releaseResources()
+{
+}
+
+// Function: getNextAudioBlock
+// Purpose: Plays from the jitter buffer. A block that would leave less than a fade behind is
+//          faded out and the source goes back to buffering; the samples left over are played
+//          first, faded in, when the target is reached again. After the end the position keeps
+//          moving so the transport sees that the stream finished.
+void StreamingAudioSource::getNextAudioBlock(const juce::AudioSourceChannelInfo& bufferToFill)
+{
+    const int current = state.load();
+
+    if (current != buffering && current != playing)
+    {
+        bufferToFill.clearActiveBufferRegion();
+
+        if (current == ended)
+            playedSamples += bufferToFill.numSamples;
+
+        return;
+    }
+
+    const int ready = fifo->getNumReady();
+    const bool finished = decodeFinished.load();
+
+    if (current == buffering)
+    {
+        if (ready < targetSamples.load() && !finished)
+        {
+            bufferToFill.clearActiveBufferRegion();
+            return;
+        }
+
+        state = playing;
+    }
+
+    auto& buffer = *bufferToFill.buffer;
+    const int startSample = bufferToFill.startSample;
+    const int numSamples = juce::jmin(bufferToFill.numSamples, ready);
+    const bool runningLow = !finished && ready < bufferToFill.numSamples + fadeSamples;
+
+    int start1, size1, start2, size2;
+    fifo->prepareToRead(numSamples, start1, size1, start2, size2);
+
+    for (int channel = 0; channel < buffer.getNumChannels(); ++channel)
+    {
+        const int sourceChannel = juce::jmin(channel, sourceChannels - 1);
+        buffer.copyFrom(channel, startSample, jitterBuffer, sourceChannel, start1, size1);
+
+        if (size2 > 0)
+            buffer.copyFrom(channel, startSample + size1, jitterBuffer, sourceChannel, start2, size2);
+    }
+
+    fifo->finishedRead(size1 + size2);
+
+    if (runningLow)
+    {
+        buffer.applyGainRamp(startSample, numSamples, fadeGain, 0.0f);
+        fadeGain = 0.0f;
+        state = buffering;
+        growTarget();
+    }
+    else if (fadeGain < 1.0f)
+    {
+        const int rampSamples = juce::jmin(numSamples, (int) std::ceil((1.0f - fadeGain) * (float) fadeSamples));
+        const float endGain = juce::jmin(1.0f, fadeGain + (float) rampSamples / (float) fadeSamples);
+        buffer.applyGainRamp(startSample, rampSamples, fadeGain, endGain);
+        fadeGain = rampSamples == numSamples ? endGain : 1.0f;
+    }
+
+    if (numSamples < bufferToFill.numSamples)
+        buffer.clear(startSample + numSamples, bufferToFill.numSamples - numSamples);
+
+    playedSamples += numSamples;
+
+    if (finished && ready == numSamples)
+        state = ended;
+
+    // A long run without an underrun lowers the target, never below where it started
+    if (!runningLow && (samplesSinceUnderrun += numSamples) > (juce::int64) (stableSecondsBeforeShrinking * sourceSampleRate))
+    {
+        const int initialSamples = juce::roundToInt(initialTargetSeconds * sourceSampleRate);
+        targetSamples = juce::jmax(initialSamples, targetSamples.load() * 3 / 4);
+        samplesSinceUnderrun = 0;
+    }
+}
+
+// Function: growTarget
+// Purpose: Doubles the amount buffered before playback resumes, up to the maximum target.
+void StreamingAudioSource::growTarget() noexcept
+{
+    const int maximumSamples = juce::roundToInt(maximumTargetSeconds * sourceSampleRate);
+    targetSamples = juce::jmin(maximumSamples, targetSamples.load() * 2);
+    samplesSinceUnderrun = 0;
+    ++underruns;
+
+    RT_LOG_RATE_LIMITED(warning, 1000, "StreamingAudioSource underrun, count and new target in seconds:",
+                        underruns.load(), targetSamples.load() / sourceSampleRate);
+}
+
+void StreamingAudioSource::setNextReadPosition(juce::int64 newPosition)
+{
+    if (newPosition != playedSamples.load())
+        RT_LOG_RATE_LIMITED(info, 1000, "StreamingAudioSource can't seek, the position stays at:", playedSamples.load());
+}
+
+juce::int64 StreamingAudioSource::getTotalLength() const
+{
+    if (decodeFinished.load() || totalLength.load() > 0)
+        return totalLength.load();
+
+    // A live stream announces no length; a day is as good as endless for a deck
+    return (juce::int64) (juce::jmax(sourceSampleRate, 44100.0) * 86400.0);
+}
+
+// Function: connect
+// Purpose: Connects and opens a reader. The web stream stays owned here so the destructor can
+//          cancel it; the reader reads it through a buffer large enough for the formats to probe
+//          the header and rewind, which the web stream itself can't.
+bool StreamingAudioSource::connect()
+{
+    {
+        const juce::ScopedLock lock(streamLock);
+
+        if (threadShouldExit())
+            return false;
+
+        webStream = std::make_unique<juce::WebInputStream>(url, false);
+        webStream->withConnectionTimeout(connectionTimeoutMs);
+    }
+
+    if (!webStream->connect(nullptr) || webStream->getStatusCode() >= 400)
+    {
+        juce::Logger::writeToLog("StreamingAudioSource: can't connect to " + url.toString(false)
+                                 + ", status " + juce::String(webStream->getStatusCode()));
+        return false;
+    }
+
+    reader.reset(formatManager.createReaderFor(new juce::BufferedInputStream(webStream.get(), probeBufferBytes, false)));
+
+    if (reader == nullptr)
+    {
+        juce::Logger::writeToLog("StreamingAudioSource: no format can read " + url.toString(false));
+        return false;
+    }
+
+    sourceSampleRate = reader->sampleRate;
+    sourceChannels = (int) juce::jmax(1u, reader->numChannels);
+    fadeSamples = juce::jmax(1, juce::roundToInt(sourceSampleRate * fadeSeconds));
+    targetSamples = juce::roundToInt(initialTargetSeconds * sourceSampleRate);
+    totalLength = juce::jmax((juce::int64) 0, reader->lengthInSamples);
+
+    const int capacity = juce::roundToInt(capacitySeconds * sourceSampleRate);
+    jitterBuffer.setSize(sourceChannels, capacity);
+    fifo = std::make_unique<juce::AbstractFifo>(capacity);
+    decodeBuffer.setSize(sourceChannels, decodeBlockSize);
+
+    RT_LOG(info, "StreamingAudioSource connected, sample rate and channels:", sourceSampleRate, sourceChannels);
+    return true;
+}
+
+// Function: run
+// Purpose: Decodes a block whenever the jitter buffer has room for it. Reading blocks on the
+//          network here and nowhere else. The stream ends when the announced length is decoded,
+//          the server closes it or the connection fails. Only the samples written to the jitter
+//          buffer count as decoded, so the length at the end is what actually plays.
+void StreamingAudioSource::run()
+{
+    ThreadPolicy::applyToCurrentThread(ThreadPolicy::renderWorkerRole, "Network stream");
+
+    if (!connect())
+    {
+        state = failed;
+    }
+    else
+    {
+        state = buffering;
+
+        while (!threadShouldExit())
+        {
+            if (fifo->getFreeSpace() < decodeBlockSize)
+            {
+                wait(10);
+                continue;
+            }
+
+            if (reader->lengthInSamples > 0 && decodedSamples >= reader->lengthInSamples)
+                break;
+
+            // The last block of a stream with a length stops at its end, so no padding is buffered
+            const int numToDecode = reader->lengthInSamples > 0
+                                        ? (int) juce::jmin((juce::int64) decodeBlockSize, reader->lengthInSamples - decodedSamples)
+                                        : decodeBlockSize;
+
+            reader->read(&decodeBuffer, 0, numToDecode, decodedSamples, true, true);
+
+            int start1, size1, start2, size2;
+            fifo->prepareToWrite(numToDecode, start1, size1, start2, size2);
+
+            for (int channel = 0; channel < sourceChannels; ++channel)
+            {
+                jitterBuffer.copyFrom(channel, start1, decodeBuffer, channel, 0, size1);
+
+                if (size2 > 0)
+                    jitterBuffer.copyFrom(channel, start2, decodeBuffer, channel, size1, size2);
+            }
+
+            fifo->finishedWrite(size1 + size2);
+            decodedSamples += size1 + size2;
+
+            if (webStream->isError())
+            {
+                juce::Logger::writeToLog("StreamingAudioSource: the connection to " + url.toString(false) + " failed");
+                break;
+            }
+
+            // The reader's own buffer may still hold data after the web stream is exhausted
+            if (reader->input->isExhausted())
+                break;
+        }
+
+        totalLength = decodedSamples;
+        decodeFinished = true;
+        RT_LOG(info, "StreamingAudioSource finished decoding, seconds:", decodedSamples / sourceSampleRate);
+    }
+
+    reader.reset();
+
+    const juce::ScopedLock lock(streamLock);
+    webStream.reset();
+}
+
+bool StreamingAudioSource::isStreamCheck(const juce::StringArray& arguments)
+{
+    return arguments.size() >= 2 && arguments[0] == streamCheckOption;
+}
+
+// Function: runStreamCheck
+// Purpose: This thread plays the audio device: it waits for each block's deadline, then pulls
+//          the block, so the jitter buffer drains in real time while the server throttles and
+//          stalls. A stream that ended must have played exactly the file's samples.
+int StreamingAudioSource::runStreamCheck(const juce::StringArray& arguments)
+{
+    const juce::File file(arguments[1]);
+    const int kilobytesPerSecond = arguments.size() > 2 ? juce::jmax(1, arguments[2].getIntValue()) : 400;
+    const double stallEverySeconds = arguments.size() > 3 ? arguments[3].getDoubleValue() : 10.0;
+    const double stallSeconds = arguments.size() > 4 ? arguments[4].getDoubleValue() : 3.0;
+    const double checkSeconds = arguments.size() > 5 ? arguments[5].getDoubleValue() : 30.0;
+
+    juce::AudioFormatManager formatManager;
+    formatManager.registerBasicFormats();
+    std::unique_ptr<juce::AudioFormatReader> fileReader(formatManager.createReaderFor(file));
+
+    if (fileReader == nullptr)
+    {
+        std::cout << "Could not read an audio file from " << arguments[1] << "\n";
+        return 1;
+    }
+
+    ThrottledServer server(file, kilobytesPerSecond * 1000, stallEverySeconds, stallSeconds);
+
+    if (!server.start())
+    {
+        std::cout << "Could not listen on a loopback port\n";
+        return 1;
+    }
+
+    const juce::URL url("http://127.0.0.1:" + juce::String(server.getPort()) + "/"
+                        + juce::URL::addEscapeChars(file.getFileName(), false));
+
+    auto source = std::make_unique<StreamingAudioSource>(url, formatManager);
+    const double startTime = millisecondsNow();
+
+    if (!waitUntilConnected(*source, connectionTimeoutMs))
+    {
+        std::cout << "The stream didn't connect\n";
+        return 2;
+    }
+
+    const double sampleRate = source->getSampleRate();
+    const int blockSize = 512;
+    const double blockMilliseconds = blockSize * 1000.0 / sampleRate;
+    const auto numBlocks = (juce::int64) (checkSeconds * sampleRate / blockSize);
+    const double initialTarget = source->getTargetSeconds();
+    double largestTarget = initialTarget;
+    double playingAfter = -1.0;
+    int reportedUnderruns = 0;
+
+    source->prepareToPlay(blockSize, sampleRate);
+    juce::AudioBuffer<float> block(source->getNumChannels(), blockSize);
+
+    std::cout << "connected after " << millisecondsNow() - startTime << " ms\n"
+              << "time\tevent\tbuffered\ttarget\n";
+
+    double deadline = millisecondsNow();
+
+    for (juce::int64 index = 0; index < numBlocks && source->getState() != ended; ++index)
+    {
+        deadline += blockMilliseconds;
+
+        // Sleeps most of the way and yields the rest, so the stream's thread still gets to run
+        while (millisecondsNow() < deadline)
+        {
+            if (deadline - millisecondsNow() > 2.0)
+                juce::Thread::sleep(1);
+            else
+                juce::Thread::yield();
+        }
+
+        source->getNextAudioBlock(juce::AudioSourceChannelInfo(&block, 0, blockSize));
+
+        const double time = (millisecondsNow() - startTime) / 1000.0;
+
+        if (playingAfter < 0.0 && source->getState() == playing)
+        {
+            playingAfter = time;
+            std::cout << time << "\tplaying\t" << source->getBufferedSeconds() << "\t" << source->getTargetSeconds() << "\n";
+        }
+
+        if (source->getNumUnderruns() != reportedUnderruns)
+        {
+            reportedUnderruns = source->getNumUnderruns();
+            std::cout << time << "\tunderrun\t" << source->getBufferedSeconds() << "\t" << source->getTargetSeconds() << "\n";
+        }
+
+        largestTarget = juce::jmax(largestTarget, source->getTargetSeconds());
+    }
+
+    bool passed = true;
+    const auto played = source->getNextReadPosition();
+
+    std::cout << "underruns " << source->getNumUnderruns() << ", target grew from " << initialTarget
+              << " s to " << largestTarget << " s, " << source->getTargetSeconds() << " s at the end\n";
+
+    if (source->getState() == ended)
+    {
+        std::cout << "played " << played << " samples of the file's " << fileReader->lengthInSamples << "\n";
+        passed = played == fileReader->lengthInSamples;
+    }
+    else
+    {
+        std::cout << "played " << played << " samples in " << checkSeconds << " s without reaching the end\n";
+    }
+
+    source.reset();
+
+    // The next stream stalls for good once connected, so its thread is waiting on the network
+    server.hangNextConnection();
+    source = std::make_unique<StreamingAudioSource>(url, formatManager);
+
+    if (!waitUntilConnected(*source, connectionTimeoutMs))
+    {
+        std::cout << "The stalled stream didn't connect\n";
+        return 2;
+    }
+
+    juce::Thread::sleep(500);
+
+    const double cancelStart = millisecondsNow();
+    source.reset();
+    const double cancelMilliseconds = millisecondsNow() - cancelStart;
+
+    std::cout << "cancelling a stalled stream took " << cancelMilliseconds << " ms\n";
+    passed = passed && cancelMilliseconds < maximumCancelMilliseconds;
+    return passed ? 0 : 2;
+}
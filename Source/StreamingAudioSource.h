@@ -0,0 +1,137 @@
+/*
+  ==============================================================================
+    StreamingAudioSource.h
+    Created: 19 Oct 2026 8:02:37am
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <atomic>
+
+// Plays an HTTP stream without the message or audio thread ever waiting for the network.
+//
+// A worker thread connects, decodes and fills a jitter buffer; the audio thread only reads
+// from that buffer. Playback starts once the buffer holds the target amount. When it runs
+// low, the last few milliseconds are faded out and the source waits until the target is
+// buffered again, then fades back in where it stopped, so an underrun is a short gap
+// instead of a click or a skip. Each underrun doubles the target up to a limit; a long run
+// without one lowers it again, so a steady connection plays with little delay.
+//
+// A stream can't seek: the position only moves forward with playback.
+class StreamingAudioSource : public juce::PositionableAudioSource,
+                             private juce::Thread
+{
+public:
+    enum State
+    {
+        connecting = 0,
+        buffering,
+        playing,
+        ended,
+        failed
+    };
+
+    /**Starts connecting to the URL on the worker thread; returns at once*/
+    StreamingAudioSource(const juce::URL& url, juce::AudioFormatManager& formatManager);
+    ~StreamingAudioSource() override;
+
+    /**Returns the state; from any thread*/
+    State getState() const noexcept { return (State) state.load(); }
+    /**Returns whether the stream is decoding, so the sample rate and channels are known*/
+    bool isReady() const noexcept { return getState() != connecting && getState() != failed; }
+    /**Returns the stream's sample rate, once ready*/
+    double getSampleRate() const noexcept { return sourceSampleRate; }
+    /**Returns the stream's number of channels, once ready*/
+    int getNumChannels() const noexcept { return sourceChannels; }
+    /**Returns the seconds waiting in the jitter buffer*/
+    double getBufferedSeconds() const noexcept;
+    /**Returns the seconds the buffer is filled to before playback starts or resumes*/
+    double getTargetSeconds() const noexcept;
+    /**Returns the number of underruns so far*/
+    int getNumUnderruns() const noexcept { return underruns.load(); }
+
+    // AudioSource
+    void prepareToPlay(int samplesPerBlockExpected, double sampleRate) override;
+    void releaseResources() override;
+    // Function: getNextAudioBlock
+    // Purpose: Reads from the jitter buffer; silence while buffering. Audio thread, never blocks.
+    void getNextAudioBlock(const juce::AudioSourceChannelInfo& bufferToFill) override;
+
+    // PositionableAudioSource
+    /**Ignored unless it is the current position; a stream only plays forward*/
+    void setNextReadPosition(juce::int64 newPosition) override;
+    juce::int64 getNextReadPosition() const override { return playedSamples.load(); }
+    // Function: getTotalLength
+    // Purpose: The length the stream announced, what was played once it ended, or practically
+    //          endless for a live stream.
+    juce::int64 getTotalLength() const override;
+    bool isLooping() const override { return false; }
+
+    // Function: runStreamCheck
+    // Purpose: Serves a file from a local HTTP server at a throttled rate with regular stalls,
+    //          plays it in real time like the audio thread, then cancels a stream stuck on a
+    //          stalled connection. Prints underruns, the target's growth and how long the
+    //          cancel took to the standard output.
+    // Inputs:
+    // - const juce::StringArray& arguments: --stream-check, the file, and optionally the rate
+    //   in kilobytes per second, the seconds between stalls, the stall length in seconds and
+    //   the seconds to play.
+    // Outputs: 0 if the stream played to its end or for the whole check, with the file's
+    //          length when it ended, and the cancel took less than a second.
+    static int runStreamCheck(const juce::StringArray& arguments);
+    /**Returns whether the app was started to check streaming against a local server*/
+    static bool isStreamCheck(const juce::StringArray& arguments);
+
+private:
+    static constexpr double initialTargetSeconds = 1.0;
+    static constexpr double maximumTargetSeconds = 8.0;
+    // The buffer holds a little more than the largest target, so the worker can decode ahead
+    static constexpr double capacitySeconds = maximumTargetSeconds + 2.0;
+    // The target is lowered by a quarter after this long without an underrun
+    static constexpr double stableSecondsBeforeShrinking = 30.0;
+    static constexpr double fadeSeconds = 0.01;
+    static constexpr int decodeBlockSize = 4096;
+    static constexpr int connectionTimeoutMs = 10000;
+    // Header bytes kept so every format can probe the start of a stream that can't rewind
+    static constexpr int probeBufferBytes = 65536;
+
+    /**Connects, then decodes into the jitter buffer until the stream ends or the source is deleted*/
+    void run() override;
+    /**Opens the reader over the web stream; worker thread*/
+    bool connect();
+    /**Moves the target and counts the underrun; audio thread*/
+    void growTarget() noexcept;
+
+    juce::URL url;
+    juce::AudioFormatManager& formatManager;
+
+    // Worker thread only; the destructor cancels the web stream under streamLock, and the
+    // worker only creates or deletes it under that lock
+    std::unique_ptr<juce::WebInputStream> webStream;
+    std::unique_ptr<juce::AudioFormatReader> reader;
+    juce::CriticalSection streamLock;
+    juce::AudioBuffer<float> decodeBuffer;
+    juce::int64 decodedSamples = 0;
+
+    // Written by the worker before the state leaves connecting, read-only afterwards
+    double sourceSampleRate = 0.0;
+    int sourceChannels = 0;
+    juce::AudioBuffer<float> jitterBuffer;
+    std::unique_ptr<juce::AbstractFifo> fifo;
+
+    std::atomic<int> state{ connecting };
+    std::atomic<bool> decodeFinished{ false };
+    std::atomic<juce::int64> totalLength{ 0 };
+    std::atomic<juce::int64> playedSamples{ 0 };
+    std::atomic<int> targetSamples{ 0 };
+    std::atomic<int> underruns{ 0 };
+
+    // Audio thread only
+    float fadeGain = 0.0f;
+    int fadeSamples = 441;
+    juce::int64 samplesSinceUnderrun = 0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(StreamingAudioSource)
+};
@@ -0,0 +1,333 @@
+/*
+  ==============================================================================
+    ThreadPolicy.cpp
+    Created: 18 Oct 2026 11:58:17pm
+  ==============================================================================
+*/
+
+#include "ThreadPolicy.h"
+
+#if JUCE_LINUX
+ #include <cerrno>
+ #include <cstring>
+ #include <sched.h>
+ #include <sys/resource.h>
+ #include <sys/syscall.h>
+ #include <unistd.h>
+#endif
+
+namespace
+{
+    struct RoleSettings
+    {
+        const char* description;
+        int priority;      // SCHED_FIFO priority asked for directly, 0 for background
+        int rtkitPriority; // rtkit caps priorities, usually at 20
+        bool onAudioCpu;
+    };
+
+    const RoleSettings roleSettings[] = {
+        { "real-time audio", 80, 20, true },
+        { "real-time render worker", 70, 19, false },
+        { "background", 0, 0, false }
+    };
+
+    // The audio thread seen last, written by the audio thread and read by the timer
+    std::atomic<juce::pointer_sized_uint> audioThreadHandle{ 0 };
+    std::atomic<int> audioThreadId{ 0 };
+    std::atomic<bool> audioThreadPending{ false };
+
+    // One line per thread name, in the order threads were first handled
+    juce::CriticalSection& getReportLock()
+    {
+        static juce::CriticalSection lock;
+        return lock;
+    }
+
+    juce::StringPairArray& getReportLines()
+    {
+        static juce::StringPairArray lines;
+        return lines;
+    }
+
+    void addReportLine(const char* name, const juce::String& line)
+    {
+        const juce::ScopedLock lock(getReportLock());
+        getReportLines().set(name, line);
+    }
+
+   #if JUCE_LINUX
+    std::atomic<bool> rtkitUnavailable{ false };
+
+    int getCurrentThreadId() noexcept
+    {
+        return (int) syscall(SYS_gettid);
+    }
+
+    // Returns the CPUs the process may run on, split into the one for the audio thread (the
+    // highest) and the rest. With a single CPU both sets hold it.
+    void getCpuSets(cpu_set_t& audioCpus, cpu_set_t& otherCpus)
+    {
+        cpu_set_t allowed;
+        CPU_ZERO(&allowed);
+        CPU_ZERO(&audioCpus);
+
+        if (sched_getaffinity(0, sizeof(allowed), &allowed) != 0 || CPU_COUNT(&allowed) == 0)
+        {
+            for (int cpu = 0; cpu < juce::SystemStats::getNumCpus(); ++cpu)
+                CPU_SET(cpu, &allowed);
+        }
+
+        otherCpus = allowed;
+
+        for (int cpu = CPU_SETSIZE - 1; cpu >= 0; --cpu)
+        {
+            if (CPU_ISSET(cpu, &allowed))
+            {
+                CPU_SET(cpu, &audioCpus);
+
+                if (CPU_COUNT(&allowed) > 1)
+                    CPU_CLR(cpu, &otherCpus);
+
+                break;
+            }
+        }
+    }
+
+    // Function: askRtkit
+    // Purpose: Asks rtkit over D-Bus for SCHED_FIFO, through busctl so the app needs no D-Bus
+    //          library. rtkit only accepts processes with a limited RLIMIT_RTTIME.
+    bool askRtkit(int threadId, int priority)
+    {
+        if (rtkitUnavailable.load())
+            return false;
+
+        rlimit rtTime;
+        const rlim_t rtkitMaximum = 200000; // microseconds, rtkit's default RTTimeUSecMax
+
+        if (getrlimit(RLIMIT_RTTIME, &rtTime) == 0 && (rtTime.rlim_max == RLIM_INFINITY || rtTime.rlim_max > rtkitMaximum))
+        {
+            rtTime.rlim_cur = rtTime.rlim_max = rtkitMaximum;
+            setrlimit(RLIMIT_RTTIME, &rtTime);
+        }
+
+        juce::StringArray arguments{ "busctl", "--system", "call",
+                                     "org.freedesktop.RealtimeKit1", "/org/freedesktop/RealtimeKit1",
+                                     "org.freedesktop.RealtimeKit1", "MakeThreadRealtimeWithPID", "ttu" };
+        arguments.add(juce::String((int) getpid()));
+        arguments.add(juce::String(threadId));
+        arguments.add(juce::String(priority));
+
+        // A failure is remembered, so later workers don't wait for it again
+        juce::ChildProcess process;
+
+        if (process.start(arguments, 0) && process.waitForProcessToFinish(2000) && process.getExitCode() == 0)
+            return true;
+
+        rtkitUnavailable = true;
+        return false;
+    }
+
+    juce::String describeCpus(const cpu_set_t& cpus)
+    {
+        juce::StringArray list;
+
+        for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu)
+            if (CPU_ISSET(cpu, &cpus))
+                list.add(juce::String(cpu));
+
+        return list.joinIntoString(",");
+    }
+
+    // Reads back what the kernel actually set for a thread
+    juce::String describeThread(int threadId)
+    {
+        juce::String text;
+        const int policy = sched_getscheduler(threadId);
+        sched_param parameters{};
+        sched_getparam(threadId, &parameters);
+
+        if (policy == SCHED_FIFO)
+            text << "SCHED_FIFO " << parameters.sched_priority;
+        else if (policy == SCHED_RR)
+            text << "SCHED_RR " << parameters.sched_priority;
+        else if (policy == SCHED_IDLE)
+            text << "SCHED_IDLE";
+        else if (policy == SCHED_BATCH)
+            text << "SCHED_BATCH";
+        else
+            text << "SCHED_OTHER";
+
+        cpu_set_t cpus;
+        CPU_ZERO(&cpus);
+
+        if (sched_getaffinity(threadId, sizeof(cpus), &cpus) == 0)
+            text << " on CPU " << describeCpus(cpus);
+
+        return text;
+    }
+
+    // Function: applyRole
+    // Purpose: Sets the scheduling policy and affinity of a thread of this process.
+    // Outputs: How the request went, for the report.
+    juce::String applyRole(int threadId, ThreadPolicy::Role role)
+    {
+        const auto& settings = roleSettings[role];
+        juce::String outcome;
+
+        cpu_set_t audioCpus, otherCpus;
+        getCpuSets(audioCpus, otherCpus);
+        const auto& cpus = settings.onAudioCpu ? audioCpus : otherCpus;
+
+        if (sched_setaffinity(threadId, sizeof(cpus), &cpus) != 0)
+            outcome << "affinity refused: " << std::strerror(errno) << "; ";
+
+        if (settings.priority == 0)
+        {
+            sched_param parameters{};
+
+            if (sched_setscheduler(threadId, SCHED_IDLE, &parameters) != 0)
+                outcome << "SCHED_IDLE refused: " << std::strerror(errno);
+            else
+                outcome << "granted";
+
+            return outcome;
+        }
+
+        sched_param parameters{};
+        parameters.sched_priority = settings.priority;
+
+        if (sched_setscheduler(threadId, SCHED_FIFO, &parameters) == 0)
+            return outcome + "granted";
+
+        const int firstError = errno;
+
+        // The soft limit may be lower than what the administrator allows
+        rlimit rtPriority;
+
+        if (firstError == EPERM && getrlimit(RLIMIT_RTPRIO, &rtPriority) == 0 && rtPriority.rlim_max > 0)
+        {
+            rtPriority.rlim_cur = rtPriority.rlim_max;
+            setrlimit(RLIMIT_RTPRIO, &rtPriority);
+
+            // Keep the audio thread above the workers when the limit is below the asked priority
+            const int limit = (int) juce::jmin((rlim_t) 99, rtPriority.rlim_max);
+            parameters.sched_priority = juce::jmax(1, juce::jmin(settings.priority, limit - (settings.onAudioCpu ? 0 : 1)));
+
+            if (sched_setscheduler(threadId, SCHED_FIFO, &parameters) == 0)
+                return outcome + "granted within RLIMIT_RTPRIO " + juce::String((int) rtPriority.rlim_max);
+        }
+
+        const juce::String refusal(std::strerror(firstError));
+
+        if (askRtkit(threadId, settings.rtkitPriority))
+            return outcome + "granted through rtkit";
+
+        return outcome + "refused (" + refusal + "), and rtkit did not grant it either";
+    }
+   #endif
+
+    void applyAndReport(int threadId, ThreadPolicy::Role role, const char* name, const char* denormals)
+    {
+        juce::String line;
+        line << name << ": asked for " << roleSettings[role].description << ", " << denormals;
+
+       #if JUCE_LINUX
+        const auto outcome = applyRole(threadId, role);
+        line << ", " << outcome << ", running " << describeThread(threadId);
+       #else
+        juce::ignoreUnused(threadId);
+        line << ", left to JUCE on this platform";
+       #endif
+
+        addReportLine(name, line);
+    }
+}
+
+//==============================================================================
+// Constructor: Polls for a new audio thread a few times per second
+ThreadPolicy::ThreadPolicy()
+{
+    startTimer(500);
+}
+
+ThreadPolicy::~ThreadPolicy()
+{
+    stopTimer();
+}
+
+// Function: noteAudioThread
+// Purpose: The thread handle is compared on every callback; the thread id is only looked up
+//          when the device thread changes, after a restart of the device.
+void ThreadPolicy::noteAudioThread() noexcept
+{
+    const auto handle = (juce::pointer_sized_uint) juce::Thread::getCurrentThreadId();
+
+    if (audioThreadHandle.load(std::memory_order_relaxed) == handle)
+        return;
+
+   #if JUCE_LINUX
+    audioThreadId.store(getCurrentThreadId(), std::memory_order_relaxed);
+   #endif
+
+    audioThreadHandle.store(handle, std::memory_order_relaxed);
+    audioThreadPending.store(true, std::memory_order_release);
+}
+
+// Function: applyToCurrentThread
+// Purpose: Applies the role to the calling thread, flushes its denormals to zero and records
+//          the outcome.
+void ThreadPolicy::applyToCurrentThread(Role role, const char* name)
+{
+    flushDenormalsOnCurrentThread();
+    const char* denormals = juce::FloatVectorOperations::areDenormalsDisabled() ? "denormals flushed to zero"
+                                                                               : "denormals not flushed on this CPU";
+
+   #if JUCE_LINUX
+    applyAndReport(getCurrentThreadId(), role, name, denormals);
+   #else
+    applyAndReport(0, role, name, denormals);
+   #endif
+}
+
+// Function: flushDenormalsOnCurrentThread
+// Purpose: Sets flush-to-zero and denormals-are-zero in the thread's floating point control
+//          register, through JUCE so it works for SSE and for ARM's FZ bit.
+void ThreadPolicy::flushDenormalsOnCurrentThread() noexcept
+{
+    juce::FloatVectorOperations::disableDenormalisedNumberSupport(true);
+}
+
+// Function: applyToTimeSliceThread
+// Purpose: Queues a client that applies the role from inside the thread and then removes itself.
+void ThreadPolicy::applyToTimeSliceThread(juce::TimeSliceThread& thread, Role role, const char* name)
+{
+    thread.addTimeSliceClient(roleClients.add(new RoleClient(role, name)));
+}
+
+int ThreadPolicy::RoleClient::useTimeSlice()
+{
+    ThreadPolicy::applyToCurrentThread(role, name);
+    return -1;
+}
+
+// Function: getReport
+// Purpose: Joins the report lines of every thread handled so far.
+juce::String ThreadPolicy::getReport()
+{
+    const juce::ScopedLock lock(getReportLock());
+    return getReportLines().getAllValues().joinIntoString("\n");
+}
+
+// Function: timerCallback
+// Purpose: Sets up a new audio thread from the message thread, since asking rtkit blocks,
+//          then writes the report.
+void ThreadPolicy::timerCallback()
+{
+    if (!audioThreadPending.exchange(false, std::memory_order_acquire))
+        return;
+
+    applyAndReport(audioThreadId.load(std::memory_order_relaxed), audioRole, "Audio device thread",
+                   "denormals flushed to zero in every callback");
+    juce::Logger::writeToLog("Thread policy:\n" + getReport());
+}
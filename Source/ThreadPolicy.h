@@ -0,0 +1,89 @@
+/*
+  ==============================================================================
+    ThreadPolicy.h
+    Created: 18 Oct 2026 11:58:17pm
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <atomic>
+
+// Scheduling policy for the threads of the app. On Linux:
+//
+// - the audio device thread gets SCHED_FIFO and is pinned to the last CPU,
+// - render workers that feed the audio thread, like the convolution tail, get SCHED_FIFO one
+//   step below it and stay off the audio CPU,
+// - background work (thumbnails, decoding for analysis, logging, dumps) runs as SCHED_IDLE,
+//   also off the audio CPU.
+//
+// Every thread handled here also runs with denormals flushed to zero, so decaying filter and
+// reverb tails can't slow the DSP down. The audio device thread isn't the app's own, so the
+// audio callbacks set the flag themselves with juce::ScopedNoDenormals.
+//
+// Real-time priority is asked for directly first, raising RLIMIT_RTPRIO to its hard limit
+// if needed, and through rtkit if that is refused. Every thread's request and what it was
+// actually granted are read back and written to the log once the audio thread has been
+// handled. Other platforms keep JUCE's own priorities and only the report is written.
+//
+// One instance is owned by MainComponent. Worker threads apply their role themselves at the
+// start of run() through applyToCurrentThread.
+class ThreadPolicy : private juce::Timer
+{
+public:
+    enum Role
+    {
+        audioRole = 0,
+        renderWorkerRole,
+        backgroundRole
+    };
+
+    ThreadPolicy();
+    ~ThreadPolicy() override;
+
+    // Function: noteAudioThread
+    // Purpose: Called at the start of each audio callback. Compares the thread with the one
+    //          seen last time and, if it is new, leaves it for the message thread to set up.
+    //          Lock-free and without system calls in the common case.
+    static void noteAudioThread() noexcept;
+
+    // Function: applyToCurrentThread
+    // Purpose: Applies a role to the calling thread and records the result. May block for a
+    //          moment while asking rtkit, so call it at the start of a worker, never from audio.
+    // Inputs:
+    // - Role role: The role of the thread.
+    // - const char* name: Name used in the report.
+    static void applyToCurrentThread(Role role, const char* name);
+
+    /**Turns on flush-to-zero and denormals-are-zero for the calling thread*/
+    static void flushDenormalsOnCurrentThread() noexcept;
+
+    // Function: applyToTimeSliceThread
+    // Purpose: Applies a role to a running juce::TimeSliceThread the app does not own, like the
+    //          thumbnail cache thread, by running applyToCurrentThread on it once.
+    //          Message thread only; the thread must not outlive this object.
+    void applyToTimeSliceThread(juce::TimeSliceThread& thread, Role role, const char* name);
+
+    /**Returns the report of every thread handled so far, one line each*/
+    static juce::String getReport();
+
+private:
+    // Applies a role from inside a TimeSliceThread on its first time slice
+    class RoleClient : public juce::TimeSliceClient
+    {
+    public:
+        RoleClient(Role roleToApply, const char* threadName) : role(roleToApply), name(threadName) {}
+        int useTimeSlice() override;
+
+    private:
+        const Role role;
+        const char* const name;
+    };
+
+    void timerCallback() override;
+
+    juce::OwnedArray<RoleClient> roleClients;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ThreadPolicy)
+};
@@ -0,0 +1,150 @@
+/*
+  ==============================================================================
+    TimecodeControl.cpp
+    Created: 19 Oct 2026 4:12:37am
+  ==============================================================================
+*/
+
+#include "TimecodeControl.h"
+#include "AsyncLogger.h"
+
+TimecodeControl::TimecodeControl(DeckGUI& deckGUI1, DeckGUI& deckGUI2, DJAudioPlayer& player1, DJAudioPlayer& player2)
+    : deckGUIs{ &deckGUI1, &deckGUI2 },
+      players{ &player1, &player2 }
+{
+    startTimer(50);
+}
+
+TimecodeControl::~TimecodeControl()
+{
+    stopTimer();
+}
+
+void TimecodeControl::prepare(double sampleRate)
+{
+    currentSampleRate = sampleRate;
+
+    const juce::SpinLock::ScopedLockType lock(decoderLock);
+
+    if (activeDecoder != nullptr)
+        activeDecoder->prepare(sampleRate);
+    if (standbyDecoder != nullptr)
+        standbyDecoder->prepare(sampleRate);
+}
+
+// Function: setSource
+// Purpose: Builds the decoder here and hands it over like the convolution engines: the audio
+//          thread picks it up at its next chunk, and the decoder it replaces is destroyed on
+//          the next change. The speed slider of the deck goes back in use in timerCallback.
+void TimecodeControl::setSource(int deck, int format)
+{
+    jassert(deck >= -1 && deck < numDecks);
+
+    std::unique_ptr<TimecodeDecoder> decoder;
+
+    if (deck >= 0)
+    {
+        decoder = std::make_unique<TimecodeDecoder>(format);
+        decoder->prepare(currentSampleRate);
+        RT_LOG(info, "TimecodeControl controls a deck, deck and record length in seconds:",
+               deck + 1, decoder->getLengthInSeconds());
+    }
+
+    currentDecoder = decoder.get();
+    std::unique_ptr<TimecodeDecoder> retiredDecoder;
+
+    {
+        const juce::SpinLock::ScopedLockType lock(decoderLock);
+        retiredDecoder = std::move(standbyDecoder);
+        standbyDecoder = std::move(decoder);
+        standbyDeck = deck;
+        decoderChangePending = true;
+    }
+
+    controlledDeck = deck;
+
+    if (deck >= 0)
+        deckGUIs[deck]->speedSlider.setEnabled(false);
+}
+
+void TimecodeControl::swapPendingDecoder() noexcept
+{
+    const juce::SpinLock::ScopedTryLockType lock(decoderLock);
+
+    if (lock.isLocked())
+    {
+        std::swap(activeDecoder, standbyDecoder);
+        std::swap(activeDeck, standbyDeck);
+        decoderChangePending = false;
+    }
+}
+
+// Function: processInput
+// Purpose: A deck that turns backwards is held rather than played in reverse; the transports
+//          only read forwards. Without input channels there's no signal, so the deck is held.
+void TimecodeControl::processInput(const juce::AudioBuffer<float>& input, int startSample, int numSamples,
+                                   AutoDJ::DeckPlan (&plans)[numDecks]) noexcept
+{
+    if (decoderChangePending.load())
+        swapPendingDecoder();
+
+    if (activeDecoder == nullptr || activeDeck < 0)
+        return;
+
+    if (input.getNumChannels() >= 2)
+        activeDecoder->process(input.getReadPointer(0, startSample), input.getReadPointer(1, startSample), numSamples);
+
+    const double speed = activeDecoder->getSpeed();
+
+    if (input.getNumChannels() < 2 || speed < minimumSpeed)
+    {
+        plans[activeDeck].render = false;
+        return;
+    }
+
+    players[activeDeck]->setPlaybackRatio(speed);
+}
+
+// Function: timerCallback
+// Purpose: Starts the controlled deck when the record turns, moves it when the needle was put
+//          down elsewhere, and gives the other decks their speed sliders back.
+void TimecodeControl::timerCallback()
+{
+    const int deck = controlledDeck.load();
+
+    // Wait until the audio thread has stopped setting the speed of a deck it let go
+    if (!decoderChangePending.load())
+    {
+        for (int other = 0; other < numDecks; ++other)
+        {
+            auto& slider = deckGUIs[other]->speedSlider;
+
+            if (other != deck && !slider.isEnabled())
+            {
+                slider.setEnabled(true);
+                players[other]->setSpeed(slider.getValue());
+            }
+        }
+    }
+
+    if (deck < 0 || currentDecoder == nullptr)
+        return;
+
+    auto& player = *players[deck];
+    const double length = player.getLengthInSeconds();
+
+    if (length <= 0.0 || !currentDecoder->hasSignal())
+        return;
+
+    if (!player.isPlaying())
+        player.play();
+
+    if (!currentDecoder->isLocked())
+        return;
+
+    const double recordPosition = currentDecoder->getPosition();
+    const double deckPosition = player.getPositionRelative() * length;
+
+    if (std::abs(recordPosition - deckPosition) > needleDropSeconds && recordPosition < length)
+        player.setPositionRelative(recordPosition / length);
+}
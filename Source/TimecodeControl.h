@@ -0,0 +1,85 @@
+/*
+  ==============================================================================
+    TimecodeControl.h
+    Created: 19 Oct 2026 4:12:37am
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <atomic>
+#include <memory>
+#include "TimecodeDecoder.h"
+#include "DJAudioPlayer.h"
+#include "DeckGUI.h"
+#include "AutoDJ.h"
+
+// Lets a timecode record on a turntable play one deck, from the input channels the app already
+// opens.
+//
+// The audio thread decodes each chunk of the input just before the decks render over it, and
+// sets the controlled deck's speed straight away, so the platter is followed with one chunk of
+// latency. A stopped or backwards turning platter holds the deck silent. Needle drops move the
+// deck from the message thread: when the absolute position of the record and the deck's
+// position drift apart by more than a moment, the deck is moved to the record's position.
+class TimecodeControl : private juce::Timer
+{
+public:
+    static constexpr int numDecks = 2;
+
+    TimecodeControl(DeckGUI& deckGUI1, DeckGUI& deckGUI2, DJAudioPlayer& player1, DJAudioPlayer& player2);
+    ~TimecodeControl() override;
+
+    /**Sets the input sample rate; the audio callback isn't running while the device is prepared*/
+    void prepare(double sampleRate);
+
+    // Function: setSource
+    // Purpose: Puts a deck under control of a timecode format, or gives the deck back to its
+    //          speed slider. Building a decoder takes a moment, so this is done here on the
+    //          message thread and the decoder is handed to the audio thread when ready.
+    // Inputs:
+    // - int deck: 0 or 1, or -1 to turn timecode control off.
+    // - int format: A TimecodeDecoder::Format.
+    void setSource(int deck, int format);
+    /**Returns the controlled deck, or -1*/
+    int getControlledDeck() const noexcept { return controlledDeck.load(); }
+
+    // Function: processInput
+    // Purpose: Decodes a chunk of the input and sets the controlled deck's speed, or stops it
+    //          from rendering. Call before the decks overwrite the input. Audio thread only.
+    // Inputs:
+    // - const juce::AudioBuffer<float>& input: The device buffer, input in its first two channels.
+    // - int startSample, int numSamples: The chunk.
+    // - AutoDJ::DeckPlan (&plans)[numDecks]: The plans of the chunk; a held deck isn't rendered.
+    void processInput(const juce::AudioBuffer<float>& input, int startSample, int numSamples,
+                      AutoDJ::DeckPlan (&plans)[numDecks]) noexcept;
+
+private:
+    // Slower than this the deck is held, so a resting platter doesn't crawl
+    static constexpr double minimumSpeed = 0.1;
+    // Record and deck may drift this far apart before the deck is moved
+    static constexpr double needleDropSeconds = 0.5;
+
+    /**Starts the deck when the record turns, and follows needle drops*/
+    void timerCallback() override;
+    void swapPendingDecoder() noexcept;
+
+    DeckGUI* deckGUIs[numDecks];
+    DJAudioPlayer* players[numDecks];
+    double currentSampleRate = 44100.0;
+
+    // The audio thread owns activeDecoder. standbyDecoder holds either a decoder waiting to be
+    // picked up or the one it replaced, which is destroyed on the message thread.
+    juce::SpinLock decoderLock;
+    std::unique_ptr<TimecodeDecoder> activeDecoder;
+    std::unique_ptr<TimecodeDecoder> standbyDecoder;
+    int activeDeck = -1;
+    int standbyDeck = -1;
+    std::atomic<bool> decoderChangePending{ false };
+    std::atomic<int> controlledDeck{ -1 };
+    // Only read by the message thread, while a decoder is in use
+    TimecodeDecoder* currentDecoder = nullptr;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(TimecodeControl)
+};
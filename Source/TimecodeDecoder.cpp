@@ -0,0 +1,341 @@
+/*
+  ==============================================================================
+    TimecodeDecoder.cpp
+    Created: 19 Oct 2026 3:51:20am
+  ==============================================================================
+*/
+
+#include "TimecodeDecoder.h"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+namespace
+{
+    const char* const offlineCheckOption = "--decode-timecode";
+
+    const TimecodeDecoder::Definition definitions[] = {
+        { "serato_2a", "Serato 2nd Ed., side A", 1000, 20, 0x59017, 0x361e4, 712000, false, false, false },
+        { "serato_2b", "Serato 2nd Ed., side B", 1000, 20, 0x8f3c6, 0x4f0d8, 922000, false, false, false },
+        { "traktor_a", "Traktor Scratch, side A", 2000, 23, 0x134503, 0x041040, 1500000, true, true, true },
+        { "traktor_b", "Traktor Scratch, side B", 2000, 23, 0x32066c, 0x041040, 2110000, true, true, true }
+    };
+
+    // Parity of the tapped bits, the bit the register feeds back
+    juce::uint32 feedback(juce::uint32 code, juce::uint32 taps) noexcept
+    {
+        juce::uint32 tapped = code & taps;
+        juce::uint32 parity = 0;
+
+        while (tapped != 0)
+        {
+            parity ^= tapped & 1;
+            tapped >>= 1;
+        }
+
+        return parity;
+    }
+}
+
+const TimecodeDecoder::Definition& TimecodeDecoder::getDefinition(int format)
+{
+    jassert(format >= 0 && format < numFormats);
+    return definitions[format];
+}
+
+int TimecodeDecoder::findFormat(const juce::String& name)
+{
+    for (int format = 0; format < numFormats; ++format)
+        if (name == definitions[format].name)
+            return format;
+
+    return -1;
+}
+
+// Constructor: Runs the register through the whole record once, noting where each code is
+TimecodeDecoder::TimecodeDecoder(int format)
+    : definition(getDefinition(format))
+{
+    table.reserve((size_t) definition.length);
+
+    juce::uint32 code = definition.seed;
+
+    for (int cycle = 0; cycle < definition.length; ++cycle)
+    {
+        table.push_back({ code, cycle });
+        code = forward(code);
+    }
+
+    std::sort(table.begin(), table.end());
+    prepare(44100.0);
+}
+
+// Function: prepare
+// Purpose: Sets the time step of the filters for the rate and clears the decoding state.
+void TimecodeDecoder::prepare(double sampleRate)
+{
+    samplePeriod = 1.0 / sampleRate;
+    zeroAlpha = (float) (samplePeriod / (zeroTimeConstant + samplePeriod));
+    reset();
+}
+
+void TimecodeDecoder::reset()
+{
+    primary = Channel();
+    secondary = Channel();
+    forwards = true;
+    bitstream = 0;
+    expectedCode = 0;
+    validBits = 0;
+    referenceLevel = 1.0f;
+    pitchPosition = 0.0;
+    pitchVelocity = 0.0;
+    lastBitPosition = -1;
+    samplesSinceBit = 0;
+    samplesSinceCrossing = 0;
+
+    signalPresent = false;
+    locked = false;
+    speed = 0.0;
+    position = 0.0;
+}
+
+// Function: process
+// Purpose: Tracks both channels' crossings sample by sample. Each crossing updates the
+//          direction and moves the platter a quarter cycle; a crossing of the secondary channel
+//          while the primary is at its peak reads a bit.
+void TimecodeDecoder::process(const float* left, const float* right, int numSamples) noexcept
+{
+    const float* primarySamples = definition.switchPrimary ? left : right;
+    const float* secondarySamples = definition.switchPrimary ? right : left;
+    const double quarterCycle = 1.0 / definition.resolution / 4.0;
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        const float primaryValue = primarySamples[i];
+        const float secondaryValue = secondarySamples[i];
+
+        detectZeroCrossing(primary, primaryValue);
+        detectZeroCrossing(secondary, secondaryValue);
+
+        double movement = 0.0;
+
+        if (primary.swapped || secondary.swapped)
+        {
+            bool isForwards = primary.swapped ? (primary.positive != secondary.positive)
+                                              : (primary.positive == secondary.positive);
+
+            if (definition.switchPhase)
+                isForwards = !isForwards;
+
+            if (isForwards != forwards)
+            {
+                forwards = isForwards;
+                validBits = 0;
+            }
+
+            movement = forwards ? quarterCycle : -quarterCycle;
+            samplesSinceCrossing = 0;
+        }
+        else
+        {
+            ++samplesSinceCrossing;
+        }
+
+        // Alpha-beta filter of the platter position; the position is kept relative to the
+        // last observation, so only the velocity matters
+        const double predicted = pitchPosition + pitchVelocity * samplePeriod;
+        const double residual = movement - predicted;
+        pitchPosition = predicted + residual * pitchAlpha;
+        pitchVelocity += residual * pitchBeta / samplePeriod;
+        pitchPosition -= movement;
+
+        if (secondary.swapped && primary.positive == !definition.switchPolarity)
+            processBit(std::abs(primaryValue - primary.zero) * 0.5f);
+
+        ++samplesSinceBit;
+    }
+
+    const bool hasCarrier = samplesSinceCrossing * samplePeriod < signalTimeoutSeconds;
+    const double platterSpeed = hasCarrier ? pitchVelocity : 0.0;
+
+    signalPresent.store(hasCarrier, std::memory_order_relaxed);
+    speed.store(platterSpeed, std::memory_order_relaxed);
+
+    const bool isLocked = hasCarrier && lastBitPosition >= 0 && validBits > validBitsNeeded;
+    locked.store(isLocked, std::memory_order_relaxed);
+
+    if (isLocked)
+        position.store((double) lastBitPosition / definition.resolution + samplesSinceBit * samplePeriod * platterSpeed,
+                       std::memory_order_relaxed);
+}
+
+void TimecodeDecoder::detectZeroCrossing(Channel& channel, float value) noexcept
+{
+    channel.swapped = false;
+
+    if (value > channel.zero + zeroThreshold && !channel.positive)
+    {
+        channel.swapped = true;
+        channel.positive = true;
+    }
+    else if (value < channel.zero - zeroThreshold && channel.positive)
+    {
+        channel.swapped = true;
+        channel.positive = false;
+    }
+
+    // The zero follows any DC offset of the input slowly
+    channel.zero += zeroAlpha * (value - channel.zero);
+}
+
+// Function: processBit
+// Purpose: Reads a one if the peak is above the running reference level and shifts it into
+//          the bitstream from the end the platter is moving towards. The bitstream counts as
+//          valid while it keeps matching the code the register predicts.
+void TimecodeDecoder::processBit(float magnitude) noexcept
+{
+    const juce::uint32 bit = magnitude > referenceLevel ? 1u : 0u;
+    const juce::uint32 mask = (1u << definition.bits) - 1u;
+
+    if (forwards)
+    {
+        expectedCode = forward(expectedCode);
+        bitstream = (bitstream >> 1) | (bit << (definition.bits - 1));
+    }
+    else
+    {
+        expectedCode = reverse(expectedCode);
+        bitstream = ((bitstream << 1) & mask) | bit;
+    }
+
+    if (expectedCode == bitstream)
+    {
+        ++validBits;
+    }
+    else
+    {
+        expectedCode = bitstream;
+        validBits = 0;
+    }
+
+    if (validBits > validBitsNeeded)
+    {
+        // Backwards, the newest bit is the oldest of the code read, which starts bits - 1 cycles later
+        const int codePosition = lookUp(bitstream);
+        lastBitPosition = codePosition < 0 || forwards ? codePosition : codePosition - (definition.bits - 1);
+        samplesSinceBit = 0;
+    }
+
+    referenceLevel += (magnitude - referenceLevel) / referencePeaks;
+}
+
+// New bits enter at the most significant end when the record plays forwards
+juce::uint32 TimecodeDecoder::forward(juce::uint32 code) const noexcept
+{
+    const juce::uint32 bit = feedback(code, definition.taps | 1u);
+    return (code >> 1) | (bit << (definition.bits - 1));
+}
+
+// and at the least significant end when it plays backwards
+juce::uint32 TimecodeDecoder::reverse(juce::uint32 code) const noexcept
+{
+    const juce::uint32 mask = (1u << definition.bits) - 1u;
+    const juce::uint32 bit = feedback(code, (definition.taps >> 1) | (1u << (definition.bits - 1)));
+    return ((code << 1) & mask) | bit;
+}
+
+int TimecodeDecoder::lookUp(juce::uint32 code) const noexcept
+{
+    const auto found = std::lower_bound(table.begin(), table.end(), Entry{ code, 0 });
+
+    if (found == table.end() || found->code != code)
+        return -1;
+
+    return found->position;
+}
+
+bool TimecodeDecoder::isOfflineCheck(const juce::StringArray& arguments)
+{
+    return arguments.size() >= 3 && arguments[0] == offlineCheckOption;
+}
+
+// Function: runOfflineCheck
+// Purpose: Feeds the file through the decoder in device-sized blocks. With a ground truth the
+//          error is only measured while locked, and the time to the first lock is reported.
+int TimecodeDecoder::runOfflineCheck(const juce::StringArray& arguments)
+{
+    const int format = findFormat(arguments[2]);
+
+    if (format < 0)
+    {
+        std::cout << "Unknown timecode format " << arguments[2] << "\n";
+        return 1;
+    }
+
+    juce::AudioFormatManager formatManager;
+    formatManager.registerBasicFormats();
+    std::unique_ptr<juce::AudioFormatReader> reader(formatManager.createReaderFor(juce::File(arguments[1])));
+
+    if (reader == nullptr || reader->numChannels < 2)
+    {
+        std::cout << "Could not read a stereo file from " << arguments[1] << "\n";
+        return 1;
+    }
+
+    const bool hasGroundTruth = arguments.size() >= 5;
+    const double startPosition = arguments[3].getDoubleValue();
+    const double expectedSpeed = arguments[4].getDoubleValue();
+
+    TimecodeDecoder decoder(format);
+    decoder.prepare(reader->sampleRate);
+
+    const int blockSize = 64;
+    const int reportInterval = juce::roundToInt(reader->sampleRate * 0.01);
+    juce::AudioBuffer<float> block(2, blockSize);
+
+    double maxError = 0.0, errorSum = 0.0, firstLock = -1.0;
+    int lockedReports = 0;
+
+    std::cout << "time\tspeed\tlocked\tposition\texpected\n";
+
+    for (juce::int64 start = 0; start + blockSize <= reader->lengthInSamples; start += blockSize)
+    {
+        reader->read(&block, 0, blockSize, start, true, true);
+        decoder.process(block.getReadPointer(0), block.getReadPointer(1), blockSize);
+
+        const double time = (double) (start + blockSize) / reader->sampleRate;
+        const double expected = startPosition + time * expectedSpeed;
+
+        if ((start + blockSize) % reportInterval >= blockSize)
+            continue;
+
+        std::cout << time << "\t" << decoder.getSpeed() << "\t" << (decoder.isLocked() ? 1 : 0) << "\t"
+                  << decoder.getPosition() << "\t" << (hasGroundTruth ? expected : 0.0) << "\n";
+
+        if (decoder.isLocked())
+        {
+            if (firstLock < 0.0)
+                firstLock = time;
+
+            const double error = std::abs(decoder.getPosition() - expected);
+            maxError = juce::jmax(maxError, error);
+            errorSum += error;
+            ++lockedReports;
+        }
+    }
+
+    std::cout << "first lock after " << firstLock << " s\n";
+
+    if (!hasGroundTruth)
+        return 0;
+
+    if (lockedReports == 0)
+    {
+        std::cout << "never locked\n";
+        return 2;
+    }
+
+    std::cout << "position error mean " << 1000.0 * errorSum / lockedReports << " ms, max " << 1000.0 * maxError << " ms\n";
+    return maxError < 0.005 ? 0 : 2;
+}
@@ -0,0 +1,151 @@
+/*
+  ==============================================================================
+    TimecodeDecoder.h
+    Created: 19 Oct 2026 3:51:20am
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <atomic>
+#include <vector>
+
+// Decodes a timecode vinyl or CD signal into platter speed, direction and absolute position.
+//
+// Timecode is a stereo sine carrier with the channels a quarter cycle apart. The order in which
+// the two channels cross zero gives the direction, and every crossing moves the platter a
+// quarter cycle, which an alpha-beta filter turns into a speed. Once per cycle the carrier's
+// amplitude carries one bit of a linear feedback shift register sequence. After enough bits
+// in a row follow the sequence, the last bits are looked up to get the absolute position. The
+// format definitions and the decoding follow the ones published with xwax.
+class TimecodeDecoder
+{
+public:
+    enum Format
+    {
+        seratoSideA = 0,
+        seratoSideB,
+        traktorSideA,
+        traktorSideB,
+        numFormats
+    };
+
+    struct Definition
+    {
+        const char* name;
+        const char* description;
+        int resolution;        // carrier cycles per second at normal speed
+        int bits;              // length of the shift register
+        juce::uint32 seed;     // the code at the start of the record
+        juce::uint32 taps;
+        int length;            // cycles on the record
+        bool switchPrimary;    // the left channel leads instead of the right
+        bool switchPolarity;   // bits are read on negative half cycles
+        bool switchPhase;      // forwards is the other channel order
+    };
+
+    /**Returns the definition of a format*/
+    static const Definition& getDefinition(int format);
+    /**Returns the format with this name, such as "serato_2a", or -1*/
+    static int findFormat(const juce::String& name);
+
+    // Function: TimecodeDecoder
+    // Purpose: Builds the table from codes to positions for the format, which holds one entry
+    //          per cycle on the record. Not for the audio thread.
+    explicit TimecodeDecoder(int format);
+
+    /**Sets the input rate and starts decoding afresh*/
+    void prepare(double sampleRate);
+    /**Forgets the signal, for instance after the input was interrupted*/
+    void reset();
+
+    // Function: process
+    // Purpose: Decodes a block of the timecode input. Audio thread only, allocation-free.
+    // Inputs:
+    // - const float* left, const float* right: The two channels of the timecode signal.
+    // - int numSamples: The number of samples in each channel.
+    void process(const float* left, const float* right, int numSamples) noexcept;
+
+    /**Returns whether a carrier was seen recently*/
+    bool hasSignal() const noexcept { return signalPresent.load(std::memory_order_relaxed); }
+    /**Returns the platter speed relative to normal, negative when it turns backwards*/
+    double getSpeed() const noexcept { return speed.load(std::memory_order_relaxed); }
+    /**Returns whether the bits read follow the sequence, so getPosition is valid*/
+    bool isLocked() const noexcept { return locked.load(std::memory_order_relaxed); }
+    /**Returns the position at the end of the last block in seconds of record, when locked*/
+    double getPosition() const noexcept { return position.load(std::memory_order_relaxed); }
+    /**Returns the length of the record in seconds*/
+    double getLengthInSeconds() const noexcept { return (double) definition.length / definition.resolution; }
+
+    // Function: runOfflineCheck
+    // Purpose: Decodes a recorded timecode file and compares the positions with a known start
+    //          and speed. Prints one line per 10 ms and a summary to the standard output.
+    // Inputs:
+    // - const juce::StringArray& arguments: --decode-timecode, the file, the format name, and
+    //   optionally the position in seconds at the start of the file and the speed.
+    // Outputs: 0 if the file was decoded, and within 5 ms of the ground truth when one is given.
+    static int runOfflineCheck(const juce::StringArray& arguments);
+    /**Returns whether the app was started to check a timecode file*/
+    static bool isOfflineCheck(const juce::StringArray& arguments);
+
+private:
+    // Bits that must follow the sequence before a position is trusted
+    static constexpr int validBitsNeeded = 24;
+    // Peaks averaged into the reference level that tells ones from zeros
+    static constexpr float referencePeaks = 48.0f;
+    // Crossings need the signal this far from the tracked zero, a 128 on a 16 bit scale
+    static constexpr float zeroThreshold = 128.0f / 32768.0f;
+    static constexpr double zeroTimeConstant = 0.001;
+    // Without a crossing for this long there is no signal
+    static constexpr double signalTimeoutSeconds = 0.05;
+    // Alpha-beta filter gains of the platter motion
+    static constexpr double pitchAlpha = 1.0 / 512.0;
+    static constexpr double pitchBeta = pitchAlpha / 256.0;
+
+    struct Channel
+    {
+        float zero = 0.0f;
+        bool positive = false;
+        bool swapped = false;
+    };
+
+    struct Entry
+    {
+        juce::uint32 code;
+        int position;
+        bool operator<(const Entry& other) const noexcept { return code < other.code; }
+    };
+
+    void detectZeroCrossing(Channel& channel, float value) noexcept;
+    void processBit(float magnitude) noexcept;
+    juce::uint32 forward(juce::uint32 code) const noexcept;
+    juce::uint32 reverse(juce::uint32 code) const noexcept;
+    int lookUp(juce::uint32 code) const noexcept;
+
+    const Definition& definition;
+    std::vector<Entry> table;
+
+    // Audio thread state
+    double samplePeriod = 1.0 / 44100.0;
+    float zeroAlpha = 0.0f;
+    Channel primary, secondary;
+    bool forwards = true;
+    juce::uint32 bitstream = 0;
+    juce::uint32 expectedCode = 0;
+    int validBits = 0;
+    float referenceLevel = 1.0f;
+    double pitchPosition = 0.0;
+    double pitchVelocity = 0.0;
+    int lastBitPosition = -1;
+    juce::int64 samplesSinceBit = 0;
+    juce::int64 samplesSinceCrossing = 0;
+
+    // Published for other threads at the end of every block
+    std::atomic<bool> signalPresent{ false };
+    std::atomic<bool> locked{ false };
+    std::atomic<double> speed{ 0.0 };
+    std::atomic<double> position{ 0.0 };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(TimecodeDecoder)
+};
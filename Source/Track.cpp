@@ -20,10 +20,19 @@ Track::Track(juce::File _file)
     title(file.getFileNameWithoutExtension()), // Initializing title with the filename without its extension
     URL(juce::URL{ file }) // Initializing URL with a juce::URL object created from the file
 {
+    updateStamp();
     // Logging the creation of a new track with its title
     DBG("Created new track with title: " << title);
 }
 
+// Called when the track is imported or loaded, and again when an analyzer has finished its file,
+// which may have changed on disk since.
+void Track::updateStamp()
+{
+    size = file.getSize();
+    modified = file.getLastModificationTime().toMilliseconds();
+}
+
 // Overloading the equality operator to compare a Track object with a juce::String object (presumably a title).
 // It returns true if the title member of the Track object is equal to the input juce::String object.
 bool Track::operator==(const juce::String& other) const
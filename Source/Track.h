@@ -19,6 +19,12 @@ class Track
         juce::URL URL;
         juce::String title;
         juce::String length;
+        // The file's size and modification time, read once so the playlist can check the
+        // analyzers' results against them without going to the disk on every repaint
+        juce::int64 size = 0;
+        juce::int64 modified = 0;
+        /**Reads the file's size and modification time again*/
+        void updateStamp();
         /**objects are compared by title*/
         bool operator==(const juce::String& other) const;
 };
\ No newline at end of file
@@ -0,0 +1,167 @@
+/*
+  ==============================================================================
+    TrackAnalysisPool.cpp
+    Created: 19 Oct 2026 11:02:37am
+  ==============================================================================
+*/
+
+#include "TrackAnalysisPool.h"
+#include "ThreadPolicy.h"
+#include <algorithm>
+
+//==============================================================================
+// Analyzes queued files until every queue is empty. A job is added for each file queued, and
+// each takes whichever file is at the front when it starts, so urgent files overtake the rest.
+class TrackAnalysisPool::AnalysisJob : public juce::ThreadPoolJob
+{
+public:
+    explicit AnalysisJob(TrackAnalysisPool& ownerToUse)
+        : juce::ThreadPoolJob("Track analysis"), owner(ownerToUse) {}
+
+    JobStatus runJob() override
+    {
+        ThreadPolicy::applyToCurrentThread(ThreadPolicy::backgroundRole, "Track analysis");
+
+        juce::File file;
+        std::vector<Analysis*> claimed;
+
+        if (!owner.takeNextFile(file, claimed))
+            return jobHasFinished;
+
+        juce::AudioFormatManager formatManager;
+        formatManager.registerBasicFormats();
+        std::unique_ptr<juce::AudioFormatReader> reader(formatManager.createReaderFor(file));
+
+        std::vector<std::unique_ptr<Measurement>> measurements;
+        std::vector<Measurement*> fed;
+
+        for (auto* analysis : claimed)
+        {
+            if (reader == nullptr)
+            {
+                analysis->skipFile(file);
+                continue;
+            }
+
+            if (auto measurement = analysis->startMeasurement(file, *reader))
+            {
+                fed.push_back(measurement.get());
+                measurements.push_back(std::move(measurement));
+            }
+        }
+
+        const bool complete = !fed.empty() && decode(*reader, fed, [this] { return shouldExit(); });
+
+        for (auto* measurement : fed)
+            measurement->finish(complete);
+
+        return shouldExit() ? jobHasFinished : jobNeedsRunningAgain;
+    }
+
+private:
+    TrackAnalysisPool& owner;
+};
+
+//==============================================================================
+TrackAnalysisPool::TrackAnalysisPool()
+    : pool(juce::jmax(1, juce::SystemStats::getNumCpus() - 1))
+{
+}
+
+TrackAnalysisPool::~TrackAnalysisPool()
+{
+    jassert(analyses.empty());
+    pool.removeAllJobs(true, 10000);
+}
+
+void TrackAnalysisPool::addAnalysis(Analysis& analysis)
+{
+    const juce::ScopedLock scopedLock(lock);
+    analyses.push_back(&analysis);
+}
+
+// Stopping the jobs also stops the files other analyses were measuring; those are forgotten by
+// their analyses like unreadable ones, and the jobs restarted for whatever is still queued.
+void TrackAnalysisPool::removeAnalysis(Analysis& analysis)
+{
+    bool othersRemain = false;
+
+    {
+        const juce::ScopedLock scopedLock(lock);
+        analyses.erase(std::remove(analyses.begin(), analyses.end(), &analysis), analyses.end());
+        othersRemain = !analyses.empty();
+    }
+
+    pool.removeAllJobs(true, 10000);
+
+    for (int i = 0; othersRemain && i < pool.getNumThreads(); ++i)
+        pool.addJob(new AnalysisJob(*this), true);
+}
+
+void TrackAnalysisPool::fileQueued()
+{
+    pool.addJob(new AnalysisJob(*this), true);
+}
+
+// The same buffer and reads serve every measurement; at most eight channels are decoded
+bool TrackAnalysisPool::decode(juce::AudioFormatReader& reader, const std::vector<Measurement*>& measurements,
+                               const std::function<bool()>& shouldExit)
+{
+    const int numChannels = juce::jmin((int) reader.numChannels, maximumChannels);
+
+    if (numChannels <= 0)
+        return false;
+
+    juce::AudioBuffer<float> buffer(numChannels, readLength);
+
+    for (juce::int64 position = 0; position < reader.lengthInSamples; position += readLength)
+    {
+        if (shouldExit())
+            return false;
+
+        const int numSamples = (int) juce::jmin((juce::int64) readLength, reader.lengthInSamples - position);
+
+        if (!reader.read(&buffer, 0, numSamples, position, true, true))
+            return false;
+
+        for (auto* measurement : measurements)
+            measurement->addBlock(buffer, numSamples);
+    }
+
+    return true;
+}
+
+// Function: takeNextFile
+// Purpose: Looks for an urgently queued file in every queue before taking the front of any,
+//          then takes the same file from every other queue that has it.
+bool TrackAnalysisPool::takeNextFile(juce::File& file, std::vector<Analysis*>& claimed)
+{
+    const juce::ScopedLock scopedLock(lock);
+    Analysis* first = nullptr;
+
+    for (auto urgentOnly : { true, false })
+    {
+        for (auto* analysis : analyses)
+        {
+            if (analysis->takeNextFile(file, urgentOnly))
+            {
+                first = analysis;
+                break;
+            }
+        }
+
+        if (first != nullptr)
+            break;
+    }
+
+    if (first == nullptr)
+        return false;
+
+    claimed.push_back(first);
+
+    for (auto* analysis : analyses)
+        if (analysis != first && analysis->takeFile(file))
+            claimed.push_back(analysis);
+
+    return true;
+}
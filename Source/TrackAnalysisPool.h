@@ -0,0 +1,89 @@
+/*
+  ==============================================================================
+    TrackAnalysisPool.h
+    Created: 19 Oct 2026 11:02:37am
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <functional>
+#include <memory>
+#include <vector>
+
+// Runs the library analyzers on one pool of background threads. Each analysis keeps its own
+// queue; a job takes the next file of any queue, urgent files first, along with the same file
+// from every other queue, and decodes it once while feeding every analysis that wanted it.
+// Importing a library so costs one decode per track rather than one per analyzer, and the
+// analyzers together never take more than the pool's threads.
+class TrackAnalysisPool
+{
+public:
+    // The measurement of one file by one analysis, fed the file's audio in order
+    class Measurement
+    {
+    public:
+        virtual ~Measurement() = default;
+
+        /**Takes the next numSamples samples of every channel*/
+        virtual void addBlock(const juce::AudioBuffer<float>& buffer, int numSamples) = 0;
+        /**Called once after the last block, with complete false if decoding failed or was stopped*/
+        virtual void finish(bool complete) = 0;
+    };
+
+    // An analyzer with a queue of files; every call comes from the pool's threads
+    class Analysis
+    {
+    public:
+        virtual ~Analysis() = default;
+
+        // Function: takeNextFile
+        // Purpose: Takes the file at the front of the queue off it.
+        // Inputs: bool urgentOnly: Only takes a file queued urgently.
+        // Outputs: False if there is none.
+        virtual bool takeNextFile(juce::File& file, bool urgentOnly) = 0;
+        /**Takes a file off the queue if it is waiting there*/
+        virtual bool takeFile(const juce::File& file) = 0;
+        /**Starts measuring a taken file, or returns nullptr and forgets it if its format can't be measured*/
+        virtual std::unique_ptr<Measurement> startMeasurement(const juce::File& file, const juce::AudioFormatReader& reader) = 0;
+        /**Forgets a taken file that couldn't be opened*/
+        virtual void skipFile(const juce::File& file) = 0;
+    };
+
+    // Constructor: Leaves one core for the audio and message threads
+    TrackAnalysisPool();
+    ~TrackAnalysisPool();
+
+    /**Starts serving an analysis's queue; message thread*/
+    void addAnalysis(Analysis& analysis);
+    /**Stops measuring for an analysis and forgets it; call before the analysis is deleted*/
+    void removeAnalysis(Analysis& analysis);
+    /**Makes sure a file just queued gets a thread; message thread, without the analysis's lock held*/
+    void fileQueued();
+
+    // Function: decode
+    // Purpose: Decodes a whole file from its start and feeds every block to each measurement,
+    //          on the calling thread. Does not call finish.
+    // Outputs: False if the file couldn't be read or shouldExit returned true.
+    static bool decode(juce::AudioFormatReader& reader, const std::vector<Measurement*>& measurements,
+                       const std::function<bool()>& shouldExit);
+
+private:
+    class AnalysisJob;
+
+    /**Takes the next file to analyze and every analysis that had it queued*/
+    bool takeNextFile(juce::File& file, std::vector<Analysis*>& claimed);
+
+    static constexpr int readLength = 65536;
+    static constexpr int maximumChannels = 8;
+
+    juce::ThreadPool pool;
+
+    // Shared with the pool's threads; held while a job takes a file from every queue, so no two
+    // jobs decode the same file for different analyses
+    juce::CriticalSection lock;
+    std::vector<Analysis*> analyses;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(TrackAnalysisPool)
+};
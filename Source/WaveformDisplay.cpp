@@ -16,23 +16,35 @@
 
 //==============================================================================
 WaveformDisplay::WaveformDisplay(int _id,
-                                 juce::AudioFormatManager& formatManager,
-                                 juce::AudioThumbnailCache& thumbCache
-                                ) : audioThumb(1000, formatManager, thumbCache),
-                                    fileLoaded(false),
+                                 juce::AudioFormatManager& _formatManager,
+                                 juce::AudioThumbnailCache& _thumbCache
+                                ) : fileLoaded(false),
                                     position(0),
-                                    id(_id)
+                                    id(_id),
+                                    formatManager(_formatManager),
+                                    thumbCache(_thumbCache)
 {
     // In your constructor, you should add any child components, and
     // initialise any special settings that your component needs.
     setLookAndFeel(&customLookAndFeel);
-    audioThumb.addChangeListener(this);
+    setThumbnail(std::make_shared<juce::AudioThumbnail>(1000, formatManager, thumbCache));
 }
-// Destructor which resets the look and feel
+// Destructor which resets the look and feel and stops listening to a thumbnail that may be shared
 WaveformDisplay::~WaveformDisplay()
 {
+    audioThumb->removeChangeListener(this);
     setLookAndFeel(nullptr);
 }
+
+// Swaps the thumbnail drawn and moves the change listener over to it (Personal code)
+void WaveformDisplay::setThumbnail(std::shared_ptr<juce::AudioThumbnail> thumbnail)
+{
+    if (audioThumb != nullptr)
+        audioThumb->removeChangeListener(this);
+
+    audioThumb = std::move(thumbnail);
+    audioThumb->addChangeListener(this);
+}
 // Personal code: This function sets the waveform data and marks the component to be repainted.
 void WaveformDisplay::setWaveformData(const std::vector<float>& data)
     {
@@ -59,18 +71,22 @@ void WaveformDisplay::paint(juce::Graphics& g)
     {
         // Existing drawing code
         g.setFont(15.0f);
-        audioThumb.drawChannel(g,
+        audioThumb->drawChannel(g,
             getLocalBounds(),
             0,
-            audioThumb.getTotalLength(),
+            audioThumb->getTotalLength(),
             0,
             1.0f
         );
+        drawBeatGrid(g);
         g.setColour(juce::Colours::lightgreen);
         g.drawRect(position * getWidth(), 0, getWidth() / 20, getHeight());
         g.setColour(juce::Colours::white);
         g.drawText(fileName, getLocalBounds(),
             juce::Justification::bottomLeft, true);
+        g.setColour(juce::Colours::orange);
+        g.drawText(statusText, getLocalBounds(),
+            juce::Justification::topRight, true);
 
         // Drawing the waveform data from waveformData vector using CustomLookAndFeel
         if (!waveformData.empty())
@@ -105,8 +121,10 @@ void WaveformDisplay::changeListenerCallback(juce::ChangeBroadcaster* source)
 void WaveformDisplay::loadURL(juce::URL audioURL)
 {
     DBG("WaveformDisplay::loadURL called");
-    audioThumb.clear();
-    fileLoaded = audioThumb.setSource(new juce::URLInputSource(audioURL));
+    // A new thumbnail, so a display sharing the old one keeps it
+    setThumbnail(std::make_shared<juce::AudioThumbnail>(1000, formatManager, thumbCache));
+    fileLoaded = audioThumb->setSource(new juce::URLInputSource(audioURL));
+    beatsPerMinute = 0.0;
     if (fileLoaded)
     {
         DBG("WaveformDisplay::loadURL file loaded");
@@ -118,6 +136,79 @@ void WaveformDisplay::loadURL(juce::URL audioURL)
         DBG("WaveformDisplay::loadURL file NOT loaded");
     }
 }
+// Method to show a stream without a thumbnail: AudioThumbnail opens its source on the message thread (Personal code)
+void WaveformDisplay::showStream(const juce::String& name)
+{
+    setThumbnail(std::make_shared<juce::AudioThumbnail>(1000, formatManager, thumbCache));
+    fileLoaded = true;
+    fileName = name;
+    waveformData.clear();
+    beatsPerMinute = 0.0;
+    repaint();
+}
+// Method to set the line of state drawn over the waveform (Personal code)
+void WaveformDisplay::setStatusText(const juce::String& text)
+{
+    if (text != statusText)
+    {
+        statusText = text;
+        repaint();
+    }
+}
+// Method to draw another display's thumbnail, still being built or not, without reading the file (Personal code)
+void WaveformDisplay::shareWaveform(const WaveformDisplay& other)
+{
+    setThumbnail(other.audioThumb);
+    fileLoaded = other.fileLoaded;
+    fileName = other.fileName;
+    waveformData = other.waveformData;
+    position = other.position;
+    beatsPerMinute = other.beatsPerMinute;
+    firstDownbeat = other.firstDownbeat;
+    beatsPerBar = other.beatsPerBar;
+    repaint();
+}
+// Method to set the beat grid found by the beat analysis (Personal code)
+void WaveformDisplay::setBeatGrid(double bpm, double firstDownbeatSeconds, int beatsPerBarToUse)
+{
+    if (bpm != beatsPerMinute || firstDownbeatSeconds != firstDownbeat || beatsPerBarToUse != beatsPerBar)
+    {
+        beatsPerMinute = bpm;
+        firstDownbeat = firstDownbeatSeconds;
+        beatsPerBar = juce::jmax(1, beatsPerBarToUse);
+        repaint();
+    }
+}
+// Method to draw a line on every beat, or only on downbeats when beats would crowd the display (Personal code)
+void WaveformDisplay::drawBeatGrid(juce::Graphics& g)
+{
+    const double length = audioThumb->getTotalLength();
+
+    if (beatsPerMinute <= 0.0 || length <= 0.0)
+        return;
+
+    const double beatSeconds = 60.0 / beatsPerMinute;
+    const double pixelsPerBeat = getWidth() * beatSeconds / length;
+    const int stride = pixelsPerBeat >= minimumMarkerSpacing ? 1 : beatsPerBar;
+
+    if (pixelsPerBeat * stride < minimumMarkerSpacing)
+        return;
+
+    // The grid reaches back from the first downbeat to the start of the track in whole bars
+    const int firstBeat = stride * -(int) std::floor(firstDownbeat / (beatSeconds * stride));
+
+    for (int beat = firstBeat; ; beat += stride)
+    {
+        const double seconds = firstDownbeat + beat * beatSeconds;
+
+        if (seconds > length)
+            break;
+
+        const bool isDownbeat = (beat % beatsPerBar + beatsPerBar) % beatsPerBar == 0;
+        g.setColour(isDownbeat ? juce::Colours::yellow.withAlpha(0.8f) : juce::Colours::white.withAlpha(0.3f));
+        g.drawVerticalLine(juce::roundToInt(seconds / length * getWidth()), 0.0f, (float) getHeight());
+    }
+}
 // Method to set the relative position of a marker on the waveform (Personal code)
 void WaveformDisplay::setPositionRelative(double pos)
 {
@@ -11,6 +11,7 @@
 #pragma once
 
 #include <JuceHeader.h>
+#include <memory>
 
 
 #include "CustomLookAndFeel.h"
@@ -31,8 +32,18 @@ public:
     void resized() override;
     void changeListenerCallback(juce::ChangeBroadcaster* source) override;
     void loadURL(juce::URL audioURL);
+    /**Shows a remote stream by name; it has no thumbnail, since drawing one would read it all*/
+    void showStream(const juce::String& name);
+    /**Shows a line of state, such as a stream's buffering, in the top right corner; empty hides it*/
+    void setStatusText(const juce::String& text);
+    /**Shows the same thumbnail as another display, by reference; no file is read*/
+    void shareWaveform(const WaveformDisplay& other);
     /**set the relative position of the playhead*/
     void setPositionRelative(double pos);
+    // Function: setBeatGrid
+    // Purpose: Draws beat markers from the first downbeat on, downbeats brighter; a bpm of 0
+    //          removes them.
+    void setBeatGrid(double bpm, double firstDownbeatSeconds, int beatsPerBarToUse);
 
     // Adding new members to handle mouse interaction and setting playback position
     void mouseDown(const juce::MouseEvent& event) override;
@@ -43,11 +54,26 @@ public:
     std::function<void(double)> onPositionChanged;
 
 private:
+    /**Draws a thumbnail from now on and repaints when it changes*/
+    void setThumbnail(std::shared_ptr<juce::AudioThumbnail> thumbnail);
+    /**Draws the beat markers over the thumbnail's length*/
+    void drawBeatGrid(juce::Graphics& g);
+
+    // Markers closer than this many pixels are left out: beats first, then downbeats
+    static constexpr double minimumMarkerSpacing = 4.0;
+
     int id;
     bool fileLoaded;
     double position;
     juce::String fileName;
-    juce::AudioThumbnail audioThumb;
+    juce::String statusText;
+    double beatsPerMinute = 0.0;
+    double firstDownbeat = 0.0;
+    int beatsPerBar = 4;
+    juce::AudioFormatManager& formatManager;
+    juce::AudioThumbnailCache& thumbCache;
+    // Shared with the other deck's display after a clone; each load creates a new one
+    std::shared_ptr<juce::AudioThumbnail> audioThumb;
     int dataSize = 0;
     std::vector<float> waveformData;
     CustomLookAndFeel customLookAndFeel;